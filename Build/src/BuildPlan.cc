@@ -15,6 +15,7 @@
 #include <cc/build/TestRunStage>
 #include <cc/build/InstallStage>
 #include <cc/build/UninstallStage>
+#include <cc/build/WatchStage>
 #include <cc/build/SystemPrerequisite>
 #include <cc/build/Predicate>
 #include <cc/build/Unit>
@@ -52,6 +53,7 @@ struct BuildPlan::State:
     public TestRunStage,
     public InstallStage,
     public UninstallStage,
+    public WatchStage,
     public BuildShell
 {
     State(int argc, char *argv[]):
@@ -148,6 +150,8 @@ struct BuildPlan::State:
         if (recipe_("test-run"))    options_ |= BuildOption::BuildTests;
         if (recipe_("test-report")) options_ |= BuildOption::BuildTests;
         if (recipe_("verbose"))     options_ |= BuildOption::Verbose;
+        if (recipe_("report"))      options_ |= BuildOption::Report;
+        if (recipe_("cache"))       options_ |= BuildOption::Cache;
         if (recipe_("configure"))   options_ |= BuildOption::Configure;
         if (recipe_("insight"))     options_ |= BuildOption::Insight;
         if (recipe_("strip"))       options_ |= BuildOption::Strip;
@@ -772,6 +776,10 @@ int BuildPlan::run()
         return !uninstallStage().run();
     }
 
+    if (recipe("watch").to<bool>()) {
+        return watchStage().run() ? 0 : 1;
+    }
+
     if (!compileLinkStage().run()) {
         return 1;
     }
@@ -1085,6 +1093,11 @@ String BuildPlan::previousLinkCommandPath() const
     return objectFilePath(".command-link");
 }
 
+String BuildPlan::buildStatePath() const
+{
+    return objectFilePath(".build-state");
+}
+
 void BuildPlan::setLibraryLinkJob(const Job &linkJob)
 {
     me().libraryLinkJob_ = linkJob;
@@ -1185,6 +1198,11 @@ UninstallStage &BuildPlan::uninstallStage()
     return me();
 }
 
+WatchStage &BuildPlan::watchStage()
+{
+    return me();
+}
+
 Job BuildPlan::libraryLinkJob() const
 {
     return me().libraryLinkJob_;
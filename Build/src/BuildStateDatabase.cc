@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/BuildStateDatabase>
+#include <cc/LineSource>
+#include <cc/File>
+#include <cc/Format>
+#include <cc/Map>
+#include <cmath>
+
+namespace cc::build {
+
+struct BuildStateDatabase::Entry
+{
+    long lastModified { 0 };
+    List<String> includes;
+    bool inUse { false };
+};
+
+struct BuildStateDatabase::State final: public Object::State
+{
+    /** Each line holds the path of an object file, its modification time in nanoseconds
+      * and its dependencies, all separated by tabs.
+      */
+    explicit State(const String &path):
+        path_{path}
+    {
+        text_ = File::load(path_);
+        for (const String &line: LineSource{text_}) {
+            List<String> parts = line.split('\t');
+            if (parts.count() < 2) continue;
+            String target = parts.first();
+            parts.popFront();
+            bool ok = false;
+            long lastModified = parts.first().toLong(&ok);
+            if (!ok) continue;
+            parts.popFront();
+            entries_.insert(target, Entry{lastModified, parts});
+        }
+    }
+
+    static long timeKey(double lastModified)
+    {
+        return static_cast<long>(std::llround(lastModified * 1e9));
+    }
+
+    bool lookup(const String &target, double lastModified, Out<List<String>> includes) const
+    {
+        Locator pos;
+        if (!entries_.find(target, &pos)) return false;
+        const Entry &entry = entries_.at(pos).value();
+        if (entry.lastModified != timeKey(lastModified)) return false;
+        includes = entry.includes;
+        return true;
+    }
+
+    void insert(const String &target, double lastModified, const List<String> &includes)
+    {
+        entries_(target) = Entry{timeKey(lastModified), includes, true};
+    }
+
+    void sync()
+    {
+        Format f;
+        for (const auto &pair: entries_) {
+            const Entry &entry = pair.value();
+            if (!entry.inUse) continue;
+            f << pair.key() << "\t" << entry.lastModified;
+            for (const String &include: entry.includes) f << "\t" << include;
+            f << "\n";
+        }
+
+        String newText = f.join<String>();
+        if (newText != text_) {
+            File::save(path_, newText);
+            text_ = newText;
+        }
+    }
+
+    String path_;
+    String text_;
+    Map<String, Entry> entries_;
+};
+
+BuildStateDatabase::BuildStateDatabase(const String &path):
+    Object{new State{path}}
+{}
+
+bool BuildStateDatabase::lookup(const String &target, double lastModified, Out<List<String>> includes) const
+{
+    return me().lookup(target, lastModified, &includes);
+}
+
+void BuildStateDatabase::insert(const String &target, double lastModified, const List<String> &includes)
+{
+    me().insert(target, lastModified, includes);
+}
+
+void BuildStateDatabase::sync()
+{
+    me().sync();
+}
+
+String BuildStateDatabase::path() const
+{
+    return me().path_;
+}
+
+const BuildStateDatabase::State &BuildStateDatabase::me() const
+{
+    return Object::me.as<State>();
+}
+
+BuildStateDatabase::State &BuildStateDatabase::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::build
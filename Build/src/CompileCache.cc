@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/CompileCache>
+#include <cc/build/ToolChain>
+#include <cc/Sha256HashSink>
+#include <cc/DirWalk>
+#include <cc/FileInfo>
+#include <cc/File>
+#include <cc/Format>
+#include <cc/Process>
+#include <cc/System>
+#include <cc/MultiMap>
+#include <cc/Map>
+#include <cc/str>
+
+namespace cc::build {
+
+struct CompileCache::State final: public Object::State
+{
+    struct Pending {
+        ToolChain toolChain;
+        Unit unit;
+        String sourceKey;
+    };
+
+    struct Digest {
+        double lastModified;
+        long long size;
+        Bytes hash;
+    };
+
+    void open(const String &path, long long maxSize)
+    {
+        path_ = path;
+        maxSize_ = maxSize;
+    }
+
+    bool restore(const ToolChain &toolChain, const Unit &unit, const String &command)
+    {
+        try {
+            const String sourceKey = hashSource(toolChain.compiler(unit.source()), command.replaced(unit.target(), "%.o"), unit.source());
+            const String manifestPath = entryPath(sourceKey, ".deps");
+            if (File::exists(manifestPath)) {
+                List<String> dependencies = File{manifestPath}.map().split('\n');
+                const String objectPath = entryPath(hashDependencies(sourceKey, dependencies), ".o");
+                if (File::exists(objectPath)) {
+                    File{unit.target(), FileOpen::Overwrite}.write(File{objectPath}.map());
+                    toolChain.writeMakeDeps(unit.target(), dependencies);
+                    const double now = System::now();
+                    File::setTimes(objectPath, now, now);
+                    ++hitCount_;
+                    return true;
+                }
+            }
+            pending_.establish(command, Pending{toolChain, unit, sourceKey});
+        }
+        catch (SystemError &)
+        {}
+
+        ++missCount_;
+        return false;
+    }
+
+    void store(const Job &job)
+    {
+        Locator pos;
+        if (!pending_.find(job.command(), &pos)) return;
+        Pending pending = pending_.at(pos).value();
+        pending_.removeAt(pos);
+
+        try {
+            const String target = pending.unit.target();
+            List<String> dependencies = pending.toolChain.readAllMakeDeps(target);
+            if (dependencies.count() == 0) return;
+            save(entryPath(pending.sourceKey, ".deps"), dependencies.join('\n'));
+            save(entryPath(hashDependencies(pending.sourceKey, dependencies), ".o"), File{target}.map());
+            ++storeCount_;
+        }
+        catch (SystemError &)
+        {}
+    }
+
+    void trim()
+    {
+        if (path_ == "" || !File::exists(path_)) return;
+
+        struct Entry {
+            String path;
+            long long size;
+        };
+
+        MultiMap<long, Entry> objects;
+        long long totalSize = 0;
+        for (const String &path: DirWalk{path_, DirWalk::FilesOnly}) {
+            if (!path.endsWith(".o")) continue;
+            FileInfo info { path };
+            objects.insert(static_cast<long>(info.lastModified() * 1e3), Entry{path, info.size()});
+            totalSize += info.size();
+        }
+        cacheSize_ = totalSize;
+
+        for (const auto &pair: objects) {
+            if (cacheSize_ <= maxSize_) break;
+            try {
+                File::unlink(pair.value().path);
+                cacheSize_ -= pair.value().size;
+                ++evictCount_;
+            }
+            catch (SystemError &)
+            {}
+        }
+    }
+
+    String statistics() const
+    {
+        const long lookupCount = hitCount_ + missCount_;
+        Format f{"Compile cache: %% hits, %% misses (%% hit rate), %% stored, %% evicted, %% MB in %%"};
+        f
+            << hitCount_
+            << missCount_
+            << str(lookupCount > 0 ? 100 * hitCount_ / lookupCount : 0) + "%"
+            << storeCount_
+            << evictCount_
+            << cacheSize_ / 1000000
+            << path_;
+        return f.join<String>();
+    }
+
+    String entryPath(const String &key, const String &suffix) const
+    {
+        return path_ / key.copy(0, 2) / key.copy(2, key.count()) + suffix;
+    }
+
+    /** \param compiler Name of the compiler executable
+      * \param command Compile command with the object file path masked out (so that build directories can share the cache)
+      * \param source Path of the source file
+      */
+    String hashSource(const String &compiler, const String &command, const String &source)
+    {
+        Sha256HashSink sink;
+        sink.write(compilerIdentity(compiler));
+        sink.write(command);
+        if (command.contains(" -g")) sink.write(Process::cwd());
+        sink.write(String{"\n"});
+        sink.write(File{source}.map());
+        return hex(sink.finish(), 'a');
+    }
+
+    /** Identify the compiler binary by its path, size and modification time (updating the compiler invalidates the cache)
+      */
+    String compilerIdentity(const String &compiler)
+    {
+        Locator pos;
+        if (compilerIdentities_.find(compiler, &pos)) return compilerIdentities_.at(pos).value();
+
+        String path = compiler;
+        if (!path.contains('/')) path = File::locate(compiler, Process::env("PATH").split(':'), FileAccess::Execute);
+        String identity = compiler;
+        if (path != "") {
+            FileInfo info { path };
+            identity = Format{"%%:%%:%%\n"} << path << info.size() << fixed(info.lastModified(), 6);
+        }
+        compilerIdentities_.insert(compiler, identity);
+        return identity;
+    }
+
+    /** Hash the contents of all \a dependencies (including headers outside of the source tree)
+      */
+    String hashDependencies(const String &sourceKey, const List<String> &dependencies)
+    {
+        Sha256HashSink sink;
+        sink.write(sourceKey);
+        for (const String &dependency: dependencies) {
+            sink.write(dependency + "\n");
+            sink.write(hashFile(dependency));
+        }
+        return hex(sink.finish(), 'a');
+    }
+
+    /** Hash the contents of file \a path (reusing the hash of a previous call if the file did not change since then)
+      */
+    Bytes hashFile(const String &path)
+    {
+        FileInfo info { path };
+        if (!info) return Bytes{};
+
+        Locator pos;
+        if (fileDigests_.find(path, &pos)) {
+            const Digest &digest = fileDigests_.at(pos).value();
+            if (digest.lastModified == info.lastModified() && digest.size == info.size()) return digest.hash;
+            fileDigests_.removeAt(pos);
+        }
+
+        Sha256HashSink sink;
+        sink.write(File{path}.map());
+        Bytes hash = sink.finish();
+        fileDigests_.insert(path, Digest{info.lastModified(), info.size(), hash});
+        return hash;
+    }
+
+    static void save(const String &path, const String &data)
+    {
+        File::establish(path);
+        const String tempPath = path + ".tmp" + str(Process::currentId());
+        File{tempPath, FileOpen::Overwrite}.write(data);
+        File::rename(tempPath, path);
+    }
+
+    String path_;
+    long long maxSize_ { 0 };
+    Map<String, Pending> pending_;
+    Map<String, String> compilerIdentities_;
+    Map<String, Digest> fileDigests_;
+    long hitCount_ { 0 };
+    long missCount_ { 0 };
+    long storeCount_ { 0 };
+    long evictCount_ { 0 };
+    long long cacheSize_ { 0 };
+};
+
+CompileCache::CompileCache()
+{
+    initOnce<State>();
+}
+
+void CompileCache::open(const String &path, long long maxSize)
+{
+    me().open(path, maxSize);
+}
+
+bool CompileCache::isOpen() const
+{
+    return me().path_ != "";
+}
+
+bool CompileCache::restore(const ToolChain &toolChain, const Unit &unit, const String &command)
+{
+    return me().restore(toolChain, unit, command);
+}
+
+void CompileCache::store(const Job &job)
+{
+    me().store(job);
+}
+
+void CompileCache::trim()
+{
+    me().trim();
+}
+
+String CompileCache::statistics() const
+{
+    return me().statistics();
+}
+
+const CompileCache::State &CompileCache::me() const
+{
+    return Object::me.as<State>();
+}
+
+CompileCache::State &CompileCache::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::build
@@ -8,13 +8,19 @@
 
 #include <cc/build/CompileLinkStage>
 #include <cc/build/JobScheduler>
+#include <cc/build/JobHistory>
 #include <cc/build/BuildStageGuard>
 #include <cc/build/BuildShell>
 #include <cc/build/ToolChain>
 #include <cc/build/InsightDatabase>
+#include <cc/build/BuildStateDatabase>
+#include <cc/build/FileStatusCache>
+#include <cc/build/CompileCache>
 #include <cc/build/CodyServer>
 #include <cc/build/ImportManager>
 #include <cc/File>
+#include <cc/Process>
+#include <cc/System>
 #include <cc/stdio>
 
 namespace cc::build {
@@ -33,17 +39,43 @@ bool CompileLinkStage::run()
         codyServer.start();
     }
 
+    if ((plan().options() & BuildOption::Cache) && !(plan().options() & BuildOption::Simulate) && !CompileCache{}.isOpen()) {
+        String cachePath = plan().recipe("cache-path").to<String>();
+        if (cachePath == "") cachePath = Process::env("HOME") / ".cache/ccbuild";
+        CompileCache{}.open(cachePath, plan().recipe("cache-size").to<long>() * 1000000LL);
+    }
+
     if (!scheduleJobs(scheduler)) return success_ = false;
 
+    JobHistory history;
+    if (scheduler.totalCount() > 0 && !(plan().options() & BuildOption::Simulate)) {
+        history = JobHistory{".job-history"};
+        scheduler.setHistory(history);
+    }
+
     for (Job job; scheduler.collect(&job);) {
         fout() << shell().beautify(job.command()) << nl;
         ferr() << job.outputText();
         if (job.status() != 0) {
             status_ = job.status();
-            return success_ = false;
+            break;
         }
+        if (CompileCache{}.isOpen()) CompileCache{}.store(job);
+    }
+
+    if (history) history.sync();
+
+    if (CompileCache{}.isOpen()) {
+        CompileCache{}.trim();
+        fout() << CompileCache{}.statistics() << nl;
     }
 
+    if (plan().options() & BuildOption::Report) {
+        fout() << scheduler.utilizationReport();
+    }
+
+    if (status_ != 0) return success_ = false;
+
     if (codyServer) {
         CodyError error;
         codyServer.shutdown(&error);
@@ -112,6 +144,19 @@ bool CompileLinkStage::scheduleJobs(JobScheduler &scheduler)
             }
             else {
                 job = toolChain().createCompileJob(plan(), unit);
+
+                if (
+                    CompileCache{}.isOpen() &&
+                    unit.type() == Unit::Type::Regular &&
+                    !(plan().options() & BuildOption::Cody) &&
+                    CompileCache{}.restore(toolChain(), unit, job.command())
+                ) {
+                    if (insightDatabase) {
+                        insightDatabase.insert(unit.source(), job.command(), unit.target());
+                    }
+                    continue;
+                }
+
                 job.registerDerivative(linkJob);
             }
 
@@ -217,6 +262,16 @@ bool CompileLinkStage::gatherUnits()
         ImportManager{};
     }
 
+    const double analysisStart = System::now();
+    const long missCountStart = FileStatusCache{}.missCount();
+    const long hitCountStart = FileStatusCache{}.hitCount();
+    long depsReadCount = 0;
+
+    BuildStateDatabase buildState;
+    if (!(plan().options() & (BuildOption::Simulate | BuildOption::Blindfold | BuildOption::Cody))) {
+        buildState = BuildStateDatabase{plan().buildStatePath()};
+    }
+
     for (const String &source: plan().sources())
     {
         const String target = toolChain().objectFilePath(plan(), source);
@@ -235,15 +290,20 @@ bool CompileLinkStage::gatherUnits()
                 includes.pushFront(source);
                 imports = File{targetBase + ".import"}.map().split('\n');
             }
-            else {
-                includes = toolChain().readMakeDeps(plan(), target);
-            }
 
             FileInfo targetInfo = shell().fileStatus(target);
             if (!targetInfo) throw true;
 
+            if (!(plan().options() & BuildOption::Cody)) {
+                if (!buildState || !buildState.lookup(target, targetInfo.lastModified(), &includes)) {
+                    includes = toolChain().readMakeDeps(plan(), target);
+                    ++depsReadCount;
+                }
+                if (buildState) buildState.insert(target, targetInfo.lastModified(), includes);
+            }
+
             for (const String &include: includes) {
-                FileInfo includeInfo = shell().fileStatus(include);
+                FileInfo includeInfo = FileStatusCache{}.fileStatus(include);
                 if (!includeInfo) throw true;
                 if (targetInfo.lastModified() < includeInfo.lastModified()) throw true;
             }
@@ -281,6 +341,18 @@ bool CompileLinkStage::gatherUnits()
         }
     }
 
+    if (buildState) buildState.sync();
+
+    if (plan().options() & BuildOption::Verbose) {
+        ferr(
+            "Analysed %% units of %% in %% ms (%% dependency files read, %% files queried, %% queries cached)\n"
+        ) << plan().units().count() << plan().name()
+        << static_cast<long>((System::now() - analysisStart) * 1e3)
+        << depsReadCount
+        << FileStatusCache{}.missCount() - missCountStart
+        << FileStatusCache{}.hitCount() - hitCountStart;
+    }
+
     return true;
 }
 
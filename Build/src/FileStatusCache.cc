@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/FileStatusCache>
+#include <cc/Map>
+
+namespace cc::build {
+
+struct FileStatusCache::State: public Object::State
+{
+    FileInfo fileStatus(const String &path)
+    {
+        Locator pos;
+        if (fileStatusByPath_.find(path, &pos)) {
+            ++hitCount_;
+            return fileStatusByPath_.at(pos).value();
+        }
+        ++missCount_;
+        FileInfo status { path, false };
+        fileStatusByPath_.insert(path, status);
+        return status;
+    }
+
+    void retain(const List<String> &dirPaths)
+    {
+        List<String> outsiders;
+        for (const auto &pair: fileStatusByPath_) {
+            const String &path = pair.key();
+            bool inside = false;
+            for (const String &dirPath: dirPaths) {
+                if (path.startsWith(dirPath + "/")) {
+                    inside = true;
+                    break;
+                }
+            }
+            if (!inside) outsiders.append(path);
+        }
+        for (const String &path: outsiders) {
+            fileStatusByPath_.remove(path);
+        }
+    }
+
+    Map<String, FileInfo> fileStatusByPath_;
+    long hitCount_ { 0 };
+    long missCount_ { 0 };
+};
+
+FileStatusCache::FileStatusCache()
+{
+    initOnce<State>();
+}
+
+FileInfo FileStatusCache::fileStatus(const String &path)
+{
+    return me().fileStatus(path);
+}
+
+void FileStatusCache::invalidate(const String &path)
+{
+    me().fileStatusByPath_.remove(path);
+}
+
+void FileStatusCache::clear()
+{
+    me().fileStatusByPath_.deplete();
+}
+
+void FileStatusCache::retain(const List<String> &dirPaths)
+{
+    me().retain(dirPaths);
+}
+
+long FileStatusCache::hitCount() const
+{
+    return me().hitCount_;
+}
+
+long FileStatusCache::missCount() const
+{
+    return me().missCount_;
+}
+
+const FileStatusCache::State &FileStatusCache::me() const
+{
+    return Object::me.as<State>();
+}
+
+FileStatusCache::State &FileStatusCache::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::build
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/FileWatch>
+#include <cc/IoStream>
+#include <cc/DirWalk>
+#include <cc/SystemError>
+#include <cc/Map>
+#include <sys/inotify.h>
+
+namespace cc::build {
+
+struct FileWatch::State final: public Object::State
+{
+    explicit State(const String &excludePath):
+        inotify_{CC_SYSCALL(::inotify_init1(IN_CLOEXEC))},
+        excludePath_{excludePath}
+    {}
+
+    void watchTree(const String &path)
+    {
+        if (isExcluded(path)) return;
+        watchDir(path);
+        for (const String &dirPath: DirWalk{path, DirWalk::DirsOnly}) {
+            if (isExcluded(dirPath) || isHidden(dirPath.copy(path.count(), dirPath.count()))) continue;
+            watchDir(dirPath);
+        }
+    }
+
+    void watchDir(const String &path)
+    {
+        const uint32_t mask = IN_CLOSE_WRITE|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_ONLYDIR;
+        int wd = ::inotify_add_watch(inotify_.fd(), path, mask);
+        if (wd == -1) {
+            if (errno == ENOENT || errno == ENOTDIR) return;
+            CC_SYSTEM_RESOURCE_ERROR(errno, path);
+        }
+        dirPathByWatch_.establish(wd, path);
+    }
+
+    List<Event> wait(int settleTime)
+    {
+        List<Event> events;
+        Bytes buffer = Bytes::allocate(0x10000);
+
+        for (int timeout = -1; inotify_.wait(IoEvent::ReadyRead, timeout); timeout = settleTime) {
+            long n = inotify_.read(&buffer);
+            for (long i = 0; i < n;) {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer.items() + i);
+                i += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    events.append(Event{String{}, FileChange::Overflow});
+                    continue;
+                }
+
+                if (event->mask & IN_IGNORED) {
+                    dirPathByWatch_.remove(event->wd);
+                    continue;
+                }
+
+                String dirPath;
+                if (event->len == 0 || !dirPathByWatch_.lookup(event->wd, &dirPath)) continue;
+
+                String name { event->name };
+                if (isHidden(name)) continue;
+
+                String path = dirPath / name;
+
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE|IN_MOVED_TO)) watchTree(path);
+                    continue;
+                }
+
+                FileChange change = FileChange::Modified;
+                if (event->mask & (IN_CREATE|IN_MOVED_TO)) change = FileChange::Created;
+                else if (event->mask & (IN_DELETE|IN_MOVED_FROM)) change = FileChange::Removed;
+
+                events.append(Event{path, change});
+            }
+        }
+
+        return events;
+    }
+
+    bool isExcluded(const String &path) const
+    {
+        return excludePath_ != "" && (path == excludePath_ || path.startsWith(excludePath_ + "/"));
+    }
+
+    static bool isHidden(const String &path)
+    {
+        for (const String &name: path.split('/')) {
+            if (name.startsWith('.') || name.endsWith('~')) return true;
+        }
+        return false;
+    }
+
+    IoStream inotify_;
+    String excludePath_;
+    Map<int, String> dirPathByWatch_;
+};
+
+FileWatch::FileWatch(const String &excludePath):
+    Object{new State{excludePath}}
+{}
+
+void FileWatch::watchTree(const String &path)
+{
+    me().watchTree(path);
+}
+
+long FileWatch::count() const
+{
+    return me().dirPathByWatch_.count();
+}
+
+List<FileWatch::Event> FileWatch::wait(int settleTime)
+{
+    return me().wait(settleTime);
+}
+
+const FileWatch::State &FileWatch::me() const
+{
+    return Object::me.as<State>();
+}
+
+FileWatch::State &FileWatch::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::build
@@ -180,10 +180,20 @@ struct GnuToolChain::State: public ToolChain::State
     }
 
     List<String> readMakeDeps(const BuildPlan &plan, const String &target) const override
+    {
+        List<String> includes;
+        for (const String &item: readAllMakeDeps(target)) {
+            if (!item.startsWith(plan.sourcePrefix())) continue;
+            includes.append(item);
+        }
+        return includes;
+    }
+
+    List<String> readAllMakeDeps(const String &target) const override
     {
         const String dependenciesFilePath = getDependenciesFilePath(target);
         String text = File{dependenciesFilePath}.map().replaced("\\\n", "");
-        List<String> includes;
+        List<String> dependencies;
         for (const String &line: LineSource{text}) {
             List<String> parts = line.split(':');
             if (parts.count() != 2) continue;
@@ -195,13 +205,17 @@ struct GnuToolChain::State: public ToolChain::State
                 for (const String &item: list) {
                     if (item.endsWith(".gcm")) continue;
                     if (item.contains("gcm.cache/")) continue;
-                    if (!item.startsWith(plan.sourcePrefix())) continue;
-                    includes.append(item);
+                    dependencies.append(item);
                 }
             }
         }
 
-        return includes;
+        return dependencies;
+    }
+
+    void writeMakeDeps(const String &target, const List<String> &dependencies) const override
+    {
+        File::save(getDependenciesFilePath(target), target + ": " + dependencies.join(' ') + "\n");
     }
 
     String headerUnitCompileCommand(const BuildPlan &plan, const String &source) const override
@@ -237,6 +251,7 @@ struct GnuToolChain::State: public ToolChain::State
         args << compiler(source);
         args << "-c" << "-o" << target;
         if (plan.options() & BuildOption::Cody) appendCxxModuleMapperOption(args, target);
+        else if (plan.options() & BuildOption::Cache) args << "-MD"; // the compile cache needs to see system headers, too
         else args << "-MMD";
         appendCompileOptions(args, plan);
         args << source;
@@ -7,6 +7,7 @@
  */
 
 #include <cc/build/JobState>
+#include <cc/System>
 
 namespace cc::build {
 
@@ -68,7 +69,10 @@ void Job::setReported(bool on)
 
 bool Job::run()
 {
-    return me().run();
+    me().startTime_ = System::now();
+    bool ok = me().run();
+    me().finishTime_ = System::now();
+    return ok;
 }
 
 void Job::wait()
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/JobHistory>
+#include <cc/LineSource>
+#include <cc/File>
+#include <cc/Format>
+#include <cc/Map>
+#include <cc/Set>
+
+namespace cc::build {
+
+struct JobHistory::State final: public Object::State
+{
+    /** Each line holds the duration of a command in milliseconds and the command itself separated by a tab.
+      * The lines are ordered by recency of use, most recently used commands first.
+      */
+    State(const String &path, long capacity):
+        path_{path},
+        capacity_{capacity}
+    {
+        text_ = File::load(path_);
+        for (const String &line: LineSource{text_}) {
+            long i = 0;
+            if (!line.find('\t', &i)) continue;
+            bool ok = false;
+            long duration = line.copy(0, i).toLong(&ok);
+            if (!ok) continue;
+            String command = line.copy(i + 1, line.count());
+            if (durations_.insert(command, duration)) order_.append(command);
+        }
+    }
+
+    void touch(const String &command) const
+    {
+        if (seen_.insert(command)) recent_.append(command);
+    }
+
+    bool lookup(const String &command, Out<double> duration) const
+    {
+        touch(command);
+        long milliseconds = 0;
+        if (!durations_.lookup(command, &milliseconds)) return false;
+        duration = milliseconds / 1e3;
+        return true;
+    }
+
+    void insert(const String &command, double duration)
+    {
+        touch(command);
+        durations_.establish(command, static_cast<long>(duration * 1e3));
+    }
+
+    double averageDuration() const
+    {
+        if (durations_.count() == 0) return 1;
+        double sum = 0;
+        for (const auto &pair: durations_) sum += pair.value();
+        return sum / durations_.count() / 1e3;
+    }
+
+    void sync()
+    {
+        Format f;
+        long count = 0;
+        auto write = [&](const String &command) {
+            long milliseconds = 0;
+            if (count < capacity_ && durations_.lookup(command, &milliseconds)) {
+                f << milliseconds << "\t" << command << "\n";
+                ++count;
+            }
+        };
+        for (const String &command: recent_) write(command);
+        for (const String &command: order_) {
+            if (!seen_.contains(command)) write(command);
+        }
+
+        String newText = f.join<String>();
+        if (newText != text_) {
+            File::save(path_, newText);
+            text_ = newText;
+        }
+    }
+
+    String path_;
+    long capacity_ { 0 };
+    String text_;
+    Map<String, long> durations_;
+    List<String> order_;
+    mutable Set<String> seen_;
+    mutable List<String> recent_;
+};
+
+JobHistory::JobHistory(const String &path, long capacity):
+    Object{new State{path, capacity}}
+{}
+
+bool JobHistory::lookup(const String &command, Out<double> duration) const
+{
+    return me().lookup(command, &duration);
+}
+
+void JobHistory::insert(const String &command, double duration)
+{
+    me().insert(command, duration);
+}
+
+double JobHistory::averageDuration() const
+{
+    return me().averageDuration();
+}
+
+long JobHistory::capacity() const
+{
+    return me().capacity_;
+}
+
+void JobHistory::sync()
+{
+    me().sync();
+}
+
+const JobHistory::State &JobHistory::me() const
+{
+    return Object::me.as<State>();
+}
+
+JobHistory::State &JobHistory::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::build
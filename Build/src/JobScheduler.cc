@@ -12,6 +12,8 @@
 #include <cc/build/JobState>
 #include <cc/System>
 #include <cc/Channel>
+#include <cc/PriorityChannel>
+#include <cc/Format>
 #include <cc/Set>
 
 namespace cc::build {
@@ -27,6 +29,11 @@ struct JobScheduler::State final: public Object::State
         if (started_) return;
         started_ = true;
 
+        if (history_) defaultDuration_ = history_.averageDuration();
+
+        for (const Job &job: ready_) dispatch(job);
+        ready_.deplete();
+
         for (int i = 0; i < concurrency_; ++i) {
             serverPool_.insert(JobServer{requestChannel_, replyChannel_});
         }
@@ -34,14 +41,38 @@ struct JobScheduler::State final: public Object::State
 
     void schedule(const Job &job)
     {
-        if (job.countDown() == 0)
-            requestChannel_.pushBack(job);
-        else
+        if (job.countDown() == 0) {
+            if (started_) dispatch(job);
+            else ready_.append(job);
+        }
+        else {
             derivatives_.insert(job);
+        }
 
         ++totalCount_;
     }
 
+    void dispatch(Job job)
+    {
+        requestChannel_.pushBack(job, -criticalPath(job));
+    }
+
+    long criticalPath(Job &job)
+    {
+        Job::State &state = job.me();
+        if (state.criticalPath_ < 0) {
+            double duration = defaultDuration_;
+            if (history_) history_.lookup(state.command_, &duration);
+            long longest = 0;
+            for (Job derivative: state.derivatives_) {
+                long path = criticalPath(derivative);
+                if (longest < path) longest = path;
+            }
+            state.criticalPath_ = static_cast<long>(duration * 1e3) + longest;
+        }
+        return state.criticalPath_;
+    }
+
     bool collect(Out<Job> job)
     {
         if (totalCount_ == 0) {
@@ -59,10 +90,18 @@ struct JobScheduler::State final: public Object::State
 
         if (!replyChannel_.popFront(&job)) return false;
 
+        const Job::State &state = job->me();
+        if (state.startTime_ > 0) {
+            finished_.append(*job);
+            if (history_ && state.status_ == 0) {
+                history_.insert(state.command_, state.finishTime_ - state.startTime_);
+            }
+        }
+
         if (job->status() == 0) {
             for (Job derivative; job->getNextDerivative(&derivative);) {
                 if (derivative.countDown() == 0) {
-                    requestChannel_.pushBack(derivative);
+                    dispatch(derivative);
                     derivatives_.remove(derivative);
                 }
             }
@@ -77,13 +116,61 @@ struct JobScheduler::State final: public Object::State
         return true;
     }
 
+    String utilizationReport() const
+    {
+        if (finished_.count() == 0) return String{};
+
+        double t0 = finished_.first().me().startTime_;
+        double t1 = t0;
+        double busyTime = 0;
+        for (const Job &job: finished_) {
+            const Job::State &state = job.me();
+            if (state.startTime_ < t0) t0 = state.startTime_;
+            if (t1 < state.finishTime_) t1 = state.finishTime_;
+            busyTime += state.finishTime_ - state.startTime_;
+        }
+
+        const int rowCount = 20;
+        const int barWidth = 40;
+        const double dt = (t1 - t0) / rowCount;
+
+        Format f;
+        f << "Build timeline: " << finished_.count() << " jobs in " << fixed(t1 - t0, 1) << " s on " << concurrency_ << " cores, "
+          << static_cast<int>(100 * busyTime / ((t1 - t0) * concurrency_ + 1e-9)) << "% utilization" << nl;
+
+        for (int row = 0; row < rowCount; ++row) {
+            const double r0 = t0 + row * dt;
+            const double r1 = r0 + dt;
+            double busy = 0;
+            for (const Job &job: finished_) {
+                const Job::State &state = job.me();
+                const double s0 = state.startTime_ < r0 ? r0 : state.startTime_;
+                const double s1 = state.finishTime_ < r1 ? state.finishTime_ : r1;
+                if (s0 < s1) busy += s1 - s0;
+            }
+            const double cores = dt > 0 ? busy / dt : 0;
+            int n = static_cast<int>(barWidth * cores / concurrency_ + 0.5);
+            if (n > barWidth) n = barWidth;
+            f << fixed(r0 - t0, 1).alignedRight(7) << " s |"
+              << String::allocate(n, '#') << String::allocate(barWidth - n, ' ')
+              << "| " << fixed(cores, 1) << nl;
+        }
+
+        return f.join<String>();
+    }
+
     int concurrency_ { -1 };
 
-    Channel<Job> requestChannel_;
+    PriorityChannel<Job, long> requestChannel_;
     Channel<Job> replyChannel_;
 
     Set<JobServer> serverPool_;
     Set<Job> derivatives_;
+    List<Job> ready_;
+    List<Job> finished_;
+
+    JobHistory history_;
+    double defaultDuration_ { 1 };
 
     bool started_ { false };
     int status_ { 0 };
@@ -100,6 +187,11 @@ int JobScheduler::concurrency() const
     return me().concurrency_;
 }
 
+void JobScheduler::setHistory(const JobHistory &history)
+{
+    me().history_ = history;
+}
+
 void JobScheduler::start()
 {
     me().start();
@@ -136,6 +228,11 @@ int JobScheduler::finishCount() const
     return me().finishCount_;
 }
 
+String JobScheduler::utilizationReport() const
+{
+    return me().utilizationReport();
+}
+
 const JobScheduler::State &JobScheduler::me() const
 {
     return Object::me.as<State>();
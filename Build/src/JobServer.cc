@@ -13,7 +13,7 @@ namespace cc::build {
 
 struct JobServer::State: public Object::State
 {
-    State(const Channel<Job> &requestChannel, const Channel<Job> &replyChannel):
+    State(const PriorityChannel<Job, long> &requestChannel, const Channel<Job> &replyChannel):
         requestChannel_{requestChannel},
         replyChannel_{replyChannel},
         thread_{[&]{ run(); }}
@@ -35,12 +35,12 @@ struct JobServer::State: public Object::State
         }
     }
 
-    Channel<Job> requestChannel_;
+    PriorityChannel<Job, long> requestChannel_;
     Channel<Job> replyChannel_;
     Thread thread_;
 };
 
-JobServer::JobServer(const Channel<Job> &requestChannel, const Channel<Job> &replyChannel):
+JobServer::JobServer(const PriorityChannel<Job, long> &requestChannel, const Channel<Job> &replyChannel):
     Object{new State{requestChannel, replyChannel}}
 {}
 
@@ -124,11 +124,17 @@ protected:
         insert("test-run", false);
         insert("test-report", false);
         insert("test-args", "");
+        insert("watch", false);
 
         insert("verbose", false);
+        insert("report", false);
         insert("jobs", -1);
         insert("test-run-jobs", -1);
 
+        insert("cache", false);
+        insert("cache-path", "");
+        insert("cache-size", 5000);
+
         insert("simulate", false);
         insert("blindfold", false);
         insert("bootstrap", false);
@@ -16,14 +16,14 @@
 
 namespace cc::build {
 
-bool TestRunStage::run()
+bool TestRunStage::run(double modifiedSince)
 {
     bool report = plan().testReport();
 
     if (report) Process::setEnv("TEST_REPORT", "1");
 
     JobScheduler scheduler = JobScheduler{plan().testRunConcurrency()};
-    scheduleJobs(scheduler);
+    scheduleJobs(scheduler, modifiedSince);
     int testFailed = 0;
 
     for (Job job; scheduler.collect(&job);) {
@@ -41,7 +41,7 @@ bool TestRunStage::run()
     return success_ = (testFailed == 0);
 }
 
-void TestRunStage::scheduleJobs(JobScheduler &scheduler)
+void TestRunStage::scheduleJobs(JobScheduler &scheduler, double modifiedSince)
 {
     if (complete_) return;
     complete_ = true;
@@ -51,22 +51,42 @@ void TestRunStage::scheduleJobs(JobScheduler &scheduler)
     if (outOfScope()) return;
 
     for (BuildPlan &prerequisite: plan().prerequisites())
-        prerequisite.testRunStage().scheduleJobs(scheduler);
+        prerequisite.testRunStage().scheduleJobs(scheduler, modifiedSince);
 
     if (!(plan().options() & BuildOption::Test)) return;
 
+    if (modifiedSince > 0 && librariesLinkedSince(plan(), modifiedSince)) {
+        modifiedSince = 0; // a library the tests are using has changed, so all of them need to run again
+    }
+
     if (plan().options() & BuildOption::Tools) {
         for (Unit &unit: plan().units()) {
+            if (modifiedSince > 0 && shell().fileStatus(toolChain().linkName(unit)).lastModified() < modifiedSince) continue;
             String command = "./" + toolChain().linkName(unit);
             if (plan().testArgs() != "") command += " " + plan().testArgs();
             scheduler.schedule(Job{command});
         }
     }
     else {
+        if (modifiedSince > 0 && shell().fileStatus(toolChain().linkName(plan())).lastModified() < modifiedSince) return;
         String command = toolChain().linkName(plan());
         if (plan().testArgs() != "") command += " " + plan().testArgs();
         scheduler.schedule(Job{command});
     }
 }
 
+bool TestRunStage::librariesLinkedSince(const BuildPlan &plan, double modifiedSince)
+{
+    for (const BuildPlan &prerequisite: plan.prerequisites()) {
+        if (
+            (prerequisite.options() & BuildOption::Library) &&
+            prerequisite.shell().fileStatus(prerequisite.toolChain().linkName(prerequisite)).lastModified() >= modifiedSince
+        ) {
+            return true;
+        }
+        if (librariesLinkedSince(prerequisite, modifiedSince)) return true;
+    }
+    return false;
+}
+
 } // namespace cc::build
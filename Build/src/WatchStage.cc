@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/build/WatchStage>
+#include <cc/build/FileWatch>
+#include <cc/build/FileStatusCache>
+#include <cc/build/GlobbingStage>
+#include <cc/build/CompileLinkStage>
+#include <cc/build/TestRunStage>
+#include <cc/build/Unit>
+#include <cc/build/Job>
+#include <cc/File>
+#include <cc/Array>
+#include <cc/SystemError>
+#include <cc/Process>
+#include <cc/System>
+#include <cc/stdio>
+#include <unistd.h>
+
+namespace cc::build {
+
+bool WatchStage::run()
+{
+    if (plan().options() & (BuildOption::Simulate | BuildOption::Blindfold | BuildOption::Bootstrap | BuildOption::Cody)) {
+        ferr() << "Watch mode cannot be combined with -simulate, -blindfold, -bootstrap or -cody" << nl;
+        return success_ = false;
+    }
+
+    List<BuildPlan> plans;
+    gatherPlans(plan(), &plans);
+
+    FileWatch watch { Process::cwd() };
+    List<String> watchedPaths;
+    for (const BuildPlan &plan: plans) {
+        if (plan.isSystemSource()) continue;
+        watch.watchTree(plan.projectPath());
+        watchedPaths.append(plan.projectPath());
+    }
+
+    build(0);
+
+    while (true)
+    {
+        fout("Watching %% directories for changes...\n") << watch.count();
+
+        List<FileWatch::Event> events = watch.wait();
+        const double cycleStart = System::now();
+
+        // files outside of the watched directories might have changed unnoticed
+        FileStatusCache{}.retain(watchedPaths);
+
+        for (const FileWatch::Event &event: events)
+        {
+            if (event.change == FileChange::Overflow) {
+                FileStatusCache{}.clear();
+                continue;
+            }
+
+            if (event.path.fileName() == "Recipe") restart();
+
+            FileStatusCache{}.invalidate(event.path);
+
+            if (event.change == FileChange::Modified && !(plan().options() & BuildOption::Lump)) continue;
+
+            BuildPlan owner;
+            for (const BuildPlan &candidate: plans) {
+                if (
+                    event.path.startsWith(candidate.projectPath() + "/") &&
+                    (!owner || owner.projectPath().count() < candidate.projectPath().count())
+                ) {
+                    owner = candidate;
+                }
+            }
+            if (owner && owner.globbingStage().complete()) {
+                owner.sources().deplete();
+                owner.globbingStage().reset();
+            }
+        }
+
+        for (BuildPlan &plan: plans) {
+            plan.compileLinkStage().reset();
+            plan.testRunStage().reset();
+            plan.units().deplete();
+            plan.setLibraryLinkJob(Job{});
+        }
+
+        bool ok = true;
+        for (BuildPlan &plan: plans) {
+            ok = ok && plan.globbingStage().run();
+        }
+
+        ok = ok && build(cycleStart);
+
+        fout("%% after %% ms\n")
+            << (ok ? "Build succeeded" : "Build failed")
+            << static_cast<long>((System::now() - cycleStart) * 1e3);
+    }
+
+    return success_ = true;
+}
+
+bool WatchStage::build(double modifiedSince)
+{
+    if (!plan().compileLinkStage().run()) return false;
+
+    bool testRun = plan().recipe("test-run").to<bool>();
+    bool testReport = plan().recipe("test-report").to<bool>();
+    if (testRun || testReport) {
+        if (testRun) Process::setEnv("TEST_RUN", "1");
+        return plan().testRunStage().run(modifiedSince);
+    }
+
+    return true;
+}
+
+void WatchStage::gatherPlans(const BuildPlan &plan, Out<List<BuildPlan>> plans) const
+{
+    for (const BuildPlan &other: *plans) {
+        if (other.projectPath() == plan.projectPath()) return;
+    }
+    plans->append(plan);
+    for (const BuildPlan &prerequisite: plan.prerequisites()) {
+        gatherPlans(prerequisite, plans);
+    }
+}
+
+void WatchStage::restart()
+{
+    fout() << "Recipe modified, restarting..." << nl;
+
+    Stream cmdline = File{"/proc/self/cmdline"}; // reports a size of zero, therefore read by Stream::readAll()
+    List<String> args = cmdline.readAll().split('\0');
+    if (args.count() > 0 && args.last() == "") args.popBack();
+
+    Array<char *> argv = Array<char *>::allocate(args.count() + 1);
+    long i = 0;
+    for (const String &arg: args) argv[i++] = const_cast<char *>(arg.chars());
+    argv[i] = nullptr;
+
+    ::execv(Process::execPath(), argv.items());
+    CC_SYSTEM_RESOURCE_ERROR(errno, Process::execPath());
+}
+
+} // namespace cc::build
@@ -0,0 +1,121 @@
+#include <cc/build/BuildStateDatabase>
+#include <cc/build/FileStatusCache>
+#include <cc/Dir>
+#include <cc/File>
+#include <cc/System>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+    using namespace cc::build;
+
+    TestCase {
+        "LookupAndSync",
+        []{
+            const String tempPath = Dir::createTemp();
+            const String databasePath = tempPath / ".build-state";
+            const String target = tempPath / "main.o";
+            const String other = tempPath / "other.o";
+            const List<String> includes { tempPath / "main.cc", tempPath / "answer.h" };
+
+            File::save(target, "");
+            File::setTimes(target, 1000, 1000.5);
+            List<String> result;
+
+            {
+                BuildStateDatabase database { databasePath };
+                CC_CHECK(database.path() == databasePath);
+                CC_CHECK(!database.lookup(target, FileInfo{target}.lastModified(), &result));
+                database.insert(target, FileInfo{target}.lastModified(), includes);
+                database.insert(other, 2000, List<String>{ tempPath / "other.cc" });
+                CC_VERIFY(database.lookup(target, FileInfo{target}.lastModified(), &result));
+                CC_CHECK(result == includes);
+                database.sync();
+            }
+
+            {
+                BuildStateDatabase database { databasePath };
+                CC_VERIFY(database.lookup(target, FileInfo{target}.lastModified(), &result));
+                CC_CHECK(result == includes);
+                CC_CHECK(database.lookup(other, 2000, &result));
+
+                // the object file has been rebuilt
+                File::setTimes(target, 1000, 1001.5);
+                CC_CHECK(!database.lookup(target, FileInfo{target}.lastModified(), &result));
+                CC_CHECK(database.lookup(target, 1000.5, &result));
+
+                database.insert(target, FileInfo{target}.lastModified(), includes);
+                database.sync();
+            }
+
+            {
+                // entries not inserted during the previous run are dropped
+                BuildStateDatabase database { databasePath };
+                CC_VERIFY(database.lookup(target, FileInfo{target}.lastModified(), &result));
+                CC_CHECK(result == includes);
+                CC_CHECK(!database.lookup(other, 2000, &result));
+            }
+
+            Dir::deplete(tempPath);
+            Dir::remove(tempPath);
+        }
+    };
+
+    TestCase {
+        "FileStatusCache",
+        []{
+            const String tempPath = Dir::createTemp();
+            const String header = tempPath / "answer.h";
+            const String outsider = tempPath / "outside/answer.h";
+            Dir::establish(tempPath / "watched");
+            Dir::establish(tempPath / "outside");
+            const String watched = tempPath / "watched/answer.h";
+
+            for (const String &path: List<String>{ header, outsider, watched }) {
+                File::save(path, "#define ANSWER 42\n");
+                File::setTimes(path, 1000, 1000);
+            }
+
+            FileStatusCache cache;
+            cache.clear();
+
+            const long missCount = cache.missCount();
+            const long hitCount = cache.hitCount();
+            CC_CHECK(cache.fileStatus(header).lastModified() == 1000);
+            CC_CHECK(cache.fileStatus(header).lastModified() == 1000);
+            CC_CHECK(cache.missCount() == missCount + 1);
+            CC_CHECK(cache.hitCount() == hitCount + 1);
+
+            // modifications are not noticed until the file is invalidated
+            File::setTimes(header, 1000, 2000);
+            CC_CHECK(cache.fileStatus(header).lastModified() == 1000);
+            cache.invalidate(header);
+            CC_CHECK(cache.fileStatus(header).lastModified() == 2000);
+
+            const String missing = tempPath / "missing.h";
+            CC_CHECK(!cache.fileStatus(missing));
+            File::save(missing, "");
+            CC_CHECK(!cache.fileStatus(missing));
+            cache.invalidate(missing);
+            CC_CHECK(!!cache.fileStatus(missing));
+
+            // only the status of files within the retained directories survives
+            CC_CHECK(cache.fileStatus(outsider).lastModified() == 1000);
+            CC_CHECK(cache.fileStatus(watched).lastModified() == 1000);
+            File::setTimes(outsider, 1000, 3000);
+            File::setTimes(watched, 1000, 3000);
+            cache.retain(List<String>{ tempPath / "watched" });
+            CC_CHECK(cache.fileStatus(outsider).lastModified() == 3000);
+            CC_CHECK(cache.fileStatus(watched).lastModified() == 1000);
+
+            cache.clear();
+            CC_CHECK(cache.fileStatus(watched).lastModified() == 3000);
+
+            Dir::deplete(tempPath);
+            Dir::remove(tempPath);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
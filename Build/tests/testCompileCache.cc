@@ -0,0 +1,67 @@
+#include <cc/build/CompileCache>
+#include <cc/build/GnuToolChain>
+#include <cc/Dir>
+#include <cc/File>
+#include <cc/Format>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+    using namespace cc::build;
+
+    TestCase {
+        "OutOfTreeHeaderChange",
+        []{
+            const String tempPath = Dir::createTemp();
+            const String sourceDir = tempPath / "project";
+            const String includeDir = tempPath / "imported/include";
+            Dir::establish(sourceDir);
+            Dir::establish(includeDir);
+
+            const String source = sourceDir / "main.cc";
+            const String target = sourceDir / "main.o";
+            const String header = includeDir / "answer.h";
+            File::save(source, "#include <answer.h>\nint main() { return ANSWER; }\n");
+            File::save(header, "#define ANSWER 42\n");
+
+            GnuToolChain toolChain { "", "" };
+            const Unit unit { Unit::Type::Regular, source, target };
+            const String command = Format{"%% -c -o %% -MD -I%% %%"} << toolChain.compiler(source) << target << includeDir << source;
+
+            CompileCache cache;
+            cache.open(tempPath / "cache", 1000000000);
+
+            auto compile = [&]{
+                Job job { command };
+                CC_VERIFY(job.run());
+                CC_VERIFY(job.status() == 0);
+                cache.store(job);
+            };
+
+            CC_VERIFY(!cache.restore(toolChain, unit, command));
+            compile();
+
+            const Bytes object = File{target}.readAll();
+            File::unlink(target);
+            CC_VERIFY(cache.restore(toolChain, unit, command));
+            CC_CHECK(Bytes{File{target}.map()} == object);
+
+            File::save(header, "#define ANSWER 7\n");
+            CC_VERIFY(!cache.restore(toolChain, unit, command));
+            compile();
+            CC_CHECK(Bytes{File{target}.map()} != object);
+
+            File::unlink(target);
+            CC_VERIFY(cache.restore(toolChain, unit, command));
+            CC_CHECK(Bytes{File{target}.map()} != object);
+
+            CC_INSPECT(cache.statistics());
+
+            Dir::deplete(tempPath);
+            Dir::remove(tempPath);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
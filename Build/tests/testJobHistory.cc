@@ -0,0 +1,91 @@
+#include <cc/build/JobScheduler>
+#include <cc/build/JobHistory>
+#include <cc/Dir>
+#include <cc/File>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+    using namespace cc::build;
+
+    TestCase {
+        "CriticalPathOrder",
+        []{
+            const String tempPath = Dir::createTemp();
+            const String historyPath = tempPath / ".job-history";
+
+            auto firstCommand = [&](const String &historyText) -> String {
+                File::save(historyPath, historyText);
+
+                Job shortJob { "echo short" };
+                Job longJob { "echo long" };
+                Job mediumJob { "echo medium" };
+                shortJob.registerDerivative(longJob);
+
+                JobScheduler scheduler { 1 };
+                scheduler.setHistory(JobHistory{historyPath});
+                scheduler.schedule(shortJob);
+                scheduler.schedule(longJob);
+                scheduler.schedule(mediumJob);
+
+                List<String> commands;
+                for (Job job; scheduler.collect(&job);) commands.append(job.command());
+                CC_INSPECT(commands.join(", "));
+                CC_CHECK(commands.count() == 3);
+                return commands.count() > 0 ? commands.first() : String{};
+            };
+
+            // the critical path of "echo short" includes the duration of "echo long"
+            CC_CHECK(firstCommand("100\techo short\n5000\techo long\n2000\techo medium\n") == "echo short");
+            CC_CHECK(firstCommand("100\techo short\n500\techo long\n2000\techo medium\n") == "echo medium");
+
+            Dir::deplete(tempPath);
+            Dir::remove(tempPath);
+        }
+    };
+
+    TestCase {
+        "Pruning",
+        []{
+            const String tempPath = Dir::createTemp();
+            const String historyPath = tempPath / ".job-history";
+            File::save(historyPath, "1000\tcc -c a.cc\n2000\tcc -c b.cc\n3000\tcc -c c.cc\n");
+
+            {
+                JobHistory history { historyPath, 3 };
+                CC_CHECK(history.capacity() == 3);
+                double duration = 0;
+                CC_VERIFY(history.lookup("cc -c c.cc", &duration));
+                CC_CHECK(duration == 3);
+                CC_CHECK(!history.lookup("cc -O2 -c c.cc", &duration));
+                history.insert("cc -O2 -c c.cc", 4);
+                history.sync();
+            }
+
+            // entries used in the current run come first, followed by the most recently used ones
+            CC_CHECK(File::load(historyPath) == "3000\tcc -c c.cc\n4000\tcc -O2 -c c.cc\n1000\tcc -c a.cc\n");
+
+            {
+                JobHistory history { historyPath, 3 };
+                history.insert("cc -O3 -c c.cc", 5);
+                history.sync();
+            }
+
+            CC_CHECK(File::load(historyPath) == "5000\tcc -O3 -c c.cc\n3000\tcc -c c.cc\n4000\tcc -O2 -c c.cc\n");
+
+            {
+                JobHistory history { historyPath };
+                double duration = 0;
+                CC_CHECK(history.lookup("cc -O2 -c c.cc", &duration));
+                CC_CHECK(duration == 4);
+                CC_CHECK(!history.lookup("cc -c a.cc", &duration));
+            }
+
+            Dir::deplete(tempPath);
+            Dir::remove(tempPath);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
@@ -31,6 +31,7 @@ int main(int argc, char *argv[])
             "  -release         release mode (NDEBUG defined)\n"
             "  -static          build static libraries\n"
             "  -verbose         verbose output\n"
+            "  -report          report the core utilization over the build\n"
             "  -optimize        optimization level / strategy (0, 1, 2, 3, 4, s, g)\n"
             "  -root            file system root for installation (default: \"/\")\n"
             "  -prefix          installation prefix (default: '/usr/local')\n"
@@ -48,10 +49,14 @@ int main(int argc, char *argv[])
             "  -test-run-jobs   number of concurrent jobs to spawn for running tests\n"
             "  -test-report     run all tests ($? = number of failed tests)\n"
             "  -test-args       list of arguments to pass to all tests\n"
+            "  -watch           rebuild (and rerun relinked tests) whenever a source file changes\n"
             "\n"
             "Misc. Options:\n"
             "  -compiler        select compiler\n"
             "  -jobs            number of concurrent jobs to spawn\n"
+            "  -cache           reuse object files from the local compile cache\n"
+            "  -cache-path      compile cache directory (default: '~/.cache/ccbuild')\n"
+            "  -cache-size      maximum size of the compile cache in MB (default: 5000)\n"
             "  -simulate        print build commands without executing them\n"
             "  -blindfold       do not see any existing files\n"
             "  -bootstrap       write bootstrap script\n"
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2023 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/CanCaptureMedia>
+#include <cc/CanCaptureFormat>
+#include <cc/File>
+#include <cc/Thread>
+#include <cc/System>
+#include <cstring>
+#include <cmath>
+
+namespace cc {
+
+struct CanCaptureMedia::State final: public CanMedia::State
+{
+    State(const String &path, double speed):
+        data_{File{path}.map()},
+        speed_{speed}
+    {
+        if (data_.count() < static_cast<long>(sizeof(CanCaptureHeader))) {
+            throw FormatError{data_, 0, "Not a CAN capture file (truncated header)"};
+        }
+
+        std::memcpy(&header_, data_.items(), sizeof(CanCaptureHeader));
+
+        if (header_.magic != CanCaptureHeader::Magic) {
+            throw FormatError{data_, 0, "Not a CAN capture file (expected magic \"CCANCAP1\")"};
+        }
+        if (header_.recordSize != sizeof(CanCaptureRecord)) {
+            throw FormatError{data_, 8, "Unsupported record size"};
+        }
+        if (header_.blockSize == 0) {
+            throw FormatError{data_, 12, "Invalid block size"};
+        }
+
+        records_ = reinterpret_cast<const CanCaptureRecord *>(data_.items() + sizeof(CanCaptureHeader));
+
+        long available = (data_.count() - sizeof(CanCaptureHeader)) / sizeof(CanCaptureRecord);
+        count_ = available;
+        if (header_.indexOffset != 0 && static_cast<long>(header_.recordCount) <= available) {
+            count_ = header_.recordCount;
+        }
+
+        loadIndex();
+    }
+
+    /** Load the block index (or reconstruct it if the capture file has not been closed properly)
+      */
+    void loadIndex()
+    {
+        long n = (count_ + header_.blockSize - 1) / header_.blockSize;
+        index_ = Array<int64_t>::allocate(n);
+
+        if (
+            header_.indexOffset != 0 &&
+            static_cast<long>(header_.recordCount) == count_ &&
+            header_.indexOffset + n * sizeof(int64_t) <= static_cast<uint64_t>(data_.count())
+        ) {
+            std::memcpy(index_.items(), data_.items() + header_.indexOffset, n * sizeof(int64_t));
+        }
+        else {
+            for (long i = 0; i < n; ++i) {
+                index_[i] = records_[i * header_.blockSize].time;
+            }
+        }
+    }
+
+    double startTime() const
+    {
+        return count_ > 0 ? records_[0].time / 1e9 : 0.;
+    }
+
+    double endTime() const
+    {
+        return count_ > 0 ? records_[count_ - 1].time / 1e9 : 0.;
+    }
+
+    void seek(double time)
+    {
+        int64_t t = static_cast<int64_t>(std::llround(time * 1e9));
+
+        long lo = 0, hi = index_.count();
+        while (lo < hi) {
+            long mid = (lo + hi) / 2;
+            if (index_[mid] <= t) lo = mid + 1;
+            else hi = mid;
+        }
+        long i = (lo > 0 ? lo - 1 : 0) * header_.blockSize;
+        while (i < count_ && records_[i].time < t) ++i;
+
+        next_ = i;
+        replayStart_ = -1;
+    }
+
+    /** Wall clock time at which record \a i is due for delivery
+      */
+    double dueTime(long i)
+    {
+        if (speed_ <= 0) return 0;
+        if (replayStart_ < 0) {
+            replayStart_ = System::now();
+            recordStart_ = records_[i].time;
+        }
+        return replayStart_ + (records_[i].time - recordStart_) / 1e9 / speed_;
+    }
+
+    bool wait(int timeout) override
+    {
+        if (next_ >= count_) return false;
+        if (speed_ <= 0) return true;
+        double due = dueTime(next_);
+        if (timeout >= 0 && System::now() + timeout / 1000. < due) {
+            Thread::sleep(timeout / 1000.);
+            return false;
+        }
+        Thread::sleepUntil(due);
+        return true;
+    }
+
+    bool read(Out<CanFrame> frame) override
+    {
+        if (!wait(-1)) return false;
+        frame = decode(records_[next_++]);
+        return true;
+    }
+
+    long readBatch(Array<CanFrame> &frames) override
+    {
+        if (frames.count() == 0 || !wait(-1)) return 0;
+        long n = 0;
+        double now = (speed_ > 0) ? System::now() : 0;
+        while (n < frames.count() && next_ < count_ && dueTime(next_) <= now) {
+            frames[n++] = decode(records_[next_++]);
+        }
+        return n;
+    }
+
+    CanFrame decode(const CanCaptureRecord &record)
+    {
+        CanFrame frame;
+        frame.canId(record.canId);
+        frame.size(record.size);
+        for (int i = 0; i < record.size && i < 8; ++i) {
+            frame.at(i) = record.data[i];
+        }
+        time_ = record.time / 1e9;
+        frame.timestamp(time_);
+        return frame;
+    }
+
+    void write(const CanFrame &frame) override
+    {}
+
+    double time() const override
+    {
+        return time_;
+    }
+
+    String data_;
+    CanCaptureHeader header_;
+    const CanCaptureRecord *records_ { nullptr };
+    long count_ { 0 };
+    Array<int64_t> index_;
+    double speed_ { 1 };
+    long next_ { 0 };
+    double replayStart_ { -1 };
+    int64_t recordStart_ { 0 };
+    double time_ { 0 };
+};
+
+CanCaptureMedia::CanCaptureMedia(const String &path, double speed):
+    CanMedia{new State{path, speed}}
+{}
+
+long CanCaptureMedia::count() const
+{
+    return me().count_;
+}
+
+double CanCaptureMedia::startTime() const
+{
+    return me().startTime();
+}
+
+double CanCaptureMedia::endTime() const
+{
+    return me().endTime();
+}
+
+CanCaptureMedia &CanCaptureMedia::seek(double time)
+{
+    me().seek(time);
+    return *this;
+}
+
+CanCaptureMedia::State &CanCaptureMedia::me()
+{
+    return Object::me.as<State>();
+}
+
+const CanCaptureMedia::State &CanCaptureMedia::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2023 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/CanCaptureWriter>
+#include <cc/CanCaptureFormat>
+#include <cc/CanFilter>
+#include <cc/LineSource>
+#include <cc/File>
+#include <cc/List>
+#include <cc/System>
+#include <cstring>
+#include <cmath>
+
+namespace cc {
+
+struct CanCaptureWriter::State final: public Object::State
+{
+    explicit State(const String &path):
+        file_{path, FileOpen::Overwrite}
+    {
+        writeHeader();
+    }
+
+    ~State()
+    {
+        close();
+    }
+
+    void write(const CanFrame &frame)
+    {
+        double t = frame.timestamp();
+        if (t == 0) t = System::now();
+
+        CanCaptureRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.time = static_cast<int64_t>(std::llround(t * 1e9));
+        record.canId = frame.canId();
+        record.size = static_cast<uint8_t>(frame.size());
+        for (int i = 0; i < frame.size() && i < 8; ++i) {
+            record.data[i] = frame.at(i);
+        }
+
+        if (count_ % header_.blockSize == 0) index_.append(record.time);
+        ++count_;
+
+        std::memcpy(buffer_.items() + fill_, &record, sizeof(record));
+        fill_ += sizeof(record);
+        if (fill_ == buffer_.count()) flush();
+    }
+
+    void importText(const String &text, double startTime)
+    {
+        LineSource source{text};
+        double time = startTime;
+
+        for (String line; source.read(&line);) {
+            CanFrame frame;
+            long i = 0;
+            if (line.find(" -- ", &i)) {
+                // hexdump generated by CanLogger: "<time> <delta time> -- <frame>"
+                String head = line.copy(0, i);
+                head.trim();
+                long j = 0;
+                if (!head.find(' ', &j)) continue;
+                double t = 0;
+                if (!head.copy(0, j).readNumber<double>(&t)) continue;
+                if (!CanFrame::read(line.copy(i + 4, line.count()), &frame)) continue;
+                time = startTime + t;
+            }
+            else {
+                // plain recording: "<frame> <delta time in ms>" (see CanReplayMedia)
+                uint64_t deltaTime = 0;
+                if (!CanFrame::read(line, &frame, &deltaTime)) continue;
+                time += deltaTime / 1000.;
+            }
+            if (frame.canId() > CanFilter::SffMask) frame.eff(true);
+            frame.timestamp(time);
+            write(frame);
+        }
+    }
+
+    void flush()
+    {
+        if (fill_ > 0) {
+            file_.write(buffer_, fill_);
+            fill_ = 0;
+        }
+    }
+
+    void close()
+    {
+        if (!file_) return;
+
+        flush();
+
+        header_.recordCount = count_;
+        header_.indexOffset = sizeof(CanCaptureHeader) + count_ * sizeof(CanCaptureRecord);
+
+        Bytes index = Bytes::allocate(index_.count() * sizeof(int64_t));
+        long i = 0;
+        for (int64_t time: index_) {
+            std::memcpy(index.items() + i, &time, sizeof(time));
+            i += sizeof(time);
+        }
+        if (index.count() > 0) file_.write(index);
+
+        file_.seek(0);
+        writeHeader();
+        file_.close();
+        file_ = File{};
+    }
+
+    void writeHeader()
+    {
+        Bytes header = Bytes::allocate(sizeof(CanCaptureHeader));
+        std::memcpy(header.items(), &header_, sizeof(CanCaptureHeader));
+        file_.write(header);
+    }
+
+    static constexpr long BufferSize = 256 * sizeof(CanCaptureRecord);
+
+    File file_;
+    CanCaptureHeader header_;
+    List<int64_t> index_;
+    Bytes buffer_ { Bytes::allocate(BufferSize) };
+    long fill_ { 0 };
+    long count_ { 0 };
+};
+
+CanCaptureWriter::CanCaptureWriter(const String &path):
+    Object{new State{path}}
+{}
+
+void CanCaptureWriter::write(const CanFrame &frame)
+{
+    me().write(frame);
+}
+
+void CanCaptureWriter::write(const Array<CanFrame> &frames, long count)
+{
+    for (long i = 0; i < count; ++i) {
+        me().write(frames[i]);
+    }
+}
+
+void CanCaptureWriter::importText(const String &text, double startTime)
+{
+    me().importText(text, startTime);
+}
+
+long CanCaptureWriter::count() const
+{
+    return me().count_;
+}
+
+void CanCaptureWriter::flush()
+{
+    me().flush();
+}
+
+void CanCaptureWriter::close()
+{
+    me().close();
+}
+
+CanCaptureWriter::State &CanCaptureWriter::me()
+{
+    return Object::me.as<State>();
+}
+
+const CanCaptureWriter::State &CanCaptureWriter::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
@@ -146,6 +146,8 @@ struct CanFrame::State: public Object::State, public StructCanFrame
         }
         return f;
     }
+
+    double timestamp_ { 0 };
 };
 
 CanFrame::CanFrame():
@@ -288,6 +290,17 @@ CanFrame &CanFrame::eff(bool on)
     return *this;
 }
 
+double CanFrame::timestamp() const
+{
+    return me().timestamp_;
+}
+
+CanFrame &CanFrame::timestamp(double newValue)
+{
+    me().timestamp_ = newValue;
+    return *this;
+}
+
 bool CanFrame::operator==(const CanFrame &other) const
 {
     return me().equals(other.me());
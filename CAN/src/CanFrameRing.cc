@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2023 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/CanFrameRing>
+#include <cc/SpinLock>
+#include <cc/System>
+#include <atomic>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cc {
+
+struct CanFrameRing::State final: public Object::State
+{
+    /** Storage of a single frame
+      *
+      * The sequence number is invalidated before and updated after the payload has been written (seqlock),
+      * so that readers can detect if a slot got overwritten while they were reading it.
+      */
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> seq { 0 }; ///< Cursor position behind this frame (0 while writing)
+        std::atomic<uint32_t> canId { 0 };
+        std::atomic<uint32_t> source { 0 };
+        std::atomic<uint64_t> data { 0 };
+        std::atomic<double> timestamp { 0 };
+        std::atomic<uint8_t> size { 0 };
+    };
+
+    static long roundUp(long capacity)
+    {
+        long n = 1;
+        while (n < capacity) n <<= 1;
+        return n;
+    }
+
+    explicit State(long capacity):
+        capacity_{roundUp(capacity)},
+        slots_{new Slot[capacity_]}
+    {}
+
+    ~State()
+    {
+        delete[] slots_;
+    }
+
+    void write(const CanFrame &frame, uint32_t source)
+    {
+        uint64_t data = 0;
+        for (int i = 0; i < frame.size() && i < 8; ++i) {
+            data |= uint64_t{frame.at(i)} << (8 * i);
+        }
+        double timestamp = frame.timestamp();
+        if (timestamp == 0) timestamp = System::now();
+
+        {
+            Guard<SpinLock> guard{writeLock_};
+            if (closed_.load(std::memory_order_relaxed)) return;
+
+            uint64_t n = head_.load(std::memory_order_relaxed);
+            Slot &slot = slots_[n & (capacity_ - 1)];
+            slot.seq.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.canId.store(frame.canId(), std::memory_order_relaxed);
+            slot.source.store(source, std::memory_order_relaxed);
+            slot.data.store(data, std::memory_order_relaxed);
+            slot.timestamp.store(timestamp, std::memory_order_relaxed);
+            slot.size.store(frame.size(), std::memory_order_relaxed);
+            slot.seq.store(n + 1, std::memory_order_release);
+            head_.store(n + 1, std::memory_order_release);
+        }
+
+        signal();
+    }
+
+    uint64_t read(InOut<uint64_t> cursor, Out<CanFrame> frame, Out<uint32_t> source) const
+    {
+        uint64_t c = cursor;
+        uint64_t head = head_.load(std::memory_order_acquire);
+        if (head - c > static_cast<uint64_t>(capacity_)) {
+            return resync(cursor, head);
+        }
+
+        const Slot &slot = slots_[c & (capacity_ - 1)];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        uint32_t canId = slot.canId.load(std::memory_order_relaxed);
+        uint32_t src = slot.source.load(std::memory_order_relaxed);
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        double timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        int size = slot.size.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq != c + 1 || slot.seq.load(std::memory_order_relaxed) != seq) {
+            return resync(cursor, head_.load(std::memory_order_acquire));
+        }
+
+        CanFrame result{canId};
+        result.size(size);
+        for (int i = 0; i < size; ++i) {
+            result.at(i) = static_cast<uint8_t>(data >> (8 * i));
+        }
+        result.timestamp(timestamp);
+        frame = result;
+        source = src;
+        cursor = c + 1;
+        return 0;
+    }
+
+    /** Move \a cursor to the oldest frame which is safe to read
+      * \return Number of frames lost
+      */
+    uint64_t resync(InOut<uint64_t> cursor, uint64_t head) const
+    {
+        // leave some headroom as the writer might already be overwriting the oldest slot
+        uint64_t headroom = capacity_ / 8;
+        uint64_t oldest = head > capacity_ - headroom ? head - (capacity_ - headroom) : 0;
+        uint64_t c = cursor;
+        uint64_t lost = oldest > c ? oldest - c : 1;
+        cursor = c + lost;
+        return lost;
+    }
+
+    bool wait(uint64_t cursor, int timeout) const
+    {
+        double deadline = timeout < 0 ? 0 : System::now() + timeout / 1000.;
+
+        while (true) {
+            uint32_t signal = signal_.load(std::memory_order_seq_cst);
+            if (head_.load(std::memory_order_acquire) != cursor || closed_.load(std::memory_order_acquire)) {
+                return true;
+            }
+
+            struct timespec ts;
+            struct timespec *tp = nullptr;
+            if (timeout >= 0) {
+                double remaining = deadline - System::now();
+                if (remaining <= 0) return false;
+                ts.tv_sec = static_cast<time_t>(remaining);
+                ts.tv_nsec = static_cast<long>((remaining - ts.tv_sec) * 1e9);
+                tp = &ts;
+            }
+
+            sleeping_.store(true, std::memory_order_seq_cst);
+            if (
+                head_.load(std::memory_order_seq_cst) == cursor &&
+                !closed_.load(std::memory_order_seq_cst)
+            ) {
+                ::syscall(SYS_futex, futexWord(), FUTEX_WAIT_PRIVATE, signal, tp, nullptr, 0);
+            }
+        }
+    }
+
+    void signal()
+    {
+        signal_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_seq_cst) && sleeping_.exchange(false, std::memory_order_seq_cst)) {
+            ::syscall(SYS_futex, futexWord(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    void close()
+    {
+        closed_.store(true, std::memory_order_seq_cst);
+        signal();
+    }
+
+    uint32_t *futexWord() const
+    {
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free);
+        return reinterpret_cast<uint32_t *>(&signal_);
+    }
+
+    const long capacity_;
+    Slot *slots_;
+    SpinLock writeLock_;
+    alignas(64) std::atomic<uint64_t> head_ { 0 };
+    alignas(64) mutable std::atomic<uint32_t> signal_ { 0 };
+    mutable std::atomic<bool> sleeping_ { false }; ///< Some reader might be waiting for signal_ to change
+    std::atomic<bool> closed_ { false };
+};
+
+CanFrameRing::CanFrameRing(long capacity):
+    Object{new State{capacity}}
+{}
+
+long CanFrameRing::capacity() const
+{
+    return me().capacity_;
+}
+
+uint64_t CanFrameRing::head() const
+{
+    return me().head_.load(std::memory_order_acquire);
+}
+
+void CanFrameRing::write(const CanFrame &frame, uint32_t source)
+{
+    me().write(frame, source);
+}
+
+uint64_t CanFrameRing::read(InOut<uint64_t> cursor, Out<CanFrame> frame, Out<uint32_t> source) const
+{
+    return me().read(cursor, frame, source);
+}
+
+bool CanFrameRing::wait(uint64_t cursor, int timeout) const
+{
+    return me().wait(cursor, timeout);
+}
+
+void CanFrameRing::close()
+{
+    me().close();
+}
+
+bool CanFrameRing::isClosed() const
+{
+    return me().closed_.load(std::memory_order_acquire);
+}
+
+const CanFrameRing::State &CanFrameRing::me() const
+{
+    return Object::me.as<State>();
+}
+
+CanFrameRing::State &CanFrameRing::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
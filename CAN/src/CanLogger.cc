@@ -12,6 +12,7 @@
 #include <cc/Thread>
 #include <cc/Format>
 #include <cc/Map>
+#include <cc/Array>
 #include <cc/debugging>
 #include <cc/str>
 
@@ -43,11 +44,17 @@ struct CanLogger::State final: public Object::State
         output_ = output;
     }
 
+    void setCapture(const CanCaptureWriter &capture)
+    {
+        assert(!thread_);
+        capture_ = capture;
+    }
+
     void start()
     {
-        if (!output_) output_ = stdOutput();
+        if (!output_ && !capture_) output_ = stdOutput();
 
-        thread_ = Thread{[this]{ run(); }};
+        thread_ = Thread{[this]{ capture_ ? record() : run(); }};
         thread_.start();
     }
 
@@ -57,28 +64,37 @@ struct CanLogger::State final: public Object::State
 
         double t0 = -1;
 
-        for (CanFrame frame; media_.read(&frame);)
+        Array<CanFrame> frames = Array<CanFrame>::allocate(BatchSize);
+
+        for (long n = 0; (n = media_.readBatch(frames)) > 0;)
         {
-            double t = System::now();
-            if (t0 < 0) t0 = t;
-            t -= t0;
+            Format f;
 
-            double dt = 0, tl = 0;
-            if (lastTimes.lookup(frame.canId(), &tl)) {
-                dt = t - tl;
-            }
-            lastTimes.establish(frame.canId(), t);
+            for (long i = 0; i < n; ++i)
+            {
+                const CanFrame &frame = frames[i];
 
-            Format f;
-            f << fixed(t, 3, 3) << " " << fixed(dt, 3, 3) << " -- " << frame << nl;
+                double t = frame.timestamp();
+                if (t == 0) t = System::now();
+                if (t0 < 0) t0 = t;
+                t -= t0;
+
+                double dt = 0, tl = 0;
+                if (lastTimes.lookup(frame.canId(), &tl)) {
+                    dt = t - tl;
+                }
+                lastTimes.establish(frame.canId(), t);
+
+                f << fixed(t, 3, 3) << " " << fixed(dt, 3, 3) << " -- " << frame << nl;
 
-            String info;
+                String info;
 
-            for (CanAnnotator &annotator: annotators_) {
-                info = annotator.annotate(frame);
-                if (info != "") {
-                    f << nl << info.indented("  ") << nl << nl;
-                    break;
+                for (CanAnnotator &annotator: annotators_) {
+                    info = annotator.annotate(frame);
+                    if (info != "") {
+                        f << nl << info.indented("  ") << nl << nl;
+                        break;
+                    }
                 }
             }
 
@@ -86,10 +102,26 @@ struct CanLogger::State final: public Object::State
         }
     }
 
+    void record()
+    {
+        Array<CanFrame> frames = Array<CanFrame>::allocate(BatchSize);
+
+        for (long n = 0; (n = media_.readBatch(frames)) > 0;)
+        {
+            capture_.write(frames, n);
+            capture_.flush();
+        }
+
+        capture_.close();
+    }
+
+    static constexpr long BatchSize = 64;
+
     Thread thread_;
     CanMedia media_;
     List<CanAnnotator> annotators_;
     Stream output_;
+    CanCaptureWriter capture_;
 };
 
 CanLogger::CanLogger(const CanMedia &media):
@@ -108,6 +140,12 @@ CanLogger &CanLogger::setOutput(const Stream &output)
     return *this;
 }
 
+CanLogger &CanLogger::setCapture(const CanCaptureWriter &capture)
+{
+    me().setCapture(capture);
+    return *this;
+}
+
 void CanLogger::start()
 {
     me().start();
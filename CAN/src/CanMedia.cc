@@ -18,6 +18,14 @@ bool CanMedia::waitUntil(double time)
     return wait(static_cast<int>((now - time) * 1000));
 }
 
+long CanMedia::State::readBatch(Array<CanFrame> &frames)
+{
+    return (frames.count() > 0 && read(&frames[0])) ? 1 : 0;
+}
+
+void CanMedia::State::filter(const List<CanFilter> &filters)
+{}
+
 double CanMedia::State::time() const
 {
     return System::now();
@@ -7,10 +7,13 @@
  */
 
 #include <cc/CanSocket>
+#include <cc/System>
 #include <net/if.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <unistd.h>
 #include <cstring>
 
@@ -31,6 +34,24 @@ struct CanSocket::State final: public CanMedia::State
         if (::bind(socket_.fd(), (struct sockaddr *)&addr, sizeof(addr)) == -1) {
             CC_SYSTEM_ERROR(errno, interface);
         }
+
+        enableTimestamps();
+
+        for (int i = 0; i < BatchSize; ++i) {
+            vectors_[i].iov_base = &frames_[i];
+            vectors_[i].iov_len = sizeof(struct can_frame);
+        }
+    }
+
+    void enableTimestamps()
+    {
+        // software stamps only: hardware stamps are taken from the controller's clock, not from CLOCK_REALTIME
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+        if (::setsockopt(socket_.fd(), SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == -1) {
+            int on = 1;
+            (void)::setsockopt(socket_.fd(), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+        }
     }
 
     int lookupInterface(const String &interface)
@@ -60,28 +81,106 @@ struct CanSocket::State final: public CanMedia::State
         }
     }
 
+    void filter(const List<CanFilter> &filters) override
+    {
+        const bool acceptAll = filters.count() == 0 || filters.count() > CAN_RAW_FILTER_MAX;
+
+        Array<struct can_filter> rules = Array<struct can_filter>::allocate(acceptAll ? 1 : filters.count());
+        if (acceptAll) {
+            rules[0] = can_filter{0, 0};
+        }
+        else {
+            long i = 0;
+            for (const CanFilter &filter: filters) {
+                rules[i++] = can_filter{filter.canId() | (filter.inverted() ? CAN_INV_FILTER : 0u), filter.mask()};
+            }
+        }
+
+        if (::setsockopt(socket_.fd(), SOL_CAN_RAW, CAN_RAW_FILTER, rules.items(), rules.count() * sizeof(struct can_filter)) == -1) {
+            CC_SYSTEM_DEBUG_ERROR(errno);
+        }
+    }
+
     bool wait(int timeout = -1) override
     {
-        return socket_.wait(IoEvent::ReadyRead, timeout);
+        return head_ < fill_ || socket_.wait(IoEvent::ReadyRead, timeout);
     }
 
     bool read(Out<CanFrame> frame) override
     {
-        ssize_t n = 0;
+        if (head_ == fill_ && !receive()) return false;
+        take(frame);
+        return true;
+    }
 
-        while (true) {
-            n = ::read(socket_.fd(), frame->frame(), frame->frameSize());
-            if (n == -1) {
-                if (errno != EINTR)
-                    CC_SYSTEM_DEBUG_ERROR(errno);
+    long readBatch(Array<CanFrame> &frames) override
+    {
+        if (head_ == fill_ && !receive()) return 0;
+        long n = 0;
+        for (; n < frames.count() && head_ < fill_; ++n) take(&frames[n]);
+        return n;
+    }
+
+    void take(Out<CanFrame> frame)
+    {
+        std::memcpy(frame->frame(), &frames_[head_], sizeof(struct can_frame));
+        frame->timestamp(times_[head_]);
+        ++head_;
+    }
+
+    /** Receive all frames which are available (up to BatchSize) with a single system call
+      */
+    bool receive()
+    {
+        for (int i = 0; i < BatchSize; ++i) {
+            struct msghdr &header = messages_[i].msg_hdr;
+            std::memset(&header, 0, sizeof(header));
+            header.msg_iov = &vectors_[i];
+            header.msg_iovlen = 1;
+            header.msg_control = controls_[i];
+            header.msg_controllen = sizeof(controls_[i]);
+        }
+
+        int n = -1;
+        do n = ::recvmmsg(socket_.fd(), messages_, BatchSize, MSG_WAITFORONE, nullptr);
+        while (n == -1 && errno == EINTR);
+        if (n == -1) CC_SYSTEM_DEBUG_ERROR(errno);
+
+        double now = 0;
+        for (int i = 0; i < n; ++i) {
+            times_[i] = timestamp(messages_[i].msg_hdr);
+            if (times_[i] == 0) {
+                if (now == 0) now = System::now();
+                times_[i] = now;
             }
-            else
-                break;
         }
 
+        head_ = 0;
+        fill_ = n;
         return n > 0;
     }
 
+    /** Extract the reception time (in seconds since start of Epoch) from the ancillary data of \a header
+      */
+    static double timestamp(struct msghdr &header)
+    {
+        for (struct cmsghdr *message = CMSG_FIRSTHDR(&header); message; message = CMSG_NXTHDR(&header, message)) {
+            if (message->cmsg_level != SOL_SOCKET) continue;
+            if (message->cmsg_type == SCM_TIMESTAMPING) {
+                struct scm_timestamping stamps;
+                std::memcpy(&stamps, CMSG_DATA(message), sizeof(stamps));
+                const struct timespec &ts = stamps.ts[0];
+                return ts.tv_sec + ts.tv_nsec / 1e9;
+            }
+            if (message->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec ts;
+                std::memcpy(&ts, CMSG_DATA(message), sizeof(ts));
+                return ts.tv_sec + ts.tv_nsec / 1e9;
+            }
+        }
+        return 0;
+    }
+
     void write(const CanFrame &frame) override
     {
         while (true) {
@@ -94,7 +193,16 @@ struct CanSocket::State final: public CanMedia::State
         }
     }
 
+    static constexpr int BatchSize = 64;
+
     IoStream socket_;
+    struct can_frame frames_[BatchSize];
+    struct iovec vectors_[BatchSize];
+    struct mmsghdr messages_[BatchSize];
+    alignas(struct cmsghdr) char controls_[BatchSize][CMSG_SPACE(sizeof(struct scm_timestamping))];
+    double times_[BatchSize];
+    int head_ { 0 };
+    int fill_ { 0 };
 };
 
 CanSocket::CanSocket(const String &interface):
@@ -8,8 +8,7 @@
 
 #include <cc/VirtualCanBus>
 #include <cc/CanFrameFeed>
-#include <cc/List>
-#include <cc/Mutex>
+#include <atomic>
 
 namespace cc {
 
@@ -18,63 +17,50 @@ class CanVirtualFeed final: public CanFrameFeed
 public:
     CanVirtualFeed() = default;
 
-    explicit CanVirtualFeed(const VirtualCanBus &bus):
-        CanFrameFeed{new State{bus}}
+    CanVirtualFeed(const CanFrameRing &ring, uint32_t id):
+        CanFrameFeed{new State{ring, id}}
     {}
 
 private:
     struct State: public CanFrameFeed::State
     {
-        explicit State(const VirtualCanBus &bus):
-            bus_{bus}
+        State(const CanFrameRing &ring, uint32_t id):
+            CanFrameFeed::State{ring, id}
         {}
 
-        void write(const CanFrame &frame) override;
-
-        VirtualCanBus bus_;
+        void write(const CanFrame &frame) override
+        {
+            ring_.write(frame, source_);
+        }
     };
 };
 
 struct VirtualCanBus::State: public Object::State
 {
+    explicit State(long capacity):
+        ring_{capacity}
+    {}
+
     CanMedia connect()
     {
-        CanVirtualFeed feed{alias<VirtualCanBus>(this)};
-        Guard<Mutex> guard{mutex_};
-        connections_.append(feed);
-        return feed;
+        return CanVirtualFeed{ring_, ++lastId_};
     }
 
     void shutdown()
     {
-        Guard<Mutex> guard{mutex_};
-        for (CanVirtualFeed &feed: connections_) {
-            feed.shutdown();
-        }
-        connections_.deplete();
-    }
-
-    void broadcast(const CanFrame &frame, const CanFrameFeed &source)
-    {
-        Guard<Mutex> guard{mutex_};
-        for (CanVirtualFeed &feed: connections_) {
-            if (source != feed) {
-                feed.feedFrame(frame);
-            }
-        }
+        ring_.close();
     }
 
-    List<CanVirtualFeed> connections_;
-    Mutex mutex_;
+    CanFrameRing ring_;
+    std::atomic<uint32_t> lastId_ { 0 };
 };
 
-void CanVirtualFeed::State::write(const CanFrame &frame)
-{
-    bus_->broadcast(frame, alias<CanVirtualFeed>(this));
-}
-
 VirtualCanBus::VirtualCanBus():
-    Object{new State}
+    VirtualCanBus{CanFrameRing::DefaultCapacity}
+{}
+
+VirtualCanBus::VirtualCanBus(long capacity):
+    Object{new State{capacity}}
 {}
 
 CanMedia VirtualCanBus::connect()
@@ -97,9 +83,4 @@ const VirtualCanBus::State &VirtualCanBus::me() const
     return Object::me.as<State>();
 }
 
-VirtualCanBus::State *VirtualCanBus::operator->()
-{
-    return &me();
-}
-
 } // namespace cc
@@ -134,6 +134,14 @@ bool Node::State::expeditedTransferIsEnabled() const
     return true;
 }
 
+List<CanFilter> Node::State::filters() const
+{
+    return List<CanFilter>{
+        CanFilter::standard(0), // NMT
+        CanFilter::standard(0x600 + nodeId_) // SDO requests
+    };
+}
+
 ErrorRegister Node::State::errorRegister() const
 {
     return errorRegister_;
@@ -162,6 +170,8 @@ void Node::State::start()
         setNodeState(NodeState::Operational);
     }
 
+    media_.filter(filters());
+
     thread_ = Thread{[this]{ run(); }};
     thread_.start();
 }
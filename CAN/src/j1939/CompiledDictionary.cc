@@ -0,0 +1,711 @@
+/*
+ * Copyright (C) 2023 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/j1939/CompiledDictionary>
+#include <cc/j1939/CanId>
+#include <cc/SpinLock>
+#include <cc/FileInfo>
+#include <cc/File>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace cc::j1939 {
+
+namespace {
+
+/** Reference to a string in the string pool
+  */
+struct StringRef
+{
+    uint32_t offset; ///< Offset into the string pool
+    uint32_t size; ///< Number of bytes
+};
+
+/** Location of a table within the image
+  */
+struct TableRef
+{
+    uint32_t offset; ///< %File offset of the first record
+    uint32_t count; ///< Number of records (or number of bytes for the string pool)
+};
+
+/** Header of a compiled dictionary
+  *
+  * The header is followed by the tables (in order of declaration) and the string pool.
+  * All fields are stored in host byte order, all tables are 8 byte aligned.
+  */
+struct ImageHeader
+{
+    static constexpr uint64_t Magic = 0x44393339314A4343u; ///< "CCJ1939D" in little endian byte order
+    static constexpr uint32_t Version = 1;
+
+    uint64_t magic; ///< %File type and byte order identification
+    uint32_t version; ///< %File format version
+    uint32_t size; ///< Total size of the image in bytes
+    TableRef sources; ///< SourceRecord table
+    TableRef messages; ///< MessageRecord table (sorted by PGN)
+    TableRef members; ///< MemberRecord table (grouped by message)
+    TableRef subsystems; ///< SubsystemRecord table (sorted by industry, subsystem and function)
+    TableRef vendors; ///< VendorRecord table (sorted by vendor ID)
+    TableRef industries; ///< IndustryRecord table (sorted by industry)
+    TableRef strings; ///< String pool
+};
+
+/** Size and modification time of a source table
+  */
+struct SourceRecord
+{
+    int64_t size;
+    int64_t lastModified; ///< Nanoseconds since start of Epoch
+};
+
+struct MessageRecord
+{
+    uint32_t pgn;
+    int32_t defaultPriority;
+    uint32_t isMultiPacket;
+    uint32_t reserved;
+    uint32_t firstMember; ///< Index of the first member in the MemberRecord table
+    uint32_t memberCount;
+    StringRef name;
+    StringRef label;
+    StringRef description;
+    StringRef notes;
+    StringRef transmissionRate;
+    StringRef document;
+};
+
+struct MemberRecord
+{
+    StringRef name;
+    StringRef description;
+    StringRef notes;
+    StringRef dataRange;
+    StringRef operationalRange;
+    StringRef unit;
+    StringRef slotIdentifier;
+    StringRef slotName;
+    StringRef type;
+    int32_t bitOffset;
+    int32_t bitLengthMin;
+    int32_t bitLengthMax;
+    uint32_t reserved;
+    double scale;
+    double offset;
+    double max;
+};
+
+struct SubsystemRecord
+{
+    int32_t industry;
+    int32_t subsystem;
+    int32_t function;
+    uint32_t reserved;
+    StringRef subsystemName;
+    StringRef functionName;
+    StringRef functionNotes;
+};
+
+struct VendorRecord
+{
+    uint32_t vendorId;
+    uint32_t reserved;
+    StringRef name;
+    StringRef location;
+};
+
+struct IndustryRecord
+{
+    int32_t industry;
+    uint32_t reserved;
+    StringRef name;
+};
+
+static_assert(sizeof(ImageHeader) % 8 == 0);
+static_assert(sizeof(SourceRecord) % 8 == 0);
+static_assert(sizeof(MessageRecord) % 8 == 0);
+static_assert(sizeof(MemberRecord) % 8 == 0);
+static_assert(sizeof(SubsystemRecord) % 8 == 0);
+static_assert(sizeof(VendorRecord) % 8 == 0);
+static_assert(sizeof(IndustryRecord) % 8 == 0);
+
+SourceRecord stamp(const String &path)
+{
+    SourceRecord record { 0, 0 };
+    FileInfo info{path};
+    if (info) {
+        record.size = info.size();
+        record.lastModified = std::llround(info.lastModified() * 1e9);
+    }
+    return record;
+}
+
+/** Read access to a memory mapped image
+  */
+class Image
+{
+public:
+    Image() = default;
+
+    explicit Image(const String &data):
+        data_{data}
+    {}
+
+    bool isValid() const
+    {
+        if (data_.count() < static_cast<long>(sizeof(ImageHeader))) return false;
+        const ImageHeader &h = header();
+        return
+            h.magic == ImageHeader::Magic &&
+            h.version == ImageHeader::Version &&
+            h.size == data_.count() &&
+            fits<SourceRecord>(h.sources) &&
+            fits<MessageRecord>(h.messages) &&
+            fits<MemberRecord>(h.members) &&
+            fits<SubsystemRecord>(h.subsystems) &&
+            fits<VendorRecord>(h.vendors) &&
+            fits<IndustryRecord>(h.industries) &&
+            fits<char>(h.strings);
+    }
+
+    bool isUpToDate(const List<String> &sourcePaths) const
+    {
+        if (header().sources.count != static_cast<uint32_t>(sourcePaths.count())) return false;
+        const SourceRecord *records = table<SourceRecord>(header().sources);
+        long i = 0;
+        for (const String &path: sourcePaths) {
+            SourceRecord current = stamp(path);
+            const SourceRecord &record = records[i++];
+            if (current.size == 0 && current.lastModified == 0) continue; // source table is not installed
+            if (current.size != record.size || current.lastModified != record.lastModified) return false;
+        }
+        return true;
+    }
+
+    const ImageHeader &header() const
+    {
+        return *reinterpret_cast<const ImageHeader *>(data_.chars());
+    }
+
+    template<class T>
+    const T *table(const TableRef &ref) const
+    {
+        return reinterpret_cast<const T *>(data_.chars() + ref.offset);
+    }
+
+    String text(const StringRef &ref) const
+    {
+        const TableRef &strings = header().strings;
+        if (ref.size == 0 || uint64_t{ref.offset} + ref.size > strings.count) return String{};
+        return String{data_.chars() + strings.offset + ref.offset, static_cast<long>(ref.size)};
+    }
+
+private:
+    template<class T>
+    bool fits(const TableRef &ref) const
+    {
+        return ref.offset % alignof(T) == 0 && uint64_t{ref.offset} + uint64_t{ref.count} * sizeof(T) <= header().size;
+    }
+
+    String data_;
+};
+
+/** Collect strings into a deduplicated string pool
+  */
+class StringPool
+{
+public:
+    StringRef operator()(const String &s)
+    {
+        if (s.count() == 0) return StringRef{0, 0};
+        uint32_t offset = 0;
+        if (!offsets_.lookup(s, &offset)) {
+            offset = static_cast<uint32_t>(size_);
+            offsets_.insert(s, offset);
+            parts_.append(s);
+            size_ += s.count();
+        }
+        return StringRef{offset, static_cast<uint32_t>(s.count())};
+    }
+
+    long size() const { return size_; }
+
+    void copyTo(char *dst) const
+    {
+        for (const String &part: parts_) {
+            std::memcpy(dst, part.chars(), part.count());
+            dst += part.count();
+        }
+    }
+
+private:
+    Map<String, uint32_t> offsets_;
+    List<String> parts_;
+    long size_ { 0 };
+};
+
+class CompiledMessageDictionary final: public MessageDictionary
+{
+public:
+    explicit CompiledMessageDictionary(const Image &image):
+        MessageDictionary{new State{image}}
+    {}
+
+private:
+    struct State final: public MessageDictionary::State
+    {
+        explicit State(const Image &image):
+            image_{image},
+            records_{image.table<MessageRecord>(image.header().messages)},
+            count_{image.header().messages.count}
+        {}
+
+        bool lookup(uint32_t canId, Out<MessageTypeInfo> messageType) const override
+        {
+            uint32_t pgn = CanId{canId}.pgn();
+
+            Guard<SpinLock> guard{cacheLock_};
+            if (cache_.lookup(pgn, messageType)) return true;
+
+            const MessageRecord *record = std::lower_bound(
+                records_, records_ + count_, pgn,
+                [](const MessageRecord &record, uint32_t pgn) { return record.pgn < pgn; }
+            );
+            if (record == records_ + count_ || record->pgn != pgn) return false;
+
+            MessageTypeInfo entry = decode(*record);
+            cache_.insert(pgn, entry);
+            messageType = entry;
+            return true;
+        }
+
+        Map<uint32_t, MessageTypeInfo> messageTypes() const override
+        {
+            Map<uint32_t, MessageTypeInfo> entries;
+            for (uint32_t i = 0; i < count_; ++i) {
+                entries.insert(records_[i].pgn, decode(records_[i]));
+            }
+            return entries;
+        }
+
+        MessageTypeInfo decode(const MessageRecord &record) const
+        {
+            MessageTypeInfo entry;
+            access(entry)->name_ = image_.text(record.name);
+            access(entry)->label_ = image_.text(record.label);
+            access(entry)->description_ = image_.text(record.description);
+            access(entry)->notes_ = image_.text(record.notes);
+            access(entry)->transmissionRate_ = image_.text(record.transmissionRate);
+            access(entry)->document_ = image_.text(record.document);
+            access(entry)->defaultPriority_ = record.defaultPriority;
+            access(entry)->isMultiPacket_ = record.isMultiPacket;
+
+            const TableRef &members = image_.header().members;
+            if (uint64_t{record.firstMember} + record.memberCount > members.count) return entry;
+
+            const MemberRecord *memberRecords = image_.table<MemberRecord>(members) + record.firstMember;
+            for (uint32_t i = 0; i < record.memberCount; ++i) {
+                const MemberRecord &memberRecord = memberRecords[i];
+                MessageMemberInfo member;
+                access(member)->name_ = image_.text(memberRecord.name);
+                access(member)->description_ = image_.text(memberRecord.description);
+                access(member)->notes_ = image_.text(memberRecord.notes);
+                access(member)->dataRange_ = image_.text(memberRecord.dataRange);
+                access(member)->operationalRange_ = image_.text(memberRecord.operationalRange);
+                access(member)->unit_ = image_.text(memberRecord.unit);
+                access(member)->slotIdentifier_ = image_.text(memberRecord.slotIdentifier);
+                access(member)->slotName_ = image_.text(memberRecord.slotName);
+                access(member)->type_ = image_.text(memberRecord.type);
+                access(member)->bitOffset_ = memberRecord.bitOffset;
+                access(member)->bitLengthMin_ = memberRecord.bitLengthMin;
+                access(member)->bitLengthMax_ = memberRecord.bitLengthMax;
+                access(member)->scale_ = memberRecord.scale;
+                access(member)->offset_ = memberRecord.offset;
+                access(member)->max_ = memberRecord.max;
+                access(entry)->members_.append(member);
+            }
+
+            return entry;
+        }
+
+        Image image_;
+        const MessageRecord *records_;
+        uint32_t count_;
+        mutable SpinLock cacheLock_;
+        mutable Map<uint32_t, MessageTypeInfo> cache_;
+    };
+};
+
+class CompiledSubsystemDictionary final: public SubsystemDictionary
+{
+public:
+    explicit CompiledSubsystemDictionary(const Image &image):
+        SubsystemDictionary{new State{image}}
+    {}
+
+private:
+    struct State final: public SubsystemDictionary::State
+    {
+        explicit State(const Image &image):
+            image_{image},
+            records_{image.table<SubsystemRecord>(image.header().subsystems)},
+            count_{image.header().subsystems.count}
+        {}
+
+        bool lookup(int industry, int subsystem, Out<SubsystemInfo> info) const override
+        {
+            auto [first, last] = std::equal_range(
+                records_, records_ + count_, Key{industry, subsystem},
+                [](const auto &a, const auto &b) { return key(a) < key(b); }
+            );
+            if (first == last) return false;
+
+            SubsystemInfo result{image_.text(first->subsystemName)};
+            for (const SubsystemRecord *record = first; record != last; ++record) {
+                access(result)->functionInfos_.insert(record->function, decode(*record));
+            }
+            info = result;
+            return true;
+        }
+
+        const Map<Key, SubsystemInfo> &subsystemInfos() const override
+        {
+            Guard<SpinLock> guard{loadLock_};
+            if (!loaded_) {
+                for (uint32_t i = 0; i < count_; ++i) {
+                    const SubsystemRecord &record = records_[i];
+                    Key key{record.industry, record.subsystem};
+                    SubsystemInfo subsystemInfo;
+                    if (!subsystemInfos_.lookup(key, &subsystemInfo)) {
+                        subsystemInfo = SubsystemInfo{image_.text(record.subsystemName)};
+                        subsystemInfos_.insert(key, subsystemInfo);
+                    }
+                    access(subsystemInfo)->functionInfos_.insert(record.function, decode(record));
+                }
+                loaded_ = true;
+            }
+            return subsystemInfos_;
+        }
+
+        FunctionInfo decode(const SubsystemRecord &record) const
+        {
+            return FunctionInfo{image_.text(record.functionName), image_.text(record.functionNotes)};
+        }
+
+        static Key key(const Key &key) { return key; }
+        static Key key(const SubsystemRecord &record) { return Key{record.industry, record.subsystem}; }
+
+        Image image_;
+        const SubsystemRecord *records_;
+        uint32_t count_;
+        mutable SpinLock loadLock_;
+        mutable bool loaded_ { false };
+        mutable Map<Key, SubsystemInfo> subsystemInfos_;
+    };
+};
+
+class CompiledVendorDictionary final: public VendorDictionary
+{
+public:
+    explicit CompiledVendorDictionary(const Image &image):
+        VendorDictionary{new State{image}}
+    {}
+
+private:
+    struct State final: public VendorDictionary::State
+    {
+        explicit State(const Image &image):
+            image_{image},
+            records_{image.table<VendorRecord>(image.header().vendors)},
+            count_{image.header().vendors.count}
+        {}
+
+        bool lookup(uint32_t vendorId, Out<VendorInfo> vendor) const override
+        {
+            const VendorRecord *record = std::lower_bound(
+                records_, records_ + count_, vendorId,
+                [](const VendorRecord &record, uint32_t vendorId) { return record.vendorId < vendorId; }
+            );
+            if (record == records_ + count_ || record->vendorId != vendorId) return false;
+            vendor = decode(*record);
+            return true;
+        }
+
+        Map<uint32_t, VendorInfo> vendors() const override
+        {
+            Map<uint32_t, VendorInfo> vendors;
+            for (uint32_t i = 0; i < count_; ++i) {
+                vendors.insert(records_[i].vendorId, decode(records_[i]));
+            }
+            return vendors;
+        }
+
+        VendorInfo decode(const VendorRecord &record) const
+        {
+            return VendorInfo{image_.text(record.name), image_.text(record.location)};
+        }
+
+        Image image_;
+        const VendorRecord *records_;
+        uint32_t count_;
+    };
+};
+
+class CompiledIndustryDictionary final: public IndustryDictionary
+{
+public:
+    explicit CompiledIndustryDictionary(const Image &image):
+        IndustryDictionary{new State{image}}
+    {}
+
+private:
+    struct State final: public IndustryDictionary::State
+    {
+        explicit State(const Image &image):
+            image_{image},
+            records_{image.table<IndustryRecord>(image.header().industries)},
+            count_{image.header().industries.count}
+        {}
+
+        bool lookup(int industry, Out<IndustryInfo> info) const override
+        {
+            const IndustryRecord *record = std::lower_bound(
+                records_, records_ + count_, industry,
+                [](const IndustryRecord &record, int industry) { return record.industry < industry; }
+            );
+            if (record == records_ + count_ || record->industry != industry) return false;
+            info = IndustryInfo{image_.text(record->name)};
+            return true;
+        }
+
+        const Map<int, IndustryInfo> &industryInfos() const override
+        {
+            Guard<SpinLock> guard{loadLock_};
+            if (!loaded_) {
+                for (uint32_t i = 0; i < count_; ++i) {
+                    industryInfos_.insert(records_[i].industry, IndustryInfo{image_.text(records_[i].name)});
+                }
+                loaded_ = true;
+            }
+            return industryInfos_;
+        }
+
+        Image image_;
+        const IndustryRecord *records_;
+        uint32_t count_;
+        mutable SpinLock loadLock_;
+        mutable bool loaded_ { false };
+        mutable Map<int, IndustryInfo> industryInfos_;
+    };
+};
+
+template<class T>
+void place(InOut<long> offset, Out<TableRef> ref, const List<T> &records)
+{
+    TableRef result { static_cast<uint32_t>(offset), static_cast<uint32_t>(records.count()) };
+    ref = result;
+    offset = offset + records.count() * static_cast<long>(sizeof(T));
+}
+
+template<class T>
+void copy(String &image, const TableRef &ref, const List<T> &records)
+{
+    char *dst = image.chars() + ref.offset;
+    for (const T &record: records) {
+        std::memcpy(dst, &record, sizeof(T));
+        dst += sizeof(T);
+    }
+}
+
+} // namespace
+
+struct CompiledDictionary::State final: public Object::State
+{
+    explicit State(const Image &image):
+        messageTypeDictionary_{CompiledMessageDictionary{image}},
+        subsystemDictionary_{CompiledSubsystemDictionary{image}},
+        vendorDictionary_{CompiledVendorDictionary{image}},
+        industryDictionary_{CompiledIndustryDictionary{image}}
+    {}
+
+    MessageDictionary messageTypeDictionary_;
+    SubsystemDictionary subsystemDictionary_;
+    VendorDictionary vendorDictionary_;
+    IndustryDictionary industryDictionary_;
+};
+
+bool CompiledDictionary::open(const String &path, const List<String> &sourcePaths, Out<CompiledDictionary> dictionary)
+{
+    FileInfo info{path};
+    if (!info || info.size() < static_cast<long long>(sizeof(ImageHeader))) return false;
+
+    Image image{File{path}.map()};
+    if (!image.isValid() || !image.isUpToDate(sourcePaths)) return false;
+
+    dictionary = CompiledDictionary{new State{image}};
+    return true;
+}
+
+void CompiledDictionary::compile(
+    const String &path,
+    const List<String> &sourcePaths,
+    const MessageDictionary &messageTypes,
+    const SubsystemDictionary &subsystems,
+    const VendorDictionary &vendors,
+    const IndustryDictionary &industries)
+{
+    StringPool text;
+
+    List<SourceRecord> sourceRecords;
+    for (const String &sourcePath: sourcePaths) {
+        sourceRecords.append(stamp(sourcePath));
+    }
+
+    List<MessageRecord> messageRecords;
+    List<MemberRecord> memberRecords;
+    for (const auto &pair: messageTypes.messageTypes()) {
+        const MessageTypeInfo &entry = pair.value();
+        MessageRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.pgn = pair.key();
+        record.defaultPriority = entry.defaultPriority();
+        record.isMultiPacket = entry.isMultiPacket();
+        record.firstMember = static_cast<uint32_t>(memberRecords.count());
+        record.memberCount = static_cast<uint32_t>(entry.members().count());
+        record.name = text(entry.name());
+        record.label = text(entry.label());
+        record.description = text(entry.description());
+        record.notes = text(entry.notes());
+        record.transmissionRate = text(entry.transmissionRate());
+        record.document = text(entry.document());
+        messageRecords.append(record);
+
+        for (const MessageMemberInfo &member: entry.members()) {
+            MemberRecord memberRecord;
+            std::memset(&memberRecord, 0, sizeof(memberRecord));
+            memberRecord.name = text(member.name());
+            memberRecord.description = text(member.description());
+            memberRecord.notes = text(member.notes());
+            memberRecord.dataRange = text(member.dataRange());
+            memberRecord.operationalRange = text(member.operationalRange());
+            memberRecord.unit = text(member.unit());
+            memberRecord.slotIdentifier = text(member.slotIndentifier());
+            memberRecord.slotName = text(member.slotName());
+            memberRecord.type = text(member.type());
+            memberRecord.bitOffset = member.bitOffset();
+            memberRecord.bitLengthMin = member.bitLengthMin();
+            memberRecord.bitLengthMax = member.bitLengthMax();
+            memberRecord.scale = member.scale();
+            memberRecord.offset = member.offset();
+            memberRecord.max = member.max();
+            memberRecords.append(memberRecord);
+        }
+    }
+
+    List<SubsystemRecord> subsystemRecords;
+    for (const auto &pair: subsystems.subsystemInfos()) {
+        const SubsystemInfo &subsystemInfo = pair.value();
+        for (const auto &function: subsystemInfo.functionInfos()) {
+            SubsystemRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.industry = std::get<0>(pair.key());
+            record.subsystem = std::get<1>(pair.key());
+            record.function = function.key();
+            record.subsystemName = text(subsystemInfo.name());
+            record.functionName = text(function.value().name());
+            record.functionNotes = text(function.value().notes());
+            subsystemRecords.append(record);
+        }
+    }
+
+    List<VendorRecord> vendorRecords;
+    for (const auto &pair: vendors.vendors()) {
+        VendorRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.vendorId = pair.key();
+        record.name = text(pair.value().name());
+        record.location = text(pair.value().location());
+        vendorRecords.append(record);
+    }
+
+    List<IndustryRecord> industryRecords;
+    for (const auto &pair: industries.industryInfos()) {
+        IndustryRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.industry = pair.key();
+        record.name = text(pair.value().name());
+        industryRecords.append(record);
+    }
+
+    ImageHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = ImageHeader::Magic;
+    header.version = ImageHeader::Version;
+
+    long offset = sizeof(ImageHeader);
+    place(&offset, &header.sources, sourceRecords);
+    place(&offset, &header.messages, messageRecords);
+    place(&offset, &header.members, memberRecords);
+    place(&offset, &header.subsystems, subsystemRecords);
+    place(&offset, &header.vendors, vendorRecords);
+    place(&offset, &header.industries, industryRecords);
+    header.strings = TableRef{static_cast<uint32_t>(offset), static_cast<uint32_t>(text.size())};
+    header.size = static_cast<uint32_t>(offset + text.size());
+
+    String image = String::allocate(header.size, '\0');
+    std::memcpy(image.chars(), &header, sizeof(header));
+    copy(image, header.sources, sourceRecords);
+    copy(image, header.messages, messageRecords);
+    copy(image, header.members, memberRecords);
+    copy(image, header.subsystems, subsystemRecords);
+    copy(image, header.vendors, vendorRecords);
+    copy(image, header.industries, industryRecords);
+    text.copyTo(image.chars() + header.strings.offset);
+
+    String tempPath = File::createUnique(path + ".########");
+    try {
+        File::save(tempPath, image);
+        File::rename(tempPath, path);
+    }
+    catch (...) {
+        File::unlink(tempPath);
+        throw;
+    }
+}
+
+CompiledDictionary::CompiledDictionary(State *newState):
+    Object{newState}
+{}
+
+MessageDictionary CompiledDictionary::messageTypeDictionary() const
+{
+    return me().messageTypeDictionary_;
+}
+
+SubsystemDictionary CompiledDictionary::subsystemDictionary() const
+{
+    return me().subsystemDictionary_;
+}
+
+VendorDictionary CompiledDictionary::vendorDictionary() const
+{
+    return me().vendorDictionary_;
+}
+
+IndustryDictionary CompiledDictionary::industryDictionary() const
+{
+    return me().industryDictionary_;
+}
+
+const CompiledDictionary::State &CompiledDictionary::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc::j1939
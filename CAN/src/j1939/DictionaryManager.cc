@@ -7,6 +7,7 @@
  */
 
 #include <cc/j1939/DictionaryManager>
+#include <cc/j1939/CompiledDictionary>
 #include <cc/isobus/CsvMessageDictionary>
 #include <cc/isobus/CsvSubsystemDictionary>
 #include <cc/isobus/CsvVendorDictionary>
@@ -24,12 +25,40 @@ struct DictionaryManager::State final: public Singleton::State
         messageTypesCsvPath_{dataPath_ / "messages.csv"},
         subsystemsCsvPath_{dataPath_ / "subsystems.csv"},
         vendorsCsvPath_{dataPath_ / "vendors.csv"},
-        industriesCsvPath_{dataPath_ / "industries.csv"}
+        industriesCsvPath_{dataPath_ / "industries.csv"},
+        compiledDictionaryPath_{dataPath_ / "dictionary.bin"}
     {
+        const List<String> sourcePaths {
+            messageTypesCsvPath_,
+            subsystemsCsvPath_,
+            vendorsCsvPath_,
+            industriesCsvPath_
+        };
+
+        CompiledDictionary compiled;
+        if (CompiledDictionary::open(compiledDictionaryPath_, sourcePaths, &compiled)) {
+            messageTypeDictionary_ = compiled.messageTypeDictionary();
+            subsystemDictionary_ = compiled.subsystemDictionary();
+            vendorDictionary_ = compiled.vendorDictionary();
+            industryDictionary_ = compiled.industryDictionary();
+            return;
+        }
+
         messageTypeDictionary_ = isobus::CsvMessageDictionary{File{messageTypesCsvPath_}.map()};
         subsystemDictionary_ = isobus::CsvSubsystemDictionary{File{subsystemsCsvPath_}.map()};
         vendorDictionary_ = isobus::CsvVendorDictionary{File{vendorsCsvPath_}.map()};
         industryDictionary_ = isobus::CsvIndustryDictionary{File{industriesCsvPath_}.map()};
+
+        try {
+            CompiledDictionary::compile(
+                compiledDictionaryPath_, sourcePaths,
+                messageTypeDictionary_, subsystemDictionary_, vendorDictionary_, industryDictionary_
+            );
+        }
+        catch (Exception &)
+        {
+            // the data directory might not be writable, keep working with the CSV tables
+        }
     }
 
     String dataPath_;
@@ -37,6 +66,7 @@ struct DictionaryManager::State final: public Singleton::State
     String subsystemsCsvPath_;
     String vendorsCsvPath_;
     String industriesCsvPath_;
+    String compiledDictionaryPath_;
     MessageDictionary messageTypeDictionary_;
     SubsystemDictionary subsystemDictionary_;
     VendorDictionary vendorDictionary_;
@@ -67,9 +67,25 @@ struct MessageProcessor::State final: public Object::State
         }
     }
 
+    List<CanFilter> filters() const
+    {
+        List<CanFilter> filters;
+        if (src_.count() == 0) return filters;
+        if (src_.count() == 0x100) {
+            filters.append(CanFilter{CanFilter::EffFlag, CanFilter::EffFlag});
+        }
+        else {
+            for (uint8_t address: src_) {
+                filters.append(CanFilter{CanFilter::EffFlag | (uint32_t{address} << 8), CanFilter::EffFlag | 0xFF00u});
+            }
+        }
+        return filters;
+    }
+
     void start()
     {
         if (!started()) {
+            media_.filter(filters());
             thread_ = Thread{[this]{ run(); }};
             thread_.start();
         }
@@ -240,6 +256,11 @@ MessageProcessor &MessageProcessor::error(Function<void(uint32_t pgn, uint8_t sr
     return *this;
 }
 
+List<CanFilter> MessageProcessor::filters() const
+{
+    return me().filters();
+}
+
 MessageProcessor &MessageProcessor::start()
 {
     assert(!started());
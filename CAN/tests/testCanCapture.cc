@@ -0,0 +1,146 @@
+#include <cc/CanCaptureWriter>
+#include <cc/CanCaptureMedia>
+#include <cc/File>
+#include <cc/System>
+#include <cc/testing>
+#include <cmath>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    TestCase {
+        "WriteReadSeek",
+        []{
+            String path = File::createTemp();
+
+            const long n = 3000;
+            {
+                CanCaptureWriter capture{path};
+                for (long i = 0; i < n; ++i) {
+                    CanFrame frame{static_cast<uint32_t>(i % 0x800)};
+                    frame.size(i % 9);
+                    for (int j = 0; j < frame.size(); ++j) frame[j] = i + j;
+                    frame.timestamp(1000 + i * 0.001);
+                    capture.write(frame);
+                }
+                CC_CHECK(capture.count() == n);
+                capture.close();
+            }
+
+            CanCaptureMedia media{path, 0};
+            CC_CHECK(media.count() == n);
+            CC_CHECK(std::abs(media.startTime() - 1000) < 1e-6);
+            CC_CHECK(std::abs(media.endTime() - (1000 + (n - 1) * 0.001)) < 1e-6);
+
+            Array<CanFrame> frames = Array<CanFrame>::allocate(64);
+            long total = 0;
+            bool ok = true;
+            for (long m = 0; (m = media.readBatch(frames)) > 0; total += m) {
+                for (long i = 0; i < m; ++i) {
+                    const CanFrame &frame = frames[i];
+                    long k = total + i;
+                    ok = ok && frame.canId() == static_cast<uint32_t>(k % 0x800) && frame.size() == k % 9;
+                    for (int j = 0; j < frame.size(); ++j) ok = ok && frame[j] == static_cast<uint8_t>(k + j);
+                }
+            }
+            CC_CHECK(ok);
+            CC_CHECK(total == n);
+
+            media.seek(1000 + 2.5);
+            CanFrame frame;
+            CC_VERIFY(media.read(&frame));
+            CC_INSPECT(frame.timestamp());
+            CC_CHECK(frame.canId() == 2500 % 0x800);
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "RecoverUnclosedCapture",
+        []{
+            String path = File::createTemp();
+
+            CanCaptureWriter capture{path};
+            for (long i = 0; i < 1500; ++i) {
+                CanFrame frame{0x100};
+                frame.timestamp(1 + i);
+                capture.write(frame);
+            }
+            capture.flush();
+
+            CanCaptureMedia media{path, 0};
+            CC_CHECK(media.count() == 1500);
+            media.seek(1200);
+            CanFrame frame;
+            CC_VERIFY(media.read(&frame));
+            CC_CHECK(frame.timestamp() == 1200);
+
+            capture.close();
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "ScaledReplay",
+        []{
+            String path = File::createTemp();
+            {
+                CanCaptureWriter capture{path};
+                for (int i = 0; i < 5; ++i) {
+                    CanFrame frame{0x200u + i};
+                    frame.timestamp(10 + i * 0.1);
+                    capture.write(frame);
+                }
+            }
+
+            CanCaptureMedia media{path, 4};
+            double t0 = System::now();
+            long n = 0;
+            for (CanFrame frame; media.read(&frame);) ++n;
+            double dt = System::now() - t0;
+            CC_INSPECT(dt);
+            CC_CHECK(n == 5);
+            CC_CHECK(0.09 < dt && dt < 0.5);
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "ImportText",
+        []{
+            String path = File::createTemp();
+            {
+                CanCaptureWriter capture{path};
+                capture.importText(
+                    "123 [2] 01 02 0\n"
+                    "18EA2080 [3] 00 EE 00 250\n",
+                    100
+                );
+                capture.importText(
+                    "  5.000   0.000 -- 0AB [1] 7F |.|\n"
+                    "  some annotation\n",
+                    100
+                );
+                CC_CHECK(capture.count() == 3);
+            }
+
+            CanCaptureMedia media{path, 0};
+            CanFrame frame;
+            CC_VERIFY(media.read(&frame));
+            CC_CHECK(frame.canId() == 0x123 && frame.size() == 2 && frame.timestamp() == 100);
+            CC_VERIFY(media.read(&frame));
+            CC_CHECK(frame.eff() && (frame.canId() & CanFilter::EffMask) == 0x18EA2080);
+            CC_CHECK(frame.timestamp() == 100.25);
+            CC_VERIFY(media.read(&frame));
+            CC_CHECK(frame.canId() == 0xAB && frame[0] == 0x7F && frame.timestamp() == 105);
+            CC_CHECK(!media.read(&frame));
+
+            File::unlink(path);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
@@ -1,4 +1,6 @@
 #include <cc/VirtualCanBus>
+#include <cc/CanError>
+#include <cc/j1939/MessageProcessor>
 #include <cc/Thread>
 #include <cc/Semaphore>
 #include <cc/testing>
@@ -38,5 +40,128 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "ReadBatch",
+        []{
+            VirtualCanBus bus;
+
+            auto bus1 = bus.connect();
+            auto bus2 = bus.connect();
+
+            for (int i = 0; i < 10; ++i) {
+                bus1.write(CanFrame{0x100u + i});
+            }
+
+            Array<CanFrame> frames = Array<CanFrame>::allocate(4);
+            long total = 0;
+            while (total < 10) {
+                long n = bus2.readBatch(frames);
+                CC_INSPECT(n);
+                CC_VERIFY(0 < n && n <= frames.count());
+                for (long i = 0; i < n; ++i) {
+                    CC_VERIFY(frames[i].canId() == 0x100u + total + i);
+                }
+                total += n;
+            }
+            CC_CHECK(total == 10);
+
+            bus.shutdown();
+
+            CC_CHECK(bus2.readBatch(frames) == 0);
+        }
+    };
+
+    TestCase {
+        "Filter",
+        []{
+            VirtualCanBus bus;
+
+            auto bus1 = bus.connect();
+            auto bus2 = bus.connect();
+
+            bus2.filter(List<CanFilter>{CanFilter::standard(0x100, 0x7F0)});
+
+            bus1.write(CanFrame{0x0FF});
+            bus1.write(CanFrame{0x105});
+            bus1.write(CanFrame{0x105}.eff(true));
+            bus1.write(CanFrame{0x110});
+            bus1.write(CanFrame{0x10A});
+
+            CanFrame frame;
+            CC_VERIFY(bus2.read(&frame));
+            CC_CHECK(frame.canId() == 0x105);
+            CC_VERIFY(bus2.read(&frame));
+            CC_CHECK(frame.canId() == 0x10A);
+            CC_CHECK(!bus2.wait(10));
+
+            bus2.filter(List<CanFilter>{});
+            bus1.write(CanFrame{0x0FF});
+            CC_VERIFY(bus2.read(&frame));
+            CC_CHECK(frame.canId() == 0x0FF);
+
+            bus.shutdown();
+        }
+    };
+
+    TestCase {
+        "J1939Filter",
+        []{
+            VirtualCanBus bus;
+
+            j1939::MessageProcessor processor{bus.connect()};
+            processor.src(Set<uint8_t>{0x20, 0xFF});
+
+            List<CanFilter> filters = processor.filters();
+            CC_CHECK(filters.count() == 2);
+
+            auto accepts = [&](const CanFrame &frame) {
+                for (const CanFilter &filter: filters) {
+                    if (filter.matches(frame)) return true;
+                }
+                return false;
+            };
+
+            CC_CHECK(accepts(CanFrame{0x18EA2080}.eff(true)));
+            CC_CHECK(accepts(CanFrame{0x18EAFF80}.eff(true)));
+            CC_CHECK(!accepts(CanFrame{0x18EA2180}.eff(true)));
+            CC_CHECK(!accepts(CanFrame{0x20}));
+
+            bus.shutdown();
+        }
+    };
+
+    TestCase {
+        "Overrun",
+        []{
+            VirtualCanBus bus{16};
+
+            auto bus1 = bus.connect();
+            auto bus2 = bus.connect();
+
+            for (int i = 0; i < 100; ++i) {
+                bus1.write(CanFrame{0x100u + i});
+            }
+            bus.shutdown();
+
+            CanFrame frame;
+            CC_VERIFY(bus2.read(&frame));
+            CC_VERIFY(CanError{frame}.isValid());
+            CC_CHECK(CanError{frame}.type() == CanError::Type::ControllerError);
+            CC_CHECK(CanError{frame}.controller() == CanError::Controller::RxOverflow);
+
+            long n = 0;
+            uint32_t lastId = 0;
+            while (bus2.read(&frame)) {
+                CC_VERIFY(!frame.err());
+                CC_VERIFY(lastId == 0 || frame.canId() == lastId + 1);
+                lastId = frame.canId();
+                ++n;
+            }
+            CC_INSPECT(n);
+            CC_CHECK(0 < n && n <= 16);
+            CC_CHECK(lastId == 0x100u + 99);
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,133 @@
+#include <cc/j1939/CompiledDictionary>
+#include <cc/isobus/CsvMessageDictionary>
+#include <cc/isobus/CsvSubsystemDictionary>
+#include <cc/isobus/CsvVendorDictionary>
+#include <cc/isobus/CsvIndustryDictionary>
+#include <cc/File>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+    using namespace cc::j1939;
+
+    const String messagesCsv =
+        "pgn,edp,dp,acronym,parameter_group_label,pgn_description,multipacket,default_priority,spn_name,sp_start_bit,length_min,length_max,units,scale_factor,offset_value\n"
+        "61444,0,0,EEC1,Electronic Engine Controller 1,Engine related parameters,No,3,Engine Speed,4.1,16,16,rpm,0.125,0\n"
+        "61444,0,0,EEC1,Electronic Engine Controller 1,Engine related parameters,No,3,Source Address,8.1,8,8,,1,0\n"
+        "65262,0,0,ET1,Engine Temperature 1,,No,6,Engine Coolant Temperature,1.1,8,8,deg C,1,-40\n";
+
+    const String subsystemsCsv =
+        "industry_group_id,vehicle_system_id,vehicle_system_description,function_id,function_description,notes\n"
+        "2,0,Non-specific System,128,Tractor ECU,\n"
+        "2,0,Non-specific System,129,Tractor Display,Virtual terminal\n"
+        "2,1,Tractor,0,Engine,\n";
+
+    const String vendorsCsv =
+        "value,manufacturer,location\n"
+        "69,Deere & Company,USA\n"
+        "111,CLAAS,Germany\n";
+
+    const String industriesCsv =
+        "industry_group_id,industry_group_description\n"
+        "0,Global\n"
+        "2,Agricultural and Forestry Equipment\n";
+
+    TestCase {
+        "CompileAndOpen",
+        [=]{
+            List<String> sourcePaths;
+            for (const String &data: List<String>{ messagesCsv, subsystemsCsv, vendorsCsv, industriesCsv }) {
+                String path = File::createTemp();
+                File::save(path, data);
+                sourcePaths.append(path);
+            }
+            String path = File::createTemp();
+
+            CompiledDictionary::compile(
+                path, sourcePaths,
+                isobus::CsvMessageDictionary{messagesCsv},
+                isobus::CsvSubsystemDictionary{subsystemsCsv},
+                isobus::CsvVendorDictionary{vendorsCsv},
+                isobus::CsvIndustryDictionary{industriesCsv}
+            );
+
+            CompiledDictionary dictionary;
+            CC_VERIFY(CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            MessageTypeInfo messageType;
+            CC_VERIFY(dictionary.messageTypeDictionary().lookup(0x0CF00400u, &messageType));
+            CC_CHECK(messageType.name() == "EEC1");
+            CC_CHECK(messageType.defaultPriority() == 3);
+            CC_VERIFY(messageType.members().count() == 2);
+            CC_CHECK(messageType.members().at(0).name() == "Engine Speed");
+            CC_CHECK(messageType.members().at(0).bitOffset() == 24);
+            CC_CHECK(messageType.members().at(0).scale() == 0.125);
+            CC_CHECK(messageType.members().at(1).bitOffset() == 56);
+            CC_CHECK(!dictionary.messageTypeDictionary().lookup(0x18EA0000u, &messageType));
+            CC_CHECK(dictionary.messageTypeDictionary().messageTypes().count() == 2);
+
+            SubsystemInfo subsystemInfo;
+            CC_VERIFY(dictionary.subsystemDictionary().lookup(2, 0, &subsystemInfo));
+            CC_CHECK(subsystemInfo.name() == "Non-specific System");
+            CC_CHECK(subsystemInfo.functionInfos().count() == 2);
+            CC_CHECK(subsystemInfo.functionInfos().value(129).notes() == "Virtual terminal");
+            CC_CHECK(!dictionary.subsystemDictionary().lookup(2, 7, &subsystemInfo));
+            CC_CHECK(dictionary.subsystemDictionary().subsystemInfos().count() == 2);
+
+            VendorInfo vendorInfo;
+            CC_VERIFY(dictionary.vendorDictionary().lookup(111, &vendorInfo));
+            CC_CHECK(vendorInfo.name() == "CLAAS" && vendorInfo.location() == "Germany");
+            CC_CHECK(dictionary.vendorDictionary().vendors().count() == 2);
+
+            IndustryInfo industryInfo{""};
+            CC_VERIFY(dictionary.industryDictionary().lookup(2, &industryInfo));
+            CC_CHECK(industryInfo.name() == "Agricultural and Forestry Equipment");
+            CC_CHECK(dictionary.industryDictionary().industryInfos().count() == 2);
+
+            for (const String &sourcePath: sourcePaths) File::unlink(sourcePath);
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "RejectOutdated",
+        [=]{
+            List<String> sourcePaths;
+            for (const String &data: List<String>{ messagesCsv, subsystemsCsv, vendorsCsv, industriesCsv }) {
+                String path = File::createTemp();
+                File::save(path, data);
+                sourcePaths.append(path);
+            }
+            String path = File::createTemp();
+
+            CompiledDictionary dictionary;
+            CC_CHECK(!CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            CompiledDictionary::compile(
+                path, sourcePaths,
+                isobus::CsvMessageDictionary{messagesCsv},
+                isobus::CsvSubsystemDictionary{subsystemsCsv},
+                isobus::CsvVendorDictionary{vendorsCsv},
+                isobus::CsvIndustryDictionary{industriesCsv}
+            );
+            CC_CHECK(CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            File::save(sourcePaths.at(2), vendorsCsv + "1234,Acme,Nowhere\n");
+            CC_CHECK(!CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            File::unlink(sourcePaths.at(2));
+            CC_CHECK(CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            File::save(path, "CCJ1939D");
+            CC_CHECK(!CompiledDictionary::open(path, sourcePaths, &dictionary));
+
+            for (const String &sourcePath: sourcePaths) {
+                if (File::exists(sourcePath)) File::unlink(sourcePath);
+            }
+            File::unlink(path);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
@@ -0,0 +1,120 @@
+#include <cc/j1939/CompiledDictionary>
+#include <cc/isobus/CsvMessageDictionary>
+#include <cc/isobus/CsvSubsystemDictionary>
+#include <cc/isobus/CsvVendorDictionary>
+#include <cc/isobus/CsvIndustryDictionary>
+#include <cc/FileInfo>
+#include <cc/File>
+#include <cc/Format>
+#include <cc/System>
+#include <cc/stdio>
+
+using namespace cc;
+using namespace cc::j1939;
+
+/** Generate CSV tables of roughly the size of the isobus.net exports
+  */
+List<String> generateTables()
+{
+    List<String> parts;
+
+    parts.append(
+        "pgn,edp,dp,acronym,parameter_group_label,pgn_description,pgn_notes,multipacket,transmission_rate,default_priority,pgn_document,"
+        "spn_name,sp_start_bit,length_min,length_max,spn_description,spn_notes,data_range,operational_range,units,"
+        "scale_factor,offset_value,range_maximum,slot_identifier,slot_name,spn_type\n"
+    );
+    for (int i = 0; i < 2000; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            parts.append(
+                Format{"%%,0,0,PG%%,Parameter Group %%,Description of parameter group %% with some more text,,No,100 ms,6,J1939DA,"}
+                    << 0xF000 + i << i << i << i
+            );
+            parts.append(
+                Format{"Parameter %%.%%,%%.1,8,8,Description of parameter %% of parameter group %%,,0 to 250,0 to 250,km/h,0.5,0,125,SLOT%%,SAEvl08,Measured\n"}
+                    << i << j << j + 1 << j << i << j
+            );
+        }
+    }
+    String messages{parts};
+
+    parts = List<String>{};
+    parts.append("industry_group_id,vehicle_system_id,vehicle_system_description,function_id,function_description,notes\n");
+    for (int industry = 0; industry < 6; ++industry) {
+        for (int subsystem = 0; subsystem < 32; ++subsystem) {
+            for (int function = 128; function < 160; ++function) {
+                parts.append(
+                    Format{"%%,%%,Vehicle System %%,%%,Function %%,\n"}
+                        << industry << subsystem << subsystem << function << function
+                );
+            }
+        }
+    }
+    String subsystems{parts};
+
+    parts = List<String>{};
+    parts.append("value,manufacturer,location\n");
+    for (int i = 0; i < 1500; ++i) {
+        parts.append(Format{"%%,Manufacturer %%,Location %%\n"} << i << i << i % 50);
+    }
+    String vendors{parts};
+
+    parts = List<String>{};
+    parts.append("industry_group_id,industry_group_description\n");
+    for (int i = 0; i < 8; ++i) {
+        parts.append(Format{"%%,Industry Group %%\n"} << i << i);
+    }
+    String industries{parts};
+
+    return List<String>{ messages, subsystems, vendors, industries };
+}
+
+int main(int argc, char *argv[])
+{
+    const int repeat = argc > 1 ? String{argv[1]}.toInt() : 10;
+
+    List<String> sourcePaths;
+    for (const String &data: generateTables()) {
+        String path = File::createTemp();
+        File::save(path, data);
+        sourcePaths.append(path);
+    }
+    String compiledPath = File::createTemp();
+
+    double csvTime = 0;
+    for (int i = 0; i < repeat; ++i) {
+        double t = System::now();
+        isobus::CsvMessageDictionary messages{File{sourcePaths.at(0)}.map()};
+        isobus::CsvSubsystemDictionary subsystems{File{sourcePaths.at(1)}.map()};
+        isobus::CsvVendorDictionary vendors{File{sourcePaths.at(2)}.map()};
+        isobus::CsvIndustryDictionary industries{File{sourcePaths.at(3)}.map()};
+        csvTime += System::now() - t;
+
+        if (i == 0) {
+            t = System::now();
+            CompiledDictionary::compile(compiledPath, sourcePaths, messages, subsystems, vendors, industries);
+            fout("compile:\t%% ms\n") << (System::now() - t) * 1000;
+        }
+    }
+
+    double compiledTime = 0;
+    for (int i = 0; i < repeat; ++i) {
+        double t = System::now();
+        CompiledDictionary dictionary;
+        if (!CompiledDictionary::open(compiledPath, sourcePaths, &dictionary)) {
+            ferr("Failed to open compiled dictionary\n");
+            return 1;
+        }
+        MessageTypeInfo messageType;
+        dictionary.messageTypeDictionary().lookup(0x18F00000u, &messageType);
+        compiledTime += System::now() - t;
+    }
+
+    fout("CSV startup:\t%% ms\n") << csvTime / repeat * 1000;
+    fout("compiled startup:\t%% ms\n") << compiledTime / repeat * 1000;
+    fout("compiled size:\t%% bytes\n") << FileInfo{compiledPath}.size();
+
+    for (const String &path: sourcePaths) File::unlink(path);
+    File::unlink(compiledPath);
+
+    return 0;
+}
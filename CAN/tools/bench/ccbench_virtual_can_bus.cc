@@ -0,0 +1,71 @@
+#include <cc/VirtualCanBus>
+#include <cc/CanError>
+#include <cc/Thread>
+#include <cc/System>
+#include <cc/stdio>
+#include <atomic>
+
+using namespace cc;
+
+struct Result {
+    double dt;
+    long delivered;
+    long overflows;
+};
+
+Result benchmark(int feeds, long count)
+{
+    VirtualCanBus bus;
+    CanMedia sender = bus.connect();
+
+    std::atomic<long> delivered { 0 };
+    std::atomic<long> overflows { 0 };
+
+    List<Thread> receivers;
+    for (int i = 1; i < feeds; ++i) {
+        CanMedia media = bus.connect();
+        receivers.append(Thread{[media, &delivered, &overflows]() mutable {
+            Array<CanFrame> frames = Array<CanFrame>::allocate(64);
+            long n = 0, m = 0, k = 0;
+            while ((m = media.readBatch(frames)) > 0) {
+                for (long j = 0; j < m; ++j) {
+                    if (CanError{frames[j]}) ++k;
+                    else ++n;
+                }
+            }
+            delivered += n;
+            overflows += k;
+        }});
+    }
+    for (Thread &receiver: receivers) receiver.start();
+
+    double dt = System::now();
+    CanFrame frame{0x123};
+    for (long i = 0; i < count; ++i) {
+        frame[0] = static_cast<uint8_t>(i);
+        sender.write(frame);
+    }
+    bus.shutdown();
+    for (Thread &receiver: receivers) receiver.wait();
+    dt = System::now() - dt;
+
+    return Result{dt, delivered, overflows};
+}
+
+int main(int argc, char *argv[])
+{
+    const long count = argc > 1 ? String{argv[1]}.toLong() : 1000000;
+
+    for (int feeds: { 2, 16, 64 }) {
+        Result result = benchmark(feeds, count);
+        fout(
+            "%% feeds\t%% frames/s written\t%% frames/s delivered\t%% overflows\n"
+        )
+            << feeds
+            << static_cast<long>(count / result.dt)
+            << static_cast<long>(result.delivered / result.dt)
+            << result.overflows;
+    }
+
+    return 0;
+}
@@ -7,43 +7,220 @@
  */
 
 #include <cc/Crc32Sink>
+#include <cc/CrcDispatch>
+#include <array>
+#include <bit>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
-static const std::uint32_t crcTable[] = {
-    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
-    0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
-    0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
-    0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
-    0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-    0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
-    0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
-    0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
-    0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
-    0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-    0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
-    0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
-    0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
-    0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
-    0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
-    0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
-    0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
-    0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
-    0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-    0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
-    0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
-    0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
-};
+namespace crc {
+
+static constexpr std::uint32_t Polynomial = 0xEDB88320; // reflected 0x04C11DB7
+
+/** Lookup tables for slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes
+  */
+static constexpr auto table = []{
+    std::array<std::array<std::uint32_t, 256>, 8> t {};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ Polynomial : c >> 1;
+        t[0][i] = c;
+    }
+    for (int i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+    }
+    return t;
+}();
+
+static std::uint32_t feedBytewise(std::uint32_t crc, const std::uint8_t *p, long n)
+{
+    for (long i = 0; i < n; ++i) {
+        crc = table[0][(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static std::uint32_t feedSliced(std::uint32_t crc, const std::uint8_t *p, long n)
+{
+    if (std::endian::native != std::endian::little) return feedBytewise(crc, p, n);
+
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint32_t one, two;
+        std::memcpy(&one, p, 4);
+        std::memcpy(&two, p + 4, 4);
+        one ^= crc;
+        crc =
+            table[7][one & 0xFF] ^
+            table[6][(one >> 8) & 0xFF] ^
+            table[5][(one >> 16) & 0xFF] ^
+            table[4][one >> 24] ^
+            table[3][two & 0xFF] ^
+            table[2][(two >> 8) & 0xFF] ^
+            table[1][(two >> 16) & 0xFF] ^
+            table[0][two >> 24];
+    }
+
+    return feedBytewise(crc, p, n);
+}
+
+#if defined __x86_64__ || defined __i386__
+
+static bool detectPclmul()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+
+bool usePclmul = detectPclmul();
+
+/** Fold \a n bytes into the \a crc by carry-less multiplication
+  * \note \a n must be a multiple of 16 and at least 64
+  * \see "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel, 2009
+  */
+__attribute__((target("pclmul,sse4.1")))
+static std::uint32_t feedFolded(std::uint32_t crc, const std::uint8_t *p, long n)
+{
+    alignas(16) static const std::uint64_t k1k2[] = { 0x0154442BD4, 0x01C6E41596 };
+    alignas(16) static const std::uint64_t k3k4[] = { 0x01751997D0, 0x00CCAA009E };
+    alignas(16) static const std::uint64_t k5k0[] = { 0x0163CD6124, 0x0000000000 };
+    alignas(16) static const std::uint64_t poly[] = { 0x01DB710641, 0x01F7011641 };
+
+    const __m128i *src = reinterpret_cast<const __m128i *>(p);
+
+    __m128i x1 = _mm_xor_si128(_mm_loadu_si128(src), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = _mm_loadu_si128(src + 1);
+    __m128i x3 = _mm_loadu_si128(src + 2);
+    __m128i x4 = _mm_loadu_si128(src + 3);
+    __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+    __m128i x5;
+
+    src += 4;
+    n -= 64;
+
+    // fold four lanes of 128 bits in parallel
+
+    for (; n >= 64; src += 4, n -= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(src));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(src + 1));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(src + 2));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(src + 3));
+    }
+
+    // fold the four lanes into a single one
+
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // fold the remaining blocks of 128 bits
+
+    for (; n >= 16; ++src, n -= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(src)), x5);
+    }
+
+    // reduce 128 bits to 64 bits
+
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#else
+
+bool usePclmul = false;
+
+#endif
+
+static std::uint32_t feed(std::uint32_t crc, const std::uint8_t *p, long n)
+{
+    #if defined __x86_64__ || defined __i386__
+    if (usePclmul && n >= 64) {
+        const long m = n & ~15L;
+        crc = feedFolded(crc, p, m);
+        p += m;
+        n -= m;
+    }
+    #endif
+
+    return feedSliced(crc, p, n);
+}
+
+/** Multiply \a a and \a b modulo the CRC polynomial (bit-reflected)
+  */
+static std::uint32_t multiply(std::uint32_t a, std::uint32_t b)
+{
+    std::uint32_t m = std::uint32_t(1) << 31;
+    std::uint32_t p = 0;
+    while (m != 0) {
+        if (a & m) p ^= b;
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ Polynomial : b >> 1;
+    }
+    return p;
+}
+
+/** Compute x^(8 n) modulo the CRC polynomial (bit-reflected)
+  */
+static std::uint32_t shiftFactor(long n)
+{
+    std::uint32_t p = std::uint32_t(1) << 31; // x^0
+    std::uint32_t q = std::uint32_t(1) << 23; // x^8
+    for (; n > 0; n >>= 1) {
+        if (n & 1) p = multiply(q, p);
+        q = multiply(q, q);
+    }
+    return p;
+}
+
+} // namespace crc
 
 struct Crc32Sink::State: public HashSink::State
 {
@@ -53,8 +230,7 @@ struct Crc32Sink::State: public HashSink::State
 
     void feed(const void *buffer, long fill)
     {
-        for (int i = 0; i < fill; ++i)
-            crc_ = crcTable[(crc_ ^ static_cast<const std::uint8_t *>(buffer)[i]) & 0xFF] ^ (crc_ >> 8);
+        crc_ = crc::feed(crc_, static_cast<const std::uint8_t *>(buffer), fill);
     }
 
     long read(Out<Bytes> buffer, long maxFill) override
@@ -115,4 +291,9 @@ std::uint32_t crc32(const Bytes &buffer)
     return state.crc_;
 }
 
+std::uint32_t crc32Combine(std::uint32_t crc1, std::uint32_t crc2, long size2)
+{
+    return crc::multiply(crc::shiftFactor(size2), crc1 ^ Crc32Sink::DefaultSeed) ^ crc2;
+}
+
 } // namespace cc
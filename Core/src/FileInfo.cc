@@ -7,6 +7,7 @@
  */
 
 #include <cc/FileInfo>
+#include <cc/File>
 #include <cstring>
 #include <cmath>
 
@@ -33,6 +34,15 @@ struct FileInfo::State final: public Object::State, public StructStat
         }
     }
 
+    State(int fd, const String &path):
+        path_{path},
+        isValid_{true}
+    {
+        StructStat *buf = static_cast<StructStat *>(this);
+        std::memset(buf, 0, sizeof(StructStat));
+        if (::fstat(fd, buf) == -1) CC_SYSTEM_ERROR(errno, path);
+    }
+
     String path_;
     bool isValid_;
 };
@@ -41,6 +51,10 @@ FileInfo::FileInfo(const String &path, bool followSymlink):
     Object{new State{path, followSymlink}}
 {}
 
+FileInfo::FileInfo(const File &file):
+    Object{new State{file.fd(), file.path()}}
+{}
+
 String FileInfo::path() const
 {
     return me().path_;
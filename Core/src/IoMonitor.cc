@@ -9,73 +9,237 @@
 #include <cc/IoMonitor>
 #include <cc/Map>
 #include <poll.h>
+#ifdef __linux
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
 
 namespace cc {
 
-struct IoMonitor::State final: public Object::State
+struct IoMonitor::State: public Object::State
 {
-    Map<int, IoActivity> subjects;
-    Array<struct pollfd> fds;
-    bool dirty { true };
+    explicit State(IoMonitorBackend backend):
+        backend_{backend}
+    {}
+
+    virtual void watch(const IoActivity &activity, bool renew) = 0;
+    virtual void unwatch(int fd) = 0;
+    virtual int wait(const Function<void(const IoActivity &)> &onReady, int timeout) = 0;
+
+    void notify(IoActivity &activity, IoEvent event, const Function<void(const IoActivity &)> &onReady)
+    {
+        activity.me().event_ = event;
+        onReady(activity);
+    }
+
+    IoMonitorBackend backend_;
+    Map<int, IoActivity> subjects_;
+};
+
+struct IoMonitor::PollState final: public IoMonitor::State
+{
+    PollState():
+        State{IoMonitorBackend::Poll}
+    {}
+
+    void watch(const IoActivity &, bool) override
+    {
+        dirty_ = true;
+    }
+
+    void unwatch(int) override
+    {
+        dirty_ = true;
+    }
+
+    int wait(const Function<void(const IoActivity &)> &onReady, int timeout) override
+    {
+        if (dirty_) {
+            dirty_ = false;
+            fds_ = Array<struct pollfd>::allocate(subjects_.count());
+            long i = 0;
+            for (const auto &pair: subjects_) {
+                struct pollfd &p = fds_[i++];
+                p.fd = pair.value().target().fd();
+                p.events = 0;
+                if (pair.value().mask() & IoEvent::ReadyRead) p.events |= POLLIN;
+                if (pair.value().mask() & IoEvent::ReadyWrite) p.events |= POLLOUT;
+            }
+        }
+
+        int n = -1;
+        do n = ::poll(fds_.items(), fds_.count(), (timeout < 0) ? -1 : timeout);
+        while (n == -1 && errno == EINTR);
+        if (n < 0) CC_SYSTEM_DEBUG_ERROR(errno);
+
+        const int ready = n;
+
+        if (n > 0) {
+            for (int i = 0; i < fds_.count(); ++i) {
+                const struct pollfd &p = fds_[i];
+                if (p.revents != 0) {
+                    Locator pos;
+                    if (subjects_.find(p.fd, &pos)) {
+                        IoEvent event = IoEvent::None;
+                        if (p.revents & POLLIN) event |= IoEvent::ReadyRead;
+                        if (p.revents & POLLOUT) event |= IoEvent::ReadyWrite;
+                        notify(subjects_.at(pos).value(), event, onReady);
+                    }
+                    if (--n == 0) break;
+                }
+            }
+        }
+
+        return ready;
+    }
+
+    Array<struct pollfd> fds_;
+    bool dirty_ { true };
 };
 
-IoMonitor::IoMonitor():
-    Object{new State}
-{}
+#ifdef __linux
+struct IoMonitor::EpollState final: public IoMonitor::State
+{
+    EpollState():
+        State{IoMonitorBackend::Epoll},
+        fd_{CC_SYSCALL(::epoll_create1(EPOLL_CLOEXEC))}
+    {}
+
+    ~EpollState()
+    {
+        ::close(fd_);
+    }
+
+    static uint32_t events(IoEvent mask)
+    {
+        uint32_t events = 0;
+        if (mask & IoEvent::ReadyRead) events |= EPOLLIN;
+        if (mask & IoEvent::ReadyWrite) events |= EPOLLOUT;
+        return events;
+    }
+
+    void watch(const IoActivity &activity, bool renew) override
+    {
+        const int fd = activity.target().fd();
+
+        if (renew && alwaysReady_.contains(fd)) {
+            alwaysReady_.establish(fd, activity);
+            return;
+        }
+
+        struct epoll_event ev;
+        ev.events = events(activity.mask());
+        ev.data.fd = fd;
+
+        if (::epoll_ctl(fd_, renew ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) == -1) {
+            if (errno == EPERM) {
+                // regular files and directories are always ready (same as with poll(2))
+                alwaysReady_.establish(fd, activity);
+                return;
+            }
+            CC_SYSTEM_DEBUG_ERROR(errno);
+        }
+    }
+
+    void unwatch(int fd) override
+    {
+        if (!alwaysReady_.remove(fd)) {
+            struct epoll_event ev {};
+            ::epoll_ctl(fd_, EPOLL_CTL_DEL, fd, &ev);
+            // the descriptor might have been closed already, which implicitly removes it from the interest list
+        }
+    }
+
+    int wait(const Function<void(const IoActivity &)> &onReady, int timeout) override
+    {
+        const long capacity = subjects_.count() < MaxEvents ? subjects_.count() : MaxEvents;
+        if (events_.count() < capacity) {
+            events_ = Array<struct epoll_event>::allocate(capacity);
+        }
+
+        if (alwaysReady_.count() > 0) timeout = 0;
+
+        int n = -1;
+        do n = ::epoll_wait(fd_, events_.items(), events_.count(), (timeout < 0) ? -1 : timeout);
+        while (n == -1 && errno == EINTR);
+        if (n < 0) CC_SYSTEM_DEBUG_ERROR(errno);
+
+        int ready = n;
+
+        for (int i = 0; i < n; ++i) {
+            const struct epoll_event &p = events_[i];
+            Locator pos;
+            if (!subjects_.find(p.data.fd, &pos)) continue; // unwatched by a preceding callback
+            IoEvent event = IoEvent::None;
+            if (p.events & EPOLLIN) event |= IoEvent::ReadyRead;
+            if (p.events & EPOLLOUT) event |= IoEvent::ReadyWrite;
+            notify(subjects_.at(pos).value(), event, onReady);
+        }
+
+        if (alwaysReady_.count() > 0) {
+            Array<IoActivity> activities = Array<IoActivity>::allocate(alwaysReady_.count());
+            long i = 0;
+            for (const auto &pair: alwaysReady_) activities[i++] = pair.value();
+            for (IoActivity &activity: activities) {
+                if (!subjects_.contains(activity.target().fd())) continue;
+                notify(activity, activity.mask(), onReady);
+                ++ready;
+            }
+        }
+
+        return ready;
+    }
+
+    static constexpr long MaxEvents = 1024;
+
+    int fd_ { -1 };
+    Array<struct epoll_event> events_;
+    Map<int, IoActivity> alwaysReady_;
+};
+#endif // __linux
+
+IoMonitor::IoMonitor(IoMonitorBackend backend)
+{
+    #ifdef __linux
+    if (backend != IoMonitorBackend::Poll) {
+        Object::me = new EpollState;
+        return;
+    }
+    #endif
+
+    Object::me = new PollState;
+}
+
+IoMonitorBackend IoMonitor::backend() const
+{
+    return me().backend_;
+}
+
+long IoMonitor::count() const
+{
+    return me().subjects_.count();
+}
 
 void IoMonitor::watch(const IoStream &target, IoEvent mask)
 {
-    me().dirty = true;
-    me().subjects.establish(target.fd(), IoActivity{target, mask});
+    IoActivity activity{target, mask};
+    bool renew = me().subjects_.contains(target.fd());
+    me().watch(activity, renew);
+    me().subjects_.establish(target.fd(), activity);
 }
 
 void IoMonitor::unwatch(const IoStream &target)
 {
-    me().dirty = true;
-    me().subjects.remove(target.fd());
+    if (me().subjects_.remove(target.fd())) {
+        me().unwatch(target.fd());
+    }
 }
 
 bool IoMonitor::wait(const Function<void(const IoActivity &)> &onReady, int timeout)
 {
-    assert(me().subjects.count() > 0);
-
-    if (me().dirty) {
-        me().dirty = false;
-        me().fds = Array<struct pollfd>::allocate(me().subjects.count());
-        long i = 0;
-        for (const auto &pair: me().subjects) {
-            struct pollfd &p = me().fds[i++];
-            p.fd = pair.value().target().fd();
-            p.events = 0;
-            if (pair.value().mask() & IoEvent::ReadyRead) p.events |= POLLIN;
-            if (pair.value().mask() & IoEvent::ReadyWrite) p.events |= POLLOUT;
-            if (pair.value().mask() & IoEvent::Established) p.events = POLLIN|POLLOUT;
-        }
-    }
-
-    int n = -1;
-    do n = ::poll(me().fds.items(), me().fds.count(), (timeout < 0) ? -1 : timeout);
-    while (n == -1 && errno == EINTR);
-    if (n < 0) CC_SYSTEM_DEBUG_ERROR(errno);
-
-    bool ready = (n > 0);
-
-    if (ready) {
-        for (int i = 0; i < me().fds.count(); ++i) {
-            const struct pollfd &p = me().fds[i];
-            if (p.revents != 0) {
-                IoActivity &activity = me().subjects(p.fd);
-                IoEvent &event = activity.me().event_;
-                event = IoEvent::None;
-                if (p.revents & POLLIN) event |= IoEvent::ReadyRead;
-                if (p.revents & POLLOUT) event |= IoEvent::ReadyWrite;
-                onReady(activity);
-                if (--n == 0) break;
-            }
-        }
-    }
+    assert(me().subjects_.count() > 0);
 
-    return ready;
+    return me().wait(onReady, timeout) > 0;
 }
 
 IoMonitor::State &IoMonitor::me()
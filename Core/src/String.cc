@@ -7,8 +7,13 @@
  */
 
 #include <cc/String>
+#include <cc/SearchDispatch>
 #include <cc/Utf8Sink>
 #include <cc/Casefree>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
@@ -22,6 +27,112 @@ String String::alignedRight(int w, char blank) const
     return (count() > w) ? *this : String::allocate(w - count(), blank) + *this;
 }
 
+namespace search {
+
+/** Find the first occurence of \a b (\a bn >= 2) in \a a (\a n characters)
+  */
+static const char *scanPortable(const char *a, long n, const char *b, long bn)
+{
+    if (n < bn) return nullptr;
+
+    const char *end = a + n - bn + 1;
+    const char first = b[0];
+    const char last = b[bn - 1];
+
+    for (const char *p = a; p < end; ++p) {
+        p = static_cast<const char *>(std::memchr(p, first, end - p));
+        if (!p) break;
+        if (p[bn - 1] == last && std::memcmp(p + 1, b + 1, bn - 2) == 0) return p;
+    }
+
+    return nullptr;
+}
+
+#if defined __x86_64__ || defined __i386__
+
+static bool detectAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool useAvx2 = detectAvx2();
+
+/** Find the first occurence of \a b (\a bn >= 2) in \a a (\a n characters)
+  *
+  * Candidate positions are those where both the first and the last character of \a b match.
+  * These are filtered 16 positions at a time and only verified by a full comparison.
+  * \see "SIMD-friendly algorithms for substring searching", W. Mula, 2016
+  */
+__attribute__((target("sse2")))
+static const char *scanSse2(const char *a, long n, const char *b, long bn)
+{
+    const __m128i first = _mm_set1_epi8(b[0]);
+    const __m128i last = _mm_set1_epi8(b[bn - 1]);
+
+    long i = 0;
+    for (; i + bn + 15 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i + bn - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(x, first), _mm_cmpeq_epi8(y, last)))
+        );
+        while (mask != 0) {
+            const long k = i + __builtin_ctz(mask);
+            if (std::memcmp(a + k + 1, b + 1, bn - 2) == 0) return a + k;
+            mask &= mask - 1;
+        }
+    }
+
+    return scanPortable(a + i, n - i, b, bn);
+}
+
+/** \copydoc scanSse2()
+  */
+__attribute__((target("avx2")))
+static const char *scanAvx2(const char *a, long n, const char *b, long bn)
+{
+    const __m256i first = _mm256_set1_epi8(b[0]);
+    const __m256i last = _mm256_set1_epi8(b[bn - 1]);
+
+    long i = 0;
+    for (; i + bn + 31 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i + bn - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(x, first), _mm256_cmpeq_epi8(y, last)))
+        );
+        while (mask != 0) {
+            const long k = i + __builtin_ctz(mask);
+            if (std::memcmp(a + k + 1, b + 1, bn - 2) == 0) return a + k;
+            mask &= mask - 1;
+        }
+    }
+
+    return scanPortable(a + i, n - i, b, bn);
+}
+
+#else
+
+bool useAvx2 = false;
+
+#endif
+
+/** Find the first occurence of \a b (\a bn >= 1) in \a a (\a n characters)
+  */
+static const char *scan(const char *a, long n, const char *b, long bn)
+{
+    if (bn == 1) return static_cast<const char *>(std::memchr(a, b[0], n));
+    #if defined __x86_64__ || defined __i386__
+    if (useAvx2) return scanAvx2(a, n, b, bn);
+    return scanSse2(a, n, b, bn);
+    #else
+    return scanPortable(a, n, b, bn);
+    #endif
+}
+
+} // namespace search
+
 bool String::find(const char *b, long bn, InOut<long> i0) const
 {
     assert(0 <= i0);
@@ -37,52 +148,70 @@ bool String::find(const char *b, long bn, InOut<long> i0) const
         return false;
     }
 
-    for (long j = i, k = 0; j < n;) {
-        if (a[j++] == b[k]) {
-            ++k;
-            if (k == bn) {
-                i0 = j - k;
-                return true;
-            }
-        }
-        else {
-            k = 0;
-        }
+    const char *p = search::scan(a + i, n - i, b, bn);
+    if (!p) {
+        i0 = n;
+        return false;
     }
 
-    i0 = n;
-    return false;
+    i0 = p - a;
+    return true;
+}
+
+long String::count(const char *b, long bn) const
+{
+    if (bn < 0) bn = len(b);
+    if (bn == 0) return 0;
+
+    long o = 0;
+    for (long i = 0; find(b, bn, &i); i += bn) ++o;
+    return o;
 }
 
 void String::replace(const char *b, const char *s, long bn, long sn)
 {
-    if (!b || !s) return;
+    if (!b || !s || bn <= 0) return;
+
+    long i1 = 0;
+    if (!find(b, bn, &i1)) return;
+
+    const long n = count();
+    const char *a = chars();
 
     if (bn < sn) {
-        if (find(b)) {
-            (*this) = String{split(b, bn), s, sn};
+        String result = String::allocate(n + count(b, bn) * (sn - bn));
+        char *d = result.chars();
+        for (long i0 = 0;;) {
+            std::memcpy(d, a + i0, i1 - i0);
+            d += i1 - i0;
+            std::memcpy(d, s, sn);
+            d += sn;
+            i0 = i1 + bn;
+            i1 = i0;
+            if (!find(b, bn, &i1)) {
+                std::memcpy(d, a + i0, n - i0);
+                break;
+            }
         }
+        (*this) = result;
     }
-    else if (bn > 0) {
-        long i = 0, j = 0, k = 0, n = me().count;
-        char *a = chars();
-        while (i < n) {
-            char ch = a[i++];
-            if (j < i) a[j++] = ch;
-            if (ch == b[k]) {
-                ++k;
-                if (k == bn) {
-                    j -= bn;
-                    for (k = 0; k < sn; ++k)
-                        a[j++] = s[k];
-                    k = 0;
-                }
-            }
-            else {
-                k = 0;
+    else {
+        char *d = chars();
+        char *d0 = d;
+        for (long i0 = 0;;) {
+            std::memmove(d, a + i0, i1 - i0);
+            d += i1 - i0;
+            std::memmove(d, s, sn);
+            d += sn;
+            i0 = i1 + bn;
+            i1 = i0;
+            if (!find(b, bn, &i1)) {
+                std::memmove(d, a + i0, n - i0);
+                d += n - i0;
+                break;
             }
         }
-        truncate(j);
+        truncate(d - d0);
     }
 }
 
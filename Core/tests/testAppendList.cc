@@ -16,5 +16,24 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "TransactionRollback",
+        []{
+            AppendList<int> a { 0, 1 };
+            auto transaction = a.transaction();
+            a.pushBack(2);
+            a.pushBack(3);
+            transaction.rollback();
+            CC_CHECK(a.count() == 2);
+            CC_CHECK(a.last() == 1);
+            a.pushBack(4);
+            CC_CHECK(a.count() == 3);
+            CC_CHECK(a.last() == 4);
+            int s = 0;
+            for (int x: a) s += x;
+            CC_CHECK(s == 5);
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -24,5 +24,20 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "ReuseSelection",
+        []{
+            Array<int> a = Array<int>::allocate(10);
+            for (int i = 0; i < a.count(); ++i) a[i] = i;
+
+            Array<int> b;
+            for (int i = 0; i < a.count(); ++i) {
+                a.selectAs(i, a.count(), &b);
+                CC_CHECK_EQUALS(b.count(), a.count() - i);
+                CC_CHECK_EQUALS(b[0], i);
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/Crc32Sink>
+#include <cc/CrcDispatch>
+#include <cc/Random>
+#include <cc/testing>
+
+int main(int argc, char* argv[])
+{
+    using namespace cc;
+
+    struct Test {
+        static Bytes random(long n, uint32_t seed)
+        {
+            Random random{seed};
+            Bytes data = Bytes::allocate(n);
+            for (long i = 0; i < n; ++i) data[i] = random.get() & 0xFF;
+            return data;
+        }
+
+        static uint32_t crc32Bitwise(const uint8_t *p, long n)
+        {
+            uint32_t crc = Crc32Sink::DefaultSeed;
+            for (long i = 0; i < n; ++i) {
+                crc ^= p[i];
+                for (int k = 0; k < 8; ++k) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+            return crc;
+        }
+    };
+
+    TestCase {
+        "Crc32KnownValues",
+        []{
+            CC_CHECK(crc32("") == 0xFFFFFFFF);
+            CC_CHECK(~crc32("123456789") == 0xCBF43926);
+            CC_CHECK(~crc32("The quick brown fox jumps over the lazy dog") == 0x414FA339);
+        }
+    };
+
+    TestCase {
+        "Crc32ImplementationsAgree",
+        []{
+            const bool hasPclmul = crc::usePclmul;
+            Bytes data = Test::random(0x1000, 1);
+
+            for (bool pclmul: { false, true }) {
+                if (pclmul && !hasPclmul) continue;
+                crc::usePclmul = pclmul;
+                for (long offset = 0; offset < 16; offset += 3) {
+                    for (long n = 0; offset + n <= data.count(); n += 1 + n / 8) {
+                        CC_VERIFY(crc32(data.bytes() + offset, n) == Test::crc32Bitwise(data.bytes() + offset, n));
+                    }
+                }
+            }
+
+            crc::usePclmul = hasPclmul;
+        }
+    };
+
+    TestCase {
+        "Crc32SinkIncremental",
+        []{
+            Bytes data = Test::random(0x3333, 2);
+            Crc32Sink sink{Crc32Sink::DefaultSeed};
+            Random random{3};
+            for (long i = 0; i < data.count();) {
+                long n = random.get(0, 300);
+                if (i + n > data.count()) n = data.count() - i;
+                sink.write(data.copy(i, i + n));
+                i += n;
+            }
+            CC_CHECK(sink.sum() == crc32(data));
+        }
+    };
+
+    TestCase {
+        "Crc32Combine",
+        []{
+            Bytes data = Test::random(0x2345, 4);
+            const uint32_t expected = crc32(data);
+
+            for (long i: { 0L, 1L, 7L, 64L, 1000L, 0x2000L, 0x2345L }) {
+                const uint32_t crc1 = crc32(data.bytes(), i);
+                const uint32_t crc2 = crc32(data.bytes() + i, data.count() - i);
+                CC_VERIFY(crc32Combine(crc1, crc2, data.count() - i) == expected);
+            }
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
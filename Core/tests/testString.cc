@@ -1,7 +1,9 @@
 #include <cc/String>
+#include <cc/SearchDispatch>
 #include <cc/Casefree>
 #include <cc/Unicode>
 #include <cc/Utf16>
+#include <cc/Random>
 #include <cc/testing>
 
 int main(int argc, char *argv[])
@@ -54,5 +56,68 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "SubstringSearch",
+        []{
+            long i = 0;
+            CC_CHECK(String{"aaab"}.find("aab", &i) && i == 1);
+            i = 0;
+            CC_CHECK(String{"abababc"}.find("ababc", &i) && i == 2);
+            i = 3;
+            CC_CHECK(String{"abcabc"}.find("abc", &i) && i == 3);
+            i = 0;
+            CC_CHECK(!String{"abcabc"}.find("abd", &i) && i == 6);
+            CC_CHECK(!String{"ab"}.find("abc"));
+            CC_CHECK(!String{"abc"}.find(""));
+            CC_CHECK(String{"x.y.z"}.count(".") == 2);
+            CC_CHECK(String{"aaaa"}.count("aa") == 2);
+        }
+    };
+
+    TestCase {
+        "SubstringSearchImplementationsAgree",
+        []{
+            auto naiveFind = [](const String &a, const String &b, long i) {
+                for (; i + b.count() <= a.count(); ++i) {
+                    if (a.copy(i, i + b.count()) == b) return i;
+                }
+                return a.count();
+            };
+
+            const bool avx2 = search::useAvx2;
+            Random random { 7 };
+            for (int k = 0; k < 400; ++k) {
+                String a = String::allocate(random.get(0, 300));
+                for (long j = 0; j < a.count(); ++j) a[j] = 'a' + random.get(0, 2);
+                String b = String::allocate(random.get(1, 6));
+                for (long j = 0; j < b.count(); ++j) b[j] = 'a' + random.get(0, 2);
+                for (bool on: { false, avx2 }) {
+                    search::useAvx2 = on;
+                    long i0 = random.get(0, a.count());
+                    long i = i0;
+                    bool found = a.find(b, &i);
+                    long j = naiveFind(a, b, i0);
+                    CC_VERIFY(i == j && found == (j < a.count()));
+                }
+            }
+            search::useAvx2 = avx2;
+        }
+    };
+
+    TestCase {
+        "ReplaceSplit",
+        []{
+            CC_CHECK_EQUALS(String{"aaab"}.replaced("aab", "x"), "ax");
+            CC_CHECK_EQUALS(String{"aaab"}.replaced("aab", "xyzw"), "axyzw");
+            CC_CHECK_EQUALS(String{"a--b--c"}.replaced("--", "+"), "a+b+c");
+            CC_CHECK_EQUALS(String{"a--b--c"}.replaced("--", "<->"), "a<->b<->c");
+            CC_CHECK_EQUALS(String{"--"}.replaced("--", ""), "");
+            CC_CHECK_EQUALS(String{"abc"}.replaced("x", "yy"), "abc");
+            List<String> parts = String{"a::b:::c"}.split("::");
+            CC_CHECK(parts.count() == 3);
+            CC_CHECK(parts.at(0) == "a" && parts.at(1) == "b" && parts.at(2) == ":c");
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
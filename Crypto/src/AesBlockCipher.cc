@@ -7,8 +7,13 @@
  */
 
 #include <cc/AesBlockCipher>
+#include <cc/AesDispatch>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
@@ -273,6 +278,113 @@ Bytes keyExpansion(const Bytes &key, int Nr)
     return w;
 }
 
+#if defined __x86_64__ || defined __i386__
+
+static bool detectAesNi()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("aes");
+}
+
+bool useAesNi = detectAesNi();
+
+__attribute__((target("aes,sse2")))
+static void invertKeySchedule(const uint8_t *w, int Nr, uint8_t *dw)
+{
+    const __m128i *k = reinterpret_cast<const __m128i *>(w);
+    __m128i *dk = reinterpret_cast<__m128i *>(dw);
+
+    _mm_storeu_si128(dk, _mm_loadu_si128(k + Nr));
+    for (int r = 1; r < Nr; ++r) {
+        _mm_storeu_si128(dk + r, _mm_aesimc_si128(_mm_loadu_si128(k + Nr - r)));
+    }
+    _mm_storeu_si128(dk + Nr, _mm_loadu_si128(k));
+}
+
+__attribute__((target("aes,sse2")))
+static void encodeNi(const uint8_t *w, int Nr, const uint8_t *p, uint8_t *c, long n)
+{
+    __m128i k[15];
+    for (int r = 0; r <= Nr; ++r) {
+        k[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w) + r);
+    }
+
+    const __m128i *src = reinterpret_cast<const __m128i *>(p);
+    __m128i *dst = reinterpret_cast<__m128i *>(c);
+
+    long i = 0;
+
+    for (; i + 4 <= n; i += 4) { // interleave four blocks to hide the latency of aesenc
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + i + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + i + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + i + 3), k[0]);
+        for (int r = 1; r < Nr; ++r) {
+            b0 = _mm_aesenc_si128(b0, k[r]);
+            b1 = _mm_aesenc_si128(b1, k[r]);
+            b2 = _mm_aesenc_si128(b2, k[r]);
+            b3 = _mm_aesenc_si128(b3, k[r]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b0, k[Nr]));
+        _mm_storeu_si128(dst + i + 1, _mm_aesenclast_si128(b1, k[Nr]));
+        _mm_storeu_si128(dst + i + 2, _mm_aesenclast_si128(b2, k[Nr]));
+        _mm_storeu_si128(dst + i + 3, _mm_aesenclast_si128(b3, k[Nr]));
+    }
+
+    for (; i < n; ++i) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        for (int r = 1; r < Nr; ++r) {
+            b = _mm_aesenc_si128(b, k[r]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b, k[Nr]));
+    }
+}
+
+__attribute__((target("aes,sse2")))
+static void decodeNi(const uint8_t *dw, int Nr, const uint8_t *c, uint8_t *p, long n)
+{
+    __m128i k[15];
+    for (int r = 0; r <= Nr; ++r) {
+        k[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dw) + r);
+    }
+
+    const __m128i *src = reinterpret_cast<const __m128i *>(c);
+    __m128i *dst = reinterpret_cast<__m128i *>(p);
+
+    long i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + i + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + i + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + i + 3), k[0]);
+        for (int r = 1; r < Nr; ++r) {
+            b0 = _mm_aesdec_si128(b0, k[r]);
+            b1 = _mm_aesdec_si128(b1, k[r]);
+            b2 = _mm_aesdec_si128(b2, k[r]);
+            b3 = _mm_aesdec_si128(b3, k[r]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesdeclast_si128(b0, k[Nr]));
+        _mm_storeu_si128(dst + i + 1, _mm_aesdeclast_si128(b1, k[Nr]));
+        _mm_storeu_si128(dst + i + 2, _mm_aesdeclast_si128(b2, k[Nr]));
+        _mm_storeu_si128(dst + i + 3, _mm_aesdeclast_si128(b3, k[Nr]));
+    }
+
+    for (; i < n; ++i) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        for (int r = 1; r < Nr; ++r) {
+            b = _mm_aesdec_si128(b, k[r]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesdeclast_si128(b, k[Nr]));
+    }
+}
+
+#else
+
+bool useAesNi = false;
+
+#endif
+
 } // namespace aes
 
 using namespace aes;
@@ -284,18 +396,70 @@ struct AesBlockCipher::State: public BlockCipher::State
         Nk_{static_cast<int>(key.count() / 4)},
         Nr_{numRounds(Nk_)},
         s_{Bytes::allocate(AesBlockCipher::BlockSize)},
-        w_{keyExpansion(key, Nr_)}
+        w_{keyExpansion(key, Nr_)},
+        ni_{useAesNi}
     {
         assert(key.count() == 16 || key.count() == 24 || key.count() == 32);
+
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            dw_ = Bytes::allocate(w_.count());
+            invertKeySchedule(w_.bytes(), Nr_, dw_.bytes());
+        }
+        #endif
+    }
+
+    ~State()
+    {
+        s_.fill(0);
+        w_.fill(0);
+        if (dw_) dw_.fill(0);
     }
 
     void encode(const Bytes &p, Out<Bytes> c) override
     {
-        assert(p.count() == AesBlockCipher::BlockSize);
-        assert(c != None{} && c->count() == AesBlockCipher::BlockSize);
+        assert(p.count() % AesBlockCipher::BlockSize == 0);
+        assert(c != None{} && c->count() == p.count());
+
+        const long n = p.count() / AesBlockCipher::BlockSize;
 
-        p.copyTo(&s_);
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            encodeNi(w_.bytes(), Nr_, p.bytes(), c->bytes(), n);
+            return;
+        }
+        #endif
 
+        for (long i = 0; i < n; ++i) {
+            std::memcpy(s_.bytes(), p.bytes() + i * AesBlockCipher::BlockSize, AesBlockCipher::BlockSize);
+            encodeBlock();
+            std::memcpy(c->bytes() + i * AesBlockCipher::BlockSize, s_.bytes(), AesBlockCipher::BlockSize);
+        }
+    }
+
+    void decode(const Bytes &c, Out<Bytes> p) override
+    {
+        assert(c.count() % AesBlockCipher::BlockSize == 0);
+        assert(p != None{} && p->count() == c.count());
+
+        const long n = c.count() / AesBlockCipher::BlockSize;
+
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            decodeNi(dw_.bytes(), Nr_, c.bytes(), p->bytes(), n);
+            return;
+        }
+        #endif
+
+        for (long i = 0; i < n; ++i) {
+            std::memcpy(s_.bytes(), c.bytes() + i * AesBlockCipher::BlockSize, AesBlockCipher::BlockSize);
+            decodeBlock();
+            std::memcpy(p->bytes() + i * AesBlockCipher::BlockSize, s_.bytes(), AesBlockCipher::BlockSize);
+        }
+    }
+
+    void encodeBlock()
+    {
         addRoundKey(&s_, w_, 0);
 
         for (int r = 1; r < Nr_; ++r) {
@@ -308,17 +472,10 @@ struct AesBlockCipher::State: public BlockCipher::State
         subBytes(&s_);
         shiftRows(&s_);
         addRoundKey(&s_, w_, Nr_);
-
-        s_.copyTo(&c);
     }
 
-    void decode(const Bytes &c, Out<Bytes> p) override
+    void decodeBlock()
     {
-        assert(c.count() == AesBlockCipher::BlockSize);
-        assert(p != None{} && p->count() == AesBlockCipher::BlockSize);
-
-        c.copyTo(&s_);
-
         addRoundKey(&s_, w_, Nr_);
 
         for (int r = Nr_ - 1; r > 0; --r) {
@@ -331,17 +488,17 @@ struct AesBlockCipher::State: public BlockCipher::State
         invShiftRows(&s_);
         invSubBytes(&s_);
         addRoundKey(&s_, w_, 0);
-
-        s_.copyTo(&p);
     }
 
     const int Nk_, Nr_;
     Bytes s_;
     Bytes w_;
+    Bytes dw_; ///< inverse key schedule for AES-NI
+    bool ni_;
 };
 
 AesBlockCipher::AesBlockCipher(const Bytes &key):
     BlockCipher{new State{key}}
 {}
 
-} // namespace
+} // namespace cc
@@ -8,6 +8,7 @@
 
 #include <cc/BlockCipherSink>
 #include <cc/NullStream>
+#include <cc/math>
 
 namespace cc {
 
@@ -17,7 +18,7 @@ struct BlockCipherSink::State: public Stream::State
         sink_{sink},
         cipher_{cipher},
         pad_{pad},
-        block_{Bytes::allocate(cipher.blockSize())}
+        buffer_{Bytes::allocate(upToNext(cipher.blockSize(), 0x4000))}
     {
         if (!pad_) pad_ = NullStream{};
     }
@@ -28,7 +29,7 @@ struct BlockCipherSink::State: public Stream::State
             write(pad_.readSpan(cipher_.blockSize() - pending_.count()));
             pending_.fill(0);
         }
-        block_.fill(0);
+        buffer_.fill(0);
     }
 
     void write(const Bytes &buffer, long fill = -1) override
@@ -44,22 +45,26 @@ struct BlockCipherSink::State: public Stream::State
         }
 
         const int n_b = cipher_.blockSize();
-        long i = 0;
+        const long n = data.count() - data.count() % n_b;
 
-        for (; i + n_b <= data.count(); i += n_b) {
-            cipher_.encode(data.select(i, i + n_b), &block_);
-            sink_.write(block_);
+        for (long i = 0; i < n;) {
+            long m = n - i;
+            if (m > buffer_.count()) m = buffer_.count();
+            Bytes c = buffer_.select(0, m);
+            cipher_.encode(data.select(i, i + m), &c);
+            sink_.write(c);
+            i += m;
         }
 
-        if (i < data.count()) {
-            pending_ = data.copy(i, data.count());
+        if (n < data.count()) {
+            pending_ = data.copy(n, data.count());
         }
     }
 
     Stream sink_;
     BlockCipher cipher_;
     Stream pad_;
-    Bytes block_;
+    Bytes buffer_; // ciphertext buffer (a multiple of the block size)
     Bytes pending_;
 };
 
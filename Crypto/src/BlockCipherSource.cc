@@ -14,13 +14,11 @@ struct BlockCipherSource::State: public Stream::State
 {
     State(const Stream &source, const BlockCipher &cipher):
         source_{source},
-        cipher_{cipher},
-        block_{Bytes::allocate(cipher.blockSize())}
+        cipher_{cipher}
     {}
 
     ~State()
     {
-        block_.fill(0);
         decodeBuffer_.select(0, u_).fill(0);
     }
 
@@ -67,11 +65,8 @@ struct BlockCipherSource::State: public Stream::State
 
             // decode contents of decoding buffer
 
-            for (long i = 0; i + n_b <= m_; i += n_b) {
-                Bytes s = decodeBuffer_.select(i, i + n_b);
-                cipher_.decode(s, &block_);
-                block_.copyTo(&s);
-            }
+            Bytes s = decodeBuffer_.select(0, m_);
+            cipher_.decode(s, &s);
         }
 
         const int availCount = m_ - j_;
@@ -83,7 +78,6 @@ struct BlockCipherSource::State: public Stream::State
 
     Stream source_;
     BlockCipher cipher_;
-    Bytes block_; // a single decode block
     Bytes decodeBuffer_ { Bytes::allocate(0x1000) }; // in-situ decoding buffer
     Bytes pending_; // overhang which did not fit into a multiple of a block size
     int j_ { 0 }; // consume offset in decode buffer
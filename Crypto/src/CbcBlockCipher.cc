@@ -7,6 +7,7 @@
  */
 
 #include <cc/CbcBlockCipher>
+#include <cstring>
 
 namespace cc {
 
@@ -23,20 +24,38 @@ struct CbcBlockCipher::State: public BlockCipher::State
 
     void encode(const Bytes &p, Out<Bytes> c) override
     {
-        p.applyTo<Xor>(&s_);
-        cipher_.encode(s_, &c);
-        c->copyTo(&s_);
+        const int n_b = blockSize();
+        const uint8_t *src = p.bytes();
+        uint8_t *s = s_.bytes();
+        for (long i = 0; i < p.count(); i += n_b) {
+            for (int j = 0; j < n_b; ++j) s[j] ^= src[i + j];
+            cipher_.encode(s_, &s_);
+            std::memcpy(c->bytes() + i, s_.bytes(), n_b);
+        }
     }
 
     void decode(const Bytes &c, Out<Bytes> p) override
     {
-        cipher_.decode(c, &p);
-        s_.applyTo<Xor>(&p);
-        c.copyTo(&s_);
+        // deciphering is not chained, therefore all blocks are passed to the cipher at once
+
+        if (c.count() == 0) return;
+        if (t_.count() < c.count()) t_ = Bytes::allocate(c.count());
+        Bytes t = t_.select(0, c.count());
+        c.copyTo(&t);
+        cipher_.decode(t, &p);
+
+        const int n_b = blockSize();
+        uint8_t *q = p->bytes();
+        const uint8_t *s = s_.bytes();
+        for (int j = 0; j < n_b; ++j) q[j] ^= s[j];
+        const uint8_t *r = t.bytes();
+        for (long i = n_b; i < c.count(); ++i) q[i] ^= r[i - n_b];
+        std::memcpy(s_.bytes(), t.bytes() + c.count() - n_b, n_b);
     }
 
     BlockCipher cipher_;
     Bytes s_;
+    Bytes t_;
 };
 
 CbcBlockCipher::CbcBlockCipher(const BlockCipher &cipher, const Bytes &start):
@@ -7,10 +7,152 @@
  */
 
 #include <cc/CryptoHashSink>
+#include <cc/ShaDispatch>
+#include <cstring>
 #include <sys/uio.h> // iovec
 
 namespace cc {
 
+namespace sha {
+
+#if defined __x86_64__ || defined __i386__
+
+static bool detectShaNi()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+}
+
+static bool detectAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool useShaNi = detectShaNi();
+bool useAvx2 = detectAvx2();
+
+#else
+
+bool useShaNi = false;
+bool useAvx2 = false;
+
+#endif
+
+/** Write the padded final block(s) of a message of \a size bytes to \a tail (SHA-1 and SHA-2/256 padding)
+  * \return Number of tail blocks (1 or 2)
+  */
+static int padTail(const uint8_t *data, long size, uint8_t *tail)
+{
+    constexpr int BlockSize = 64;
+    const long r = size % BlockSize;
+    const int tailBlocks = (r < BlockSize - 8) ? 1 : 2;
+    const uint64_t bits = uint64_t(size) * 8;
+    std::memset(tail, 0, 2 * BlockSize);
+    if (r > 0) std::memcpy(tail, data + size - r, r);
+    tail[r] = 0x80;
+    for (int i = 0; i < 8; ++i) tail[tailBlocks * BlockSize - 1 - i] = bits >> (8 * i);
+    return tailBlocks;
+}
+
+static Bytes digest(const uint32_t *state, int words, int stride = 1)
+{
+    Bytes h = Bytes::allocate(4 * words);
+    for (int w = 0; w < words; ++w) {
+        const uint32_t x = state[w * stride];
+        h[4 * w] = x >> 24;
+        h[4 * w + 1] = (x >> 16) & 0xFF;
+        h[4 * w + 2] = (x >> 8) & 0xFF;
+        h[4 * w + 3] = x & 0xFF;
+    }
+    return h;
+}
+
+List<Bytes> hashEach(const List<Bytes> &messages, int words, const uint32_t *iv, BlockCompress compress)
+{
+    List<Bytes> digests;
+    uint32_t state[8];
+    uint8_t tail[128];
+
+    for (const Bytes &message: messages) {
+        std::memcpy(state, iv, words * sizeof(uint32_t));
+        const long n = message.count() / 64;
+        if (n > 0) compress(state, message.bytes(), n);
+        compress(state, tail, padTail(message.bytes(), message.count(), tail));
+        digests.append(digest(state, words));
+    }
+
+    return digests;
+}
+
+List<Bytes> hashLanes(const List<Bytes> &messages, int words, const uint32_t *iv, LaneCompress compress)
+{
+    constexpr int Lanes = 8;
+    constexpr int BlockSize = 64;
+
+    struct Lane {
+        long message { -1 };
+        const uint8_t *data { nullptr };
+        long fullBlocks { 0 };
+        long blockCount { 0 };
+        long block { 0 };
+        uint8_t tail[2 * BlockSize];
+    };
+
+    const long n = messages.count();
+
+    List<Bytes> digests;
+    for (long i = 0; i < n; ++i) digests.append(Bytes{});
+
+    uint32_t state[8 * Lanes];
+    Lane lanes[Lanes];
+    const uint8_t zero[BlockSize] = {};
+    long next = 0;
+    int active = 0;
+
+    auto start = [&](int l) {
+        Lane &lane = lanes[l];
+        if (next == n) {
+            lane.message = -1;
+            return;
+        }
+        const Bytes &message = messages.at(next);
+        lane.message = next++;
+        lane.data = message.bytes();
+        lane.fullBlocks = message.count() / BlockSize;
+        lane.blockCount = lane.fullBlocks + padTail(lane.data, message.count(), lane.tail);
+        lane.block = 0;
+        for (int w = 0; w < words; ++w) state[w * Lanes + l] = iv[w];
+        ++active;
+    };
+
+    for (int l = 0; l < Lanes; ++l) start(l);
+
+    while (active > 0) {
+        const uint8_t *blocks[Lanes];
+        for (int l = 0; l < Lanes; ++l) {
+            const Lane &lane = lanes[l];
+            if (lane.message < 0) blocks[l] = zero;
+            else if (lane.block < lane.fullBlocks) blocks[l] = lane.data + lane.block * BlockSize;
+            else blocks[l] = lane.tail + (lane.block - lane.fullBlocks) * BlockSize;
+        }
+
+        compress(state, blocks);
+
+        for (int l = 0; l < Lanes; ++l) {
+            Lane &lane = lanes[l];
+            if (lane.message < 0 || ++lane.block < lane.blockCount) continue;
+            digests[lane.message] = digest(state + l, words, Lanes);
+            --active;
+            start(l);
+        }
+    }
+
+    return digests;
+}
+
+} // namespace sha
+
 void CryptoHashSink::State::write(const List<Bytes> &buffers)
 {
     for (const Bytes &h: buffers) HashSink::State::write(h);
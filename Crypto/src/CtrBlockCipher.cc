@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/CtrBlockCipher>
+#include <cstdint>
+#include <cstring>
+
+namespace cc {
+
+struct CtrBlockCipher::State: public BlockCipher::State
+{
+    static constexpr int KeyStreamBlocks = 32;
+
+    State(const BlockCipher &cipher, const Bytes &start):
+        BlockCipher::State{1},
+        cipher_{cipher},
+        counter_{Bytes::allocate(cipher.blockSize())},
+        counterBlocks_{Bytes::allocate(KeyStreamBlocks * cipher.blockSize())},
+        keyStream_{Bytes::allocate(KeyStreamBlocks * cipher.blockSize())},
+        k_{keyStream_.count()}
+    {
+        counter_.fill(0);
+        if (start) start.copyTo(&counter_);
+    }
+
+    ~State()
+    {
+        keyStream_.fill(0);
+    }
+
+    void encode(const Bytes &p, Out<Bytes> c) override
+    {
+        crypt(p.bytes(), c->bytes(), p.count());
+    }
+
+    void decode(const Bytes &c, Out<Bytes> p) override
+    {
+        crypt(c.bytes(), p->bytes(), c.count());
+    }
+
+    void crypt(const uint8_t *src, uint8_t *dst, long n)
+    {
+        for (long i = 0; i < n;) {
+            if (k_ == keyStream_.count()) generate();
+            const uint8_t *ks = keyStream_.bytes() + k_;
+            long m = keyStream_.count() - k_;
+            if (n - i < m) m = n - i;
+            long j = 0;
+            for (; j + 8 <= m; j += 8) {
+                uint64_t a, b;
+                std::memcpy(&a, src + i + j, 8);
+                std::memcpy(&b, ks + j, 8);
+                a ^= b;
+                std::memcpy(dst + i + j, &a, 8);
+            }
+            for (; j < m; ++j) dst[i + j] = src[i + j] ^ ks[j];
+            i += m;
+            k_ += m;
+        }
+    }
+
+    void generate()
+    {
+        const int n_b = counter_.count();
+        uint8_t *counter = counter_.bytes();
+        uint8_t *blocks = counterBlocks_.bytes();
+
+        if (n_b == 16) {
+            uint64_t hi, lo;
+            std::memcpy(&hi, counter, 8);
+            std::memcpy(&lo, counter + 8, 8);
+            hi = __builtin_bswap64(hi);
+            lo = __builtin_bswap64(lo);
+            for (int b = 0; b < KeyStreamBlocks; ++b) {
+                uint64_t h = __builtin_bswap64(hi);
+                uint64_t l = __builtin_bswap64(lo);
+                std::memcpy(blocks + 16 * b, &h, 8);
+                std::memcpy(blocks + 16 * b + 8, &l, 8);
+                if (++lo == 0) ++hi;
+            }
+            hi = __builtin_bswap64(hi);
+            lo = __builtin_bswap64(lo);
+            std::memcpy(counter, &hi, 8);
+            std::memcpy(counter + 8, &lo, 8);
+        }
+        else {
+            for (int b = 0; b < KeyStreamBlocks; ++b) {
+                std::memcpy(blocks + b * n_b, counter, n_b);
+                for (int j = n_b - 1; j >= 0; --j) {
+                    if (++counter[j] != 0) break;
+                }
+            }
+        }
+
+        cipher_.encode(counterBlocks_, &keyStream_);
+        k_ = 0;
+    }
+
+    BlockCipher cipher_;
+    Bytes counter_; ///< next counter block
+    Bytes counterBlocks_;
+    Bytes keyStream_;
+    long k_; ///< consume offset in key stream
+};
+
+CtrBlockCipher::CtrBlockCipher(const BlockCipher &cipher, const Bytes &start):
+    BlockCipher{new State{cipher, start}}
+{}
+
+} // namespace cc
@@ -0,0 +1,436 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/GcmBlockCipher>
+#include <cc/GcmDispatch>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
+
+namespace cc {
+
+namespace gcm {
+
+enum { BlockSize = 16 };
+
+/** Multiply \a x by H in GF(2^128) using the 4-bit tables \a hl, \a hh (Shoup's method)
+  */
+static void multiply(uint8_t *x, const uint64_t *hl, const uint64_t *hh)
+{
+    static const uint64_t last4[16] = {
+        0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+        0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+    };
+
+    int lo = x[15] & 0xF;
+    uint64_t zh = hh[lo];
+    uint64_t zl = hl[lo];
+
+    for (int i = 15; i >= 0; --i) {
+        lo = x[i] & 0xF;
+        int hi = x[i] >> 4;
+
+        if (i != 15) {
+            int rem = zl & 0xF;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (last4[rem] << 48);
+            zh ^= hh[lo];
+            zl ^= hl[lo];
+        }
+
+        int rem = zl & 0xF;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (last4[rem] << 48);
+        zh ^= hh[hi];
+        zl ^= hl[hi];
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        x[i] = zh >> (56 - 8 * i);
+        x[8 + i] = zl >> (56 - 8 * i);
+    }
+}
+
+static uint64_t readUInt64(const uint8_t *p)
+{
+    uint64_t h = 0;
+    for (int i = 0; i < 8; ++i) h = (h << 8) | p[i];
+    return h;
+}
+
+static void writeUInt64(uint8_t *p, uint64_t h)
+{
+    for (int i = 7; i >= 0; --i, h >>= 8) p[i] = h;
+}
+
+#if defined __x86_64__ || defined __i386__
+
+static bool detectPclmul()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+}
+
+bool usePclmul = detectPclmul();
+
+/** Multiply \a a by \a b in GF(2^128) (both operands byte-reflected, see Intel's carry-less multiplication white paper)
+  */
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i multiplyNi(__m128i a, __m128i b)
+{
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t4 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t5 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t6 = _mm_clmulepi64_si128(a, b, 0x11);
+
+    t4 = _mm_xor_si128(t4, t5);
+    t5 = _mm_slli_si128(t4, 8);
+    t4 = _mm_srli_si128(t4, 8);
+    t3 = _mm_xor_si128(t3, t5);
+    t6 = _mm_xor_si128(t6, t4);
+
+    // shift the 256 bit product left by one bit
+
+    __m128i t7 = _mm_srli_epi32(t3, 31);
+    __m128i t8 = _mm_srli_epi32(t6, 31);
+    t3 = _mm_slli_epi32(t3, 1);
+    t6 = _mm_slli_epi32(t6, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    t3 = _mm_or_si128(t3, t7);
+    t6 = _mm_or_si128(t6, t8);
+    t6 = _mm_or_si128(t6, t9);
+
+    // reduce modulo x^128 + x^7 + x^2 + x + 1
+
+    t7 = _mm_slli_epi32(t3, 31);
+    t8 = _mm_slli_epi32(t3, 30);
+    t9 = _mm_slli_epi32(t3, 25);
+    t7 = _mm_xor_si128(t7, t8);
+    t7 = _mm_xor_si128(t7, t9);
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    t3 = _mm_xor_si128(t3, t7);
+
+    __m128i t2 = _mm_srli_epi32(t3, 1);
+    t4 = _mm_srli_epi32(t3, 2);
+    t5 = _mm_srli_epi32(t3, 7);
+    t2 = _mm_xor_si128(t2, t4);
+    t2 = _mm_xor_si128(t2, t5);
+    t2 = _mm_xor_si128(t2, t8);
+    t3 = _mm_xor_si128(t3, t2);
+
+    return _mm_xor_si128(t6, t3);
+}
+
+/** Compute the powers H^1 to H^4 of the hash subkey \a h (byte-reflected)
+  */
+__attribute__((target("pclmul,ssse3")))
+static void powersNi(const uint8_t *h, uint8_t *hp)
+{
+    const __m128i reflect = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i *dst = reinterpret_cast<__m128i *>(hp);
+    const __m128i h1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h)), reflect);
+    __m128i hn = h1;
+    _mm_storeu_si128(dst, hn);
+    for (int i = 1; i < 4; ++i) {
+        hn = multiplyNi(hn, h1);
+        _mm_storeu_si128(dst + i, hn);
+    }
+}
+
+__attribute__((target("pclmul,ssse3")))
+static void ghashNi(uint8_t *x, const uint8_t *hp, const uint8_t *data, long n)
+{
+    const __m128i reflect = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i *src = reinterpret_cast<const __m128i *>(data);
+    const __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hp));
+    __m128i y = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x)), reflect);
+
+    long i = 0;
+
+    if (n >= 4) { // aggregate four blocks: Y' = (Y + X1) H^4 + X2 H^3 + X3 H^2 + X4 H
+        const __m128i h2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hp) + 1);
+        const __m128i h3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hp) + 2);
+        const __m128i h4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hp) + 3);
+
+        for (; i + 4 <= n; i += 4) {
+            __m128i a = multiplyNi(_mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(src + i), reflect)), h4);
+            __m128i b = multiplyNi(_mm_shuffle_epi8(_mm_loadu_si128(src + i + 1), reflect), h3);
+            __m128i c = multiplyNi(_mm_shuffle_epi8(_mm_loadu_si128(src + i + 2), reflect), h2);
+            __m128i d = multiplyNi(_mm_shuffle_epi8(_mm_loadu_si128(src + i + 3), reflect), h1);
+            y = _mm_xor_si128(_mm_xor_si128(a, b), _mm_xor_si128(c, d));
+        }
+    }
+
+    for (; i < n; ++i) {
+        y = multiplyNi(_mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(src + i), reflect)), h1);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(x), _mm_shuffle_epi8(y, reflect));
+}
+
+#else
+
+bool usePclmul = false;
+
+#endif
+
+} // namespace gcm
+
+using namespace gcm;
+
+struct GcmBlockCipher::State: public BlockCipher::State
+{
+    static constexpr int KeyStreamBlocks = 32;
+
+    State(const BlockCipher &cipher, const Bytes &iv, const Bytes &aad):
+        BlockCipher::State{1},
+        cipher_{cipher},
+        ni_{usePclmul}
+    {
+        assert(cipher.blockSize() == BlockSize);
+        assert(iv.count() > 0);
+
+        std::memset(h_, 0, BlockSize);
+        {
+            Bytes h = Bytes::allocate(BlockSize);
+            h.fill(0);
+            cipher_.encode(h, &h);
+            std::memcpy(h_, h.bytes(), BlockSize);
+            h.fill(0);
+        }
+
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) powersNi(h_, hp_);
+        #endif
+
+        if (!ni_) {
+            uint64_t vh = readUInt64(h_);
+            uint64_t vl = readUInt64(h_ + 8);
+            hl_[0] = hh_[0] = 0;
+            hl_[8] = vl;
+            hh_[8] = vh;
+            for (int i = 4; i > 0; i >>= 1) {
+                uint64_t t = (vl & 1) * 0xE1000000U;
+                vl = (vh << 63) | (vl >> 1);
+                vh = (vh >> 1) ^ (t << 32);
+                hl_[i] = vl;
+                hh_[i] = vh;
+            }
+            for (int i = 2; i <= 8; i *= 2) {
+                for (int j = 1; j < i; ++j) {
+                    hh_[i + j] = hh_[i] ^ hh_[j];
+                    hl_[i + j] = hl_[i] ^ hl_[j];
+                }
+            }
+        }
+
+        // derive the pre-counter block J0 from the initialization vector
+
+        uint8_t j0[BlockSize] = {};
+
+        if (iv.count() == 12) {
+            std::memcpy(j0, iv.bytes(), 12);
+            j0[15] = 1;
+        }
+        else {
+            ghashPadded(j0, iv.bytes(), iv.count());
+            uint8_t lengths[BlockSize] = {};
+            writeUInt64(lengths + 8, uint64_t(iv.count()) * 8);
+            ghash(j0, lengths, 1);
+        }
+
+        {
+            Bytes s = Bytes::allocate(BlockSize);
+            std::memcpy(s.bytes(), j0, BlockSize);
+            cipher_.encode(s, &s);
+            std::memcpy(ej0_, s.bytes(), BlockSize);
+        }
+
+        std::memcpy(counter_, j0, BlockSize);
+        increment(counter_);
+
+        // authenticate the additional data
+
+        std::memset(x_, 0, BlockSize);
+        ghashPadded(x_, aad.bytes(), aad.count());
+        aadLength_ = aad.count();
+    }
+
+    ~State()
+    {
+        std::memset(h_, 0, BlockSize);
+        std::memset(hp_, 0, sizeof(hp_));
+        std::memset(hl_, 0, sizeof(hl_));
+        std::memset(hh_, 0, sizeof(hh_));
+        keyStream_.fill(0);
+    }
+
+    void encode(const Bytes &p, Out<Bytes> c) override
+    {
+        crypt(p.bytes(), c->bytes(), p.count());
+        absorb(c->bytes(), c->count());
+    }
+
+    void decode(const Bytes &c, Out<Bytes> p) override
+    {
+        absorb(c.bytes(), c.count());
+        crypt(c.bytes(), p->bytes(), c.count());
+    }
+
+    Bytes tag() const
+    {
+        uint8_t y[BlockSize];
+        std::memcpy(y, x_, BlockSize);
+
+        if (partialFill_ > 0) ghashPadded(y, partial_, partialFill_);
+
+        uint8_t lengths[BlockSize];
+        writeUInt64(lengths, aadLength_ * 8);
+        writeUInt64(lengths + 8, textLength_ * 8);
+        ghash(y, lengths, 1);
+
+        Bytes t = Bytes::allocate(TagSize);
+        for (int i = 0; i < TagSize; ++i) t[i] = y[i] ^ ej0_[i];
+        return t;
+    }
+
+    static void increment(uint8_t *counter)
+    {
+        for (int j = BlockSize - 1; j >= BlockSize - 4; --j) {
+            if (++counter[j] != 0) break;
+        }
+    }
+
+    void crypt(const uint8_t *src, uint8_t *dst, long n)
+    {
+        for (long i = 0; i < n;) {
+            if (k_ == keyStream_.count()) generate();
+            const uint8_t *ks = keyStream_.bytes() + k_;
+            long m = keyStream_.count() - k_;
+            if (n - i < m) m = n - i;
+            long j = 0;
+            for (; j + 8 <= m; j += 8) {
+                uint64_t a, b;
+                std::memcpy(&a, src + i + j, 8);
+                std::memcpy(&b, ks + j, 8);
+                a ^= b;
+                std::memcpy(dst + i + j, &a, 8);
+            }
+            for (; j < m; ++j) dst[i + j] = src[i + j] ^ ks[j];
+            i += m;
+            k_ += m;
+        }
+    }
+
+    void generate()
+    {
+        uint8_t *blocks = counterBlocks_.bytes();
+
+        for (int b = 0; b < KeyStreamBlocks; ++b) {
+            std::memcpy(blocks + b * BlockSize, counter_, BlockSize);
+            increment(counter_);
+        }
+
+        cipher_.encode(counterBlocks_, &keyStream_);
+        k_ = 0;
+    }
+
+    void absorb(const uint8_t *data, long n)
+    {
+        textLength_ += n;
+
+        long i = 0;
+
+        if (partialFill_ > 0) {
+            while (i < n && partialFill_ < BlockSize) partial_[partialFill_++] = data[i++];
+            if (partialFill_ < BlockSize) return;
+            ghash(x_, partial_, 1);
+            partialFill_ = 0;
+        }
+
+        const long m = (n - i) / BlockSize;
+        ghash(x_, data + i, m);
+        i += m * BlockSize;
+
+        while (i < n) partial_[partialFill_++] = data[i++];
+    }
+
+    void ghash(uint8_t *x, const uint8_t *data, long n) const
+    {
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            ghashNi(x, hp_, data, n);
+            return;
+        }
+        #endif
+
+        for (long i = 0; i < n; ++i) {
+            for (int j = 0; j < BlockSize; ++j) x[j] ^= data[i * BlockSize + j];
+            multiply(x, hl_, hh_);
+        }
+    }
+
+    void ghashPadded(uint8_t *x, const uint8_t *data, long n) const
+    {
+        ghash(x, data, n / BlockSize);
+        if (n % BlockSize != 0) {
+            uint8_t last[BlockSize] = {};
+            std::memcpy(last, data + n - n % BlockSize, n % BlockSize);
+            ghash(x, last, 1);
+        }
+    }
+
+    BlockCipher cipher_;
+    bool ni_;
+    uint8_t h_[BlockSize]; ///< hash subkey H
+    uint8_t hp_[4 * BlockSize]; ///< powers of H (byte-reflected, for PCLMULQDQ)
+    uint64_t hl_[16]; ///< multiplication table (low half)
+    uint64_t hh_[16]; ///< multiplication table (high half)
+    uint8_t ej0_[BlockSize]; ///< enciphered pre-counter block
+    uint8_t x_[BlockSize]; ///< GHASH accumulator
+    uint8_t partial_[BlockSize]; ///< incomplete ciphertext block
+    int partialFill_ { 0 };
+    uint64_t aadLength_ { 0 };
+    uint64_t textLength_ { 0 };
+    uint8_t counter_[BlockSize]; ///< next counter block
+    Bytes counterBlocks_ { Bytes::allocate(KeyStreamBlocks * BlockSize) };
+    Bytes keyStream_ { Bytes::allocate(KeyStreamBlocks * BlockSize) };
+    long k_ { KeyStreamBlocks * BlockSize }; ///< consume offset in key stream
+};
+
+GcmBlockCipher::GcmBlockCipher(const BlockCipher &cipher, const Bytes &iv, const Bytes &aad):
+    BlockCipher{new State{cipher, iv, aad}}
+{}
+
+Bytes GcmBlockCipher::tag() const
+{
+    return me().tag();
+}
+
+bool GcmBlockCipher::verify(const Bytes &tag) const
+{
+    if (tag.count() < 12 || tag.count() > TagSize) return false;
+
+    Bytes expected = me().tag();
+    uint8_t d = 0;
+    for (long i = 0; i < tag.count(); ++i) d |= tag[i] ^ expected[i];
+    return d == 0;
+}
+
+const GcmBlockCipher::State &GcmBlockCipher::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
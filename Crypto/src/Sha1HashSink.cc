@@ -7,21 +7,149 @@
  */
 
 #include <cc/Sha1HashSink>
+#include <cc/ShaDispatch>
 #include <bit>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
+static const uint32_t sha1Start[5] = {
+    0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+static const uint32_t sha1Key[4] = {
+    0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6
+};
+
+#if defined __x86_64__ || defined __i386__
+
+/** Compress \a n consecutive blocks using the SHA extensions (SHA-NI)
+  */
+__attribute__((target("sha,sse4.1")))
+static void sha1CompressNi(uint32_t *h, const uint8_t *data, long n)
+{
+    const __m128i reorder = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h)), 0x1B);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(h[4]), 0, 0, 0);
+
+    for (long i = 0; i < n; ++i, data += 64) {
+        const __m128i abcdSaved = abcd;
+        const __m128i e0Saved = e0;
+        __m128i e1;
+        __m128i m[4];
+
+        #pragma GCC unroll 20
+        for (int g = 0; g < 20; ++g) { // rounds 4 g to 4 g + 3
+            __m128i &e = (g & 1) ? e1 : e0;
+            __m128i &eNext = (g & 1) ? e0 : e1;
+
+            if (g < 4) m[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + g), reorder);
+
+            if (g == 0) e = _mm_add_epi32(e, m[0]);
+            else e = _mm_sha1nexte_epu32(e, m[g & 3]);
+
+            eNext = abcd;
+
+            if (3 <= g && g <= 18) m[(g + 1) & 3] = _mm_sha1msg2_epu32(m[(g + 1) & 3], m[g & 3]);
+
+            switch (g / 5) {
+                case 0: abcd = _mm_sha1rnds4_epu32(abcd, e, 0); break;
+                case 1: abcd = _mm_sha1rnds4_epu32(abcd, e, 1); break;
+                case 2: abcd = _mm_sha1rnds4_epu32(abcd, e, 2); break;
+                default: abcd = _mm_sha1rnds4_epu32(abcd, e, 3); break;
+            }
+
+            if (1 <= g && g <= 16) m[(g - 1) & 3] = _mm_sha1msg1_epu32(m[(g - 1) & 3], m[g & 3]);
+            if (2 <= g && g <= 17) m[(g - 2) & 3] = _mm_xor_si128(m[(g - 2) & 3], m[g & 3]);
+        }
+
+        e0 = _mm_sha1nexte_epu32(e0, e0Saved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(h), _mm_shuffle_epi32(abcd, 0x1B));
+    h[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i rotl8x32(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+/** Compress one block for each of eight independent messages (AVX2)
+  */
+__attribute__((target("avx2")))
+static void sha1CompressLanes(uint32_t *state, const uint8_t *const *blocks)
+{
+    const __m256i reorder = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+    );
+
+    __m256i *s = reinterpret_cast<__m256i *>(state);
+    __m256i a = _mm256_loadu_si256(s);
+    __m256i b = _mm256_loadu_si256(s + 1);
+    __m256i c = _mm256_loadu_si256(s + 2);
+    __m256i d = _mm256_loadu_si256(s + 3);
+    __m256i e = _mm256_loadu_si256(s + 4);
+
+    __m256i w[16];
+
+    for (int t = 0; t < 16; ++t) {
+        uint32_t x[8];
+        for (int l = 0; l < 8; ++l) std::memcpy(x + l, blocks[l] + 4 * t, 4);
+        w[t] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x)), reorder);
+    }
+
+    for (int t = 0; t < 80; ++t) {
+        if (t >= 16) {
+            w[t & 15] = rotl8x32(
+                _mm256_xor_si256(
+                    _mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]),
+                    _mm256_xor_si256(w[(t - 14) & 15], w[t & 15])
+                ),
+                1
+            );
+        }
+
+        __m256i f;
+        if (t < 20) f = _mm256_xor_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+        else if (t < 40 || t >= 60) f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+        else f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+
+        const __m256i temp = _mm256_add_epi32(
+            _mm256_add_epi32(rotl8x32(a, 5), f),
+            _mm256_add_epi32(_mm256_add_epi32(e, w[t & 15]), _mm256_set1_epi32(static_cast<int>(sha1Key[t / 20])))
+        );
+
+        e = d;
+        d = c;
+        c = rotl8x32(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    _mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s), a));
+    _mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1), b));
+    _mm256_storeu_si256(s + 2, _mm256_add_epi32(_mm256_loadu_si256(s + 2), c));
+    _mm256_storeu_si256(s + 3, _mm256_add_epi32(_mm256_loadu_si256(s + 3), d));
+    _mm256_storeu_si256(s + 4, _mm256_add_epi32(_mm256_loadu_si256(s + 4), e));
+}
+
+#endif // defined __x86_64__ || defined __i386__
+
 struct Sha1HashSink::State final: public CryptoHashSink::State
 {
     static constexpr int BlockSize = 64;
 
     State()
     {
-        h_.wordAt(0) = 0x67452301;
-        h_.wordAt(1) = 0xEFCDAB89;
-        h_.wordAt(2) = 0x98BADCFE;
-        h_.wordAt(3) = 0x10325476;
-        h_.wordAt(4) = 0xC3D2E1F0;
+        for (int i = 0; i < 5; ++i) h_.wordAt(i) = sha1Start[i];
     }
 
     int blockSize() const override { return BlockSize; }
@@ -39,11 +167,32 @@ struct Sha1HashSink::State final: public CryptoHashSink::State
     void write(const Bytes &data, long fill = -1) override
     {
         if (fill < 0) fill = data.count();
-        for (long i = 0; i < fill; ++i) {
-            uint8_t b = data.byteAt(i);
-            m_.byteAt(j_++) = b;
-            if (j_ == 64) consume();
+
+        const uint8_t *p = data.bytes();
+        long i = 0;
+
+        if (j_ > 0) {
+            i = BlockSize - j_;
+            if (i > fill) i = fill;
+            std::memcpy(m_.bytes() + j_, p, i);
+            j_ += i;
+            if (j_ < BlockSize) {
+                l_ += uint64_t(fill) * 8;
+                return;
+            }
+            consume(m_.bytes(), 1);
+            j_ = 0;
+        }
+
+        const long n = (fill - i) / BlockSize;
+        if (n > 0) {
+            consume(p + i, n);
+            i += n * BlockSize;
         }
+
+        j_ = fill - i;
+        if (j_ > 0) std::memcpy(m_.bytes(), p + i, j_);
+
         l_ += uint64_t(fill) * 8;
     }
 
@@ -76,16 +225,34 @@ struct Sha1HashSink::State final: public CryptoHashSink::State
 
     void consume()
     {
+        consume(m_.bytes(), 1);
         j_ = 0;
+    }
+
+    void consume(const uint8_t *data, long n)
+    {
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            sha1CompressNi(h_.words(), data, n);
+            return;
+        }
+        #endif
+
+        for (long i = 0; i < n; ++i) {
+            compress(data + i * BlockSize);
+        }
+    }
 
+    void compress(const uint8_t *block)
+    {
         uint32_t *w = w_.words();
 
         for (int t = 0; t < 16; ++t) {
             w[t] =
-                uint32_t(m_.byteAt(4 * t) << 24) |
-                uint32_t(m_.byteAt(4 * t + 1) << 16) |
-                uint32_t(m_.byteAt(4 * t + 2) << 8) |
-                uint32_t(m_.byteAt(4 * t + 3));
+                uint32_t(block[4 * t] << 24) |
+                uint32_t(block[4 * t + 1] << 16) |
+                uint32_t(block[4 * t + 2] << 8) |
+                uint32_t(block[4 * t + 3]);
         }
 
         for (int t = 16; t < 80; ++t) {
@@ -114,10 +281,7 @@ struct Sha1HashSink::State final: public CryptoHashSink::State
 
     static uint32_t K(int t)
     {
-        if (t < 20) return 0x5A827999;
-        if (t < 40) return 0x6ED9EBA1;
-        if (t < 60) return 0x8F1BBCDC;
-        return 0xCA62C1D6;
+        return sha1Key[t / 20];
     }
 
     static uint32_t f(int t, uint32_t b, uint32_t c, uint32_t d)
@@ -133,6 +297,7 @@ struct Sha1HashSink::State final: public CryptoHashSink::State
     Bytes w_ { Bytes::allocate(320) };
     int j_ { 0 };
     uint64_t l_ { 0 };
+    bool ni_ { sha::useShaNi };
 };
 
 Sha1HashSink::Sha1HashSink():
@@ -146,4 +311,20 @@ Bytes sha1(const Bytes &data)
     return sink.finish();
 }
 
+List<Bytes> sha1(const List<Bytes> &messages)
+{
+    #if defined __x86_64__ || defined __i386__
+    if (sha::useShaNi) {
+        return sha::hashEach(messages, 5, sha1Start, sha1CompressNi);
+    }
+    if (sha::useAvx2) {
+        return sha::hashLanes(messages, 5, sha1Start, sha1CompressLanes);
+    }
+    #endif
+
+    List<Bytes> digests;
+    for (const Bytes &message: messages) digests.append(sha1(message));
+    return digests;
+}
+
 } // namespace cc
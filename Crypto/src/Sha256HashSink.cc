@@ -7,25 +7,157 @@
  */
 
 #include <cc/Sha256HashSink>
-#include <array>
+#include <cc/ShaDispatch>
 #include <bit>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
+alignas(16) static const uint32_t sha256Key[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t sha256Start[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+#if defined __x86_64__ || defined __i386__
+
+/** Compress \a n consecutive blocks using the SHA extensions (SHA-NI)
+  */
+__attribute__((target("sha,sse4.1")))
+static void sha256CompressNi(uint32_t *h, const uint8_t *data, long n)
+{
+    const __m128i reorder = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i t = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h)), 0xB1); // CDAB
+    __m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h + 4)), 0x1B); // EFGH
+    __m128i s0 = _mm_alignr_epi8(t, s1, 8); // ABEF
+    s1 = _mm_blend_epi16(s1, t, 0xF0); // CDGH
+
+    for (long i = 0; i < n; ++i, data += 64) {
+        const __m128i s0Saved = s0;
+        const __m128i s1Saved = s1;
+        __m128i m[4];
+
+        #pragma GCC unroll 16
+        for (int g = 0; g < 16; ++g) { // rounds 4 g to 4 g + 3
+            if (g < 4) m[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + g), reorder);
+            __m128i k = _mm_add_epi32(m[g & 3], _mm_load_si128(reinterpret_cast<const __m128i *>(sha256Key) + g));
+            s1 = _mm_sha256rnds2_epu32(s1, s0, k);
+            if (3 <= g && g <= 14) {
+                __m128i &next = m[(g + 1) & 3];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(m[g & 3], m[(g - 1) & 3], 4));
+                next = _mm_sha256msg2_epu32(next, m[g & 3]);
+            }
+            s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(k, 0x0E));
+            if (1 <= g && g <= 12) {
+                m[(g - 1) & 3] = _mm_sha256msg1_epu32(m[(g - 1) & 3], m[g & 3]);
+            }
+        }
+
+        s0 = _mm_add_epi32(s0, s0Saved);
+        s1 = _mm_add_epi32(s1, s1Saved);
+    }
+
+    t = _mm_shuffle_epi32(s0, 0x1B); // FEBA
+    s1 = _mm_shuffle_epi32(s1, 0xB1); // DCHG
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(h), _mm_blend_epi16(t, s1, 0xF0)); // DCBA
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(h + 4), _mm_alignr_epi8(s1, t, 8)); // HGFE
+}
+
+__attribute__((target("avx2")))
+static inline __m256i rotr8x32(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+/** Compress one block for each of eight independent messages (AVX2)
+  */
+__attribute__((target("avx2")))
+static void sha256CompressLanes(uint32_t *state, const uint8_t *const *blocks)
+{
+    const __m256i reorder = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+    );
+
+    __m256i *s = reinterpret_cast<__m256i *>(state);
+    __m256i a = _mm256_loadu_si256(s);
+    __m256i b = _mm256_loadu_si256(s + 1);
+    __m256i c = _mm256_loadu_si256(s + 2);
+    __m256i d = _mm256_loadu_si256(s + 3);
+    __m256i e = _mm256_loadu_si256(s + 4);
+    __m256i f = _mm256_loadu_si256(s + 5);
+    __m256i g = _mm256_loadu_si256(s + 6);
+    __m256i h = _mm256_loadu_si256(s + 7);
+
+    __m256i w[16];
+
+    for (int t = 0; t < 16; ++t) {
+        uint32_t x[8];
+        for (int l = 0; l < 8; ++l) std::memcpy(x + l, blocks[l] + 4 * t, 4);
+        w[t] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x)), reorder);
+    }
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr8x32(w2, 17), rotr8x32(w2, 19)), _mm256_srli_epi32(w2, 10));
+            const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr8x32(w15, 7), rotr8x32(w15, 18)), _mm256_srli_epi32(w15, 3));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(sigma1, w[(t - 7) & 15]), _mm256_add_epi32(sigma0, w[t & 15]));
+        }
+
+        const __m256i upperSigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr8x32(e, 6), rotr8x32(e, 11)), rotr8x32(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(h, upperSigma1), _mm256_add_epi32(ch, w[t & 15])),
+            _mm256_set1_epi32(static_cast<int>(sha256Key[t]))
+        );
+        const __m256i upperSigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr8x32(a, 2), rotr8x32(a, 13)), rotr8x32(a, 22));
+        const __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, _mm256_xor_si256(b, c)), _mm256_and_si256(b, c));
+        const __m256i t2 = _mm256_add_epi32(upperSigma0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    _mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s), a));
+    _mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1), b));
+    _mm256_storeu_si256(s + 2, _mm256_add_epi32(_mm256_loadu_si256(s + 2), c));
+    _mm256_storeu_si256(s + 3, _mm256_add_epi32(_mm256_loadu_si256(s + 3), d));
+    _mm256_storeu_si256(s + 4, _mm256_add_epi32(_mm256_loadu_si256(s + 4), e));
+    _mm256_storeu_si256(s + 5, _mm256_add_epi32(_mm256_loadu_si256(s + 5), f));
+    _mm256_storeu_si256(s + 6, _mm256_add_epi32(_mm256_loadu_si256(s + 6), g));
+    _mm256_storeu_si256(s + 7, _mm256_add_epi32(_mm256_loadu_si256(s + 7), h));
+}
+
+#endif // defined __x86_64__ || defined __i386__
+
 struct Sha256HashSink::State final: public CryptoHashSink::State
 {
     static constexpr int BlockSize = 64;
 
     State()
     {
-        hash_.wordAt(0) = 0x6a09e667;
-        hash_.wordAt(1) = 0xbb67ae85;
-        hash_.wordAt(2) = 0x3c6ef372;
-        hash_.wordAt(3) = 0xa54ff53a;
-        hash_.wordAt(4) = 0x510e527f;
-        hash_.wordAt(5) = 0x9b05688c;
-        hash_.wordAt(6) = 0x1f83d9ab;
-        hash_.wordAt(7) = 0x5be0cd19;
+        for (int i = 0; i < 8; ++i) hash_.wordAt(i) = sha256Start[i];
     }
 
     int blockSize() const override { return BlockSize; }
@@ -43,27 +175,67 @@ struct Sha256HashSink::State final: public CryptoHashSink::State
     void write(const Bytes &data, long fill = -1) override
     {
         if (fill < 0) fill = data.count();
-        for (long i = 0; i < fill; ++i) {
-            block_.byteAt(j_++) = data.byteAt(i);
-            if (j_ == 64) consume();
+
+        const uint8_t *p = data.bytes();
+        long i = 0;
+
+        if (j_ > 0) {
+            i = BlockSize - j_;
+            if (i > fill) i = fill;
+            std::memcpy(block_.bytes() + j_, p, i);
+            j_ += i;
+            if (j_ < BlockSize) {
+                l_ += fill;
+                return;
+            }
+            consume(block_.bytes(), 1);
+            j_ = 0;
+        }
+
+        const long n = (fill - i) / BlockSize;
+        if (n > 0) {
+            consume(p + i, n);
+            i += n * BlockSize;
         }
+
+        j_ = fill - i;
+        if (j_ > 0) std::memcpy(block_.bytes(), p + i, j_);
+
         l_ += fill;
     }
 
     void consume()
     {
+        consume(block_.bytes(), 1);
         j_ = 0;
+    }
 
-        const auto &K = key_;
+    void consume(const uint8_t *data, long n)
+    {
+        #if defined __x86_64__ || defined __i386__
+        if (ni_) {
+            sha256CompressNi(hash_.words(), data, n);
+            return;
+        }
+        #endif
+
+        for (long i = 0; i < n; ++i) {
+            compress(data + i * BlockSize);
+        }
+    }
+
+    void compress(const uint8_t *block)
+    {
+        const auto &K = sha256Key;
         uint32_t * const W = sched_.words();
         uint32_t * const H = hash_.words();
 
         for (int t = 0; t < 16; ++t) {
             W[t] =
-                uint32_t(block_.byteAt(4 * t) << 24) |
-                uint32_t(block_.byteAt(4 * t + 1) << 16) |
-                uint32_t(block_.byteAt(4 * t + 2) << 8) |
-                uint32_t(block_.byteAt(4 * t + 3));
+                uint32_t(block[4 * t] << 24) |
+                uint32_t(block[4 * t + 1] << 16) |
+                uint32_t(block[4 * t + 2] << 8) |
+                uint32_t(block[4 * t + 3]);
         }
 
         for (int t = 16; t < 64; ++t) {
@@ -162,22 +334,12 @@ struct Sha256HashSink::State final: public CryptoHashSink::State
         return std::rotr(x, 17) xor std::rotr(x, 19) xor (x >> 10);
     }
 
-    std::array<uint32_t, 64> key_ {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
-
     Bytes hash_ { Bytes::allocate(32) };
     Bytes block_ { Bytes::allocate(64) };
     Bytes sched_ { Bytes::allocate(256) };
     int j_ { 0 };
     int64_t l_ { 0 };
+    bool ni_ { sha::useShaNi };
 };
 
 Sha256HashSink::Sha256HashSink():
@@ -191,4 +353,20 @@ Bytes sha256(const Bytes &data)
     return sink.finish();
 }
 
+List<Bytes> sha256(const List<Bytes> &messages)
+{
+    #if defined __x86_64__ || defined __i386__
+    if (sha::useShaNi) {
+        return sha::hashEach(messages, 8, sha256Start, sha256CompressNi);
+    }
+    if (sha::useAvx2) {
+        return sha::hashLanes(messages, 8, sha256Start, sha256CompressLanes);
+    }
+    #endif
+
+    List<Bytes> digests;
+    for (const Bytes &message: messages) digests.append(sha256(message));
+    return digests;
+}
+
 } // namespace cc
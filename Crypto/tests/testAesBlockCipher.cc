@@ -7,6 +7,8 @@
  */
 
 #include <cc/AesBlockCipher>
+#include <cc/AesDispatch>
+#include <cc/Random>
 #include <cc/testing>
 
 namespace cc::aes { Bytes keyExpansion(const Bytes &key, int Nr = -1); }
@@ -151,5 +153,36 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "AesCipherHardwareAcceleration",
+        []{
+            if (!aes::useAesNi) return;
+
+            Random random{7};
+            Bytes text = Bytes::allocate(16 * 67);
+            for (long i = 0; i < text.count(); ++i) text[i] = random.get() & 0xFF;
+
+            for (int keySize: { 16, 24, 32 }) {
+                Bytes key = text.copy(0, keySize);
+
+                aes::useAesNi = false;
+                AesBlockCipher portable{key};
+                aes::useAesNi = true;
+                AesBlockCipher accelerated{key};
+
+                Bytes c1 = Bytes::allocate(text.count());
+                Bytes c2 = Bytes::allocate(text.count());
+                portable.encode(text, &c1);
+                accelerated.encode(text, &c2);
+                CC_CHECK(c1 == c2);
+
+                accelerated.decode(c2, &c2);
+                CC_CHECK(c2 == text);
+                portable.decode(c1, &c1);
+                CC_CHECK(c1 == text);
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/AesBlockCipher>
+#include <cc/CbcBlockCipher>
+#include <cc/CtrBlockCipher>
+#include <cc/GcmBlockCipher>
+#include <cc/GcmDispatch>
+#include <cc/Random>
+#include <cc/str>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    struct Test {
+        static Bytes random(long n, uint32_t seed)
+        {
+            Random random{seed};
+            Bytes data = Bytes::allocate(n);
+            for (long i = 0; i < n; ++i) data[i] = random.get() & 0xFF;
+            return data;
+        }
+
+        static String gcmEncode(const String &k, const String &iv, const String &p, const String &a, Out<String> t = None{})
+        {
+            GcmBlockCipher cipher{AesBlockCipher{readHex(k)}, readHex(iv), readHex(a)};
+            Bytes data = readHex(p);
+            cipher.encode(data, &data);
+            t << hex(cipher.tag(), 'a');
+            return hex(data, 'a');
+        }
+    };
+
+    TestCase {
+        "CbcModeMultipleBlocks",
+        []{
+            Bytes key = Test::random(16, 1);
+            Bytes iv = Test::random(16, 2);
+            Bytes text = Test::random(16 * 37, 3);
+
+            Bytes c1 = Bytes::allocate(text.count());
+            {
+                CbcBlockCipher cipher{AesBlockCipher{key}, iv};
+                for (long i = 0; i < text.count(); i += 16) {
+                    Bytes c = c1.select(i, i + 16);
+                    cipher.encode(text.select(i, i + 16), &c);
+                }
+            }
+
+            Bytes c2 = text.copy();
+            CbcBlockCipher{AesBlockCipher{key}, iv}.encode(c2, &c2);
+            CC_CHECK(c1 == c2);
+
+            CbcBlockCipher{AesBlockCipher{key}, iv}.decode(c2, &c2);
+            CC_CHECK(c2 == text);
+        }
+    };
+
+    TestCase {
+        "CtrModeNistVector",
+        []{
+            // NIST SP 800-38A, F.5.1 CTR-AES128.Encrypt
+            CtrBlockCipher cipher {
+                AesBlockCipher{readHex("2b7e151628aed2a6abf7158809cf4f3c")},
+                readHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff")
+            };
+            Bytes data = readHex(
+                "6bc1bee22e409f96e93d7e117393172a"
+                "ae2d8a571e03ac9c9eb76fac45af8e51"
+                "30c81c46a35ce411e5fbc1191a0a52ef"
+                "f69f2445df4f9b17ad2b417be66c3710"
+            );
+            cipher.encode(data, &data);
+            CC_CHECK(hex(data, 'a') ==
+                "874d6191b620e3261bef6864990db6ce"
+                "9806f66b7970fdff8617187bb9fffdff"
+                "5ae4df3edbd5d35e5b4f09020db03eab"
+                "1e031dda2fbe03d1792170a0f3009cee"
+            );
+        }
+    };
+
+    TestCase {
+        "CtrModeArbitrarySplits",
+        []{
+            Bytes key = Test::random(32, 1);
+            Bytes start = Test::random(16, 2);
+            Bytes text = Test::random(0x2345, 3);
+
+            Bytes c1 = text.copy();
+            CtrBlockCipher{AesBlockCipher{key}, start}.encode(c1, &c1);
+
+            Bytes c2 = Bytes::allocate(text.count());
+            {
+                CtrBlockCipher cipher{AesBlockCipher{key}, start};
+                Random random{4};
+                for (long i = 0; i < text.count();) {
+                    long n = random.get(0, 777);
+                    if (i + n > text.count()) n = text.count() - i;
+                    Bytes c = c2.select(i, i + n);
+                    cipher.encode(text.select(i, i + n), &c);
+                    i += n;
+                }
+            }
+            CC_CHECK(c1 == c2);
+
+            CtrBlockCipher{AesBlockCipher{key}, start}.decode(c2, &c2);
+            CC_CHECK(c2 == text);
+        }
+    };
+
+    TestCase {
+        "GcmModeTestVectors",
+        []{
+            // test cases 1 to 6 of "The Galois/Counter Mode of Operation (GCM)" by D. McGrew and J. Viega
+
+            String t;
+
+            CC_CHECK(Test::gcmEncode("00000000000000000000000000000000", "000000000000000000000000", "", "", &t) == "");
+            CC_CHECK(t == "58e2fccefa7e3061367f1d57a4e7455a");
+
+            CC_CHECK(
+                Test::gcmEncode(
+                    "00000000000000000000000000000000",
+                    "000000000000000000000000",
+                    "00000000000000000000000000000000",
+                    "",
+                    &t
+                ) == "0388dace60b6a392f328c2b971b2fe78"
+            );
+            CC_CHECK(t == "ab6e47d42cec13bdf53a67b21257bddf");
+
+            const String k = "feffe9928665731c6d6a8f9467308308";
+            const String p =
+                "d9313225f88406e5a55909c5aff5269a"
+                "86a7a9531534f7da2e4c303d8a318a72"
+                "1c3c0c95956809532fcf0e2449a6b525"
+                "b16aedf5aa0de657ba637b391aafd255";
+            const String p60 = p.copy(0, 120);
+            const String a = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+
+            CC_CHECK(
+                Test::gcmEncode(k, "cafebabefacedbaddecaf888", p, "", &t) ==
+                "42831ec2217774244b7221b784d0d49c"
+                "e3aa212f2c02a4e035c17e2329aca12e"
+                "21d514b25466931c7d8f6a5aac84aa05"
+                "1ba30b396a0aac973d58e091473f5985"
+            );
+            CC_CHECK(t == "4d5c2af327cd64a62cf35abd2ba6fab4");
+
+            CC_CHECK(
+                Test::gcmEncode(k, "cafebabefacedbaddecaf888", p60, a, &t) ==
+                "42831ec2217774244b7221b784d0d49c"
+                "e3aa212f2c02a4e035c17e2329aca12e"
+                "21d514b25466931c7d8f6a5aac84aa05"
+                "1ba30b396a0aac973d58e091"
+            );
+            CC_CHECK(t == "5bc94fbc3221a5db94fae95ae7121a47");
+
+            CC_CHECK(
+                Test::gcmEncode(k, "cafebabefacedbad", p60, a, &t) ==
+                "61353b4c2806934a777ff51fa22a4755"
+                "699b2a714fcdc6f83766e5f97b6c7423"
+                "73806900e49f24b22b097544d4896b42"
+                "4989b5e1ebac0f07c23f4598"
+            );
+            CC_CHECK(t == "3612d2e79e3b0785561be14aaca2fccb");
+
+            CC_CHECK(
+                Test::gcmEncode(
+                    k,
+                    "9313225df88406e555909c5aff5269aa"
+                    "6a7a9538534f7da1e4c303d2a318a728"
+                    "c3c0c95156809539fcf0e2429a6b5254"
+                    "16aedbf5a0de6a57a637b39b",
+                    p60, a, &t
+                ) ==
+                "8ce24998625615b603a033aca13fb894"
+                "be9112a5c3a211a8ba262a3cca7e2ca7"
+                "01e4a9a4fba43c90ccdcb281d48c7c6f"
+                "d62875d2aca417034c34aee5"
+            );
+            CC_CHECK(t == "619cc5aefffe0bfa462af43c1699d050");
+        }
+    };
+
+    TestCase {
+        "GcmModeVerify",
+        []{
+            Bytes key = Test::random(16, 1);
+            Bytes iv = Test::random(12, 2);
+            Bytes aad = Test::random(21, 3);
+            Bytes text = Test::random(0x1234, 4);
+
+            Bytes data = text.copy();
+            Bytes tag;
+            {
+                GcmBlockCipher cipher{AesBlockCipher{key}, iv, aad};
+                for (long i = 0; i < data.count(); i += 100) {
+                    Bytes s = data.select(i, i + 100 < data.count() ? i + 100 : data.count());
+                    cipher.encode(s, &s);
+                }
+                tag = cipher.tag();
+            }
+            {
+                GcmBlockCipher cipher{AesBlockCipher{key}, iv, aad};
+                Bytes s = data.copy();
+                cipher.decode(s, &s);
+                CC_CHECK(s == text);
+                CC_CHECK(cipher.verify(tag));
+                CC_CHECK(cipher.verify(tag.copy(0, 12)));
+            }
+            {
+                data[77] ^= 1;
+                GcmBlockCipher cipher{AesBlockCipher{key}, iv, aad};
+                cipher.decode(data, &data);
+                CC_CHECK(!cipher.verify(tag));
+            }
+        }
+    };
+
+    TestCase {
+        "GcmModePortableMultiplication",
+        []{
+            if (!gcm::usePclmul) return;
+
+            Bytes key = Test::random(32, 1);
+            Bytes iv = Test::random(16, 2);
+            Bytes text = Test::random(0x777, 3);
+
+            Bytes c1 = text.copy();
+            GcmBlockCipher cipher1{AesBlockCipher{key}, iv, text.copy(0, 33)};
+            cipher1.encode(c1, &c1);
+
+            gcm::usePclmul = false;
+            Bytes c2 = text.copy();
+            GcmBlockCipher cipher2{AesBlockCipher{key}, iv, text.copy(0, 33)};
+            cipher2.encode(c2, &c2);
+            gcm::usePclmul = true;
+
+            CC_CHECK(c1 == c2);
+            CC_CHECK(cipher1.tag() == cipher2.tag());
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
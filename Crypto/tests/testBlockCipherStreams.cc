@@ -9,6 +9,8 @@
 #include <cc/BlockCipherSink>
 #include <cc/BlockCipherSource>
 #include <cc/AesBlockCipher>
+#include <cc/CtrBlockCipher>
+#include <cc/GcmBlockCipher>
 #include <cc/MemoryStream>
 #include <cc/NullStream>
 #include <cc/Random>
@@ -82,5 +84,65 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "CtrBlockCipherStream",
+        []{
+            Bytes key {
+                0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+            };
+            String text = String::allocate(0x2345);
+            {
+                Random random;
+                for (int i = 0; i < text.count(); ++i) {
+                    text.byteAt(i) = random.get() & 0xFF;
+                }
+            }
+
+            String cipherText = String::allocate(text.count());
+            {
+                MemoryStream stream{cipherText};
+                BlockCipherSink sink{stream, CtrBlockCipher{AesBlockCipher{key}}};
+                for (long i = 0; i < text.count(); i += 333) {
+                    sink.write(text.select(i, i + 333 < text.count() ? i + 333 : text.count()));
+                }
+                CC_CHECK(sink.pendingCount() == 0);
+            }
+            String text2 = String::allocate(text.count());
+            {
+                MemoryStream stream{cipherText};
+                BlockCipherSource{stream, CtrBlockCipher{AesBlockCipher{key}}}.read(&text2);
+            }
+            CC_CHECK(text2 == text);
+        }
+    };
+
+    TestCase {
+        "GcmBlockCipherStream",
+        []{
+            Bytes key {
+                0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+            };
+            Bytes iv = key.copy(0, 12);
+            String text = "0123456789,0123456789,0123456789,0123456789";
+
+            GcmBlockCipher encoder{AesBlockCipher{key}, iv};
+            String cipherText = String::allocate(text.count());
+            {
+                MemoryStream stream{cipherText};
+                BlockCipherSink{stream, encoder}.write(text);
+            }
+            GcmBlockCipher decoder{AesBlockCipher{key}, iv};
+            String text2 = String::allocate(text.count());
+            {
+                MemoryStream stream{cipherText};
+                BlockCipherSource{stream, decoder}.read(&text2);
+            }
+            CC_CHECK(text2 == text);
+            CC_CHECK(decoder.verify(encoder.tag()));
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -7,6 +7,8 @@
  */
 
 #include <cc/Sha256HashSink>
+#include <cc/ShaDispatch>
+#include <cc/Random>
 #include <cc/testing>
 
 int main(int argc, char *argv[])
@@ -33,5 +35,55 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "Sha256ImplementationsAgree",
+        []{
+            const bool hasShaNi = sha::useShaNi;
+            const bool hasAvx2 = sha::useAvx2;
+
+            Random random{11};
+            List<Bytes> messages;
+            for (int n = 0; n < 300; n += 1 + n / 16) {
+                Bytes message = Bytes::allocate(n);
+                for (int i = 0; i < n; ++i) message[i] = random.get() & 0xFF;
+                messages.append(message);
+            }
+
+            List<Bytes> expected;
+            sha::useShaNi = false;
+            for (const Bytes &message: messages) {
+                Sha256HashSink sink; // portable, written in odd pieces
+                for (long i = 0; i < message.count(); i += 7) {
+                    sink.write(message.copy(i, i + 7 < message.count() ? i + 7 : message.count()));
+                }
+                expected.append(sink.finish());
+            }
+
+            if (hasShaNi) {
+                sha::useShaNi = true;
+                for (int i = 0; i < messages.count(); ++i) {
+                    CC_VERIFY(sha256(messages.at(i)) == expected.at(i));
+                }
+                List<Bytes> digests = sha256(messages);
+                for (int i = 0; i < digests.count(); ++i) {
+                    CC_VERIFY(digests.at(i) == expected.at(i));
+                }
+            }
+
+            if (hasAvx2) {
+                sha::useShaNi = false;
+                sha::useAvx2 = true;
+                List<Bytes> digests = sha256(messages);
+                CC_CHECK(digests.count() == expected.count());
+                for (int i = 0; i < digests.count(); ++i) {
+                    CC_VERIFY(digests.at(i) == expected.at(i));
+                }
+            }
+
+            sha::useShaNi = hasShaNi;
+            sha::useAvx2 = hasAvx2;
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,78 @@
+#include <cc/AesBlockCipher>
+#include <cc/AesDispatch>
+#include <cc/CbcBlockCipher>
+#include <cc/CtrBlockCipher>
+#include <cc/GcmBlockCipher>
+#include <cc/GcmDispatch>
+#include <cc/System>
+#include <cc/stdio>
+#include <functional>
+
+using namespace cc;
+
+double benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+void report(const String &name, long volume, double dt)
+{
+    fout() << name << "\t" << volume / dt / 1e6 << " MB/s" << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    const long volume = argc > 1 ? String{argv[1]}.toLong() : 64 << 20;
+    const long chunkSize = 0x4000;
+
+    Bytes key = Bytes::allocate(16);
+    Bytes iv = Bytes::allocate(16);
+    key.fill(0x5A);
+    iv.fill(0xA5);
+
+    Bytes data = Bytes::allocate(chunkSize);
+    data.fill(0x37);
+
+    const bool hasAesNi = aes::useAesNi;
+    const bool hasPclmul = gcm::usePclmul;
+
+    for (bool accelerated: { false, true }) {
+        if (accelerated && !hasAesNi) {
+            fout() << "AES-NI is not supported on this CPU" << nl;
+            break;
+        }
+
+        aes::useAesNi = accelerated;
+        gcm::usePclmul = accelerated && hasPclmul;
+
+        const String suffix = accelerated ? " (AES-NI)" : " (portable)";
+        const long n = accelerated ? volume : volume / 16; // the portable cipher is slow
+
+        AesBlockCipher aes{key};
+
+        auto run = [&](BlockCipher cipher, bool decode) {
+            return benchmark([&]{
+                for (long i = 0; i < n; i += chunkSize) {
+                    if (decode) cipher.decode(data, &data);
+                    else cipher.encode(data, &data);
+                }
+            });
+        };
+
+        report("ECB encode" + suffix, n, run(aes, false));
+        report("ECB decode" + suffix, n, run(aes, true));
+        report("CBC encode" + suffix, n, run(CbcBlockCipher{aes, iv}, false));
+        report("CBC decode" + suffix, n, run(CbcBlockCipher{aes, iv}, true));
+        report("CTR encode" + suffix, n, run(CtrBlockCipher{aes, iv}, false));
+        report("GCM encode" + suffix, n, run(GcmBlockCipher{aes, iv.copy(0, 12)}, false));
+    }
+
+    return 0;
+}
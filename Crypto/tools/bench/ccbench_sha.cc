@@ -0,0 +1,82 @@
+#include <cc/Sha1HashSink>
+#include <cc/Sha256HashSink>
+#include <cc/ShaDispatch>
+#include <cc/System>
+#include <cc/stdio>
+#include <functional>
+
+using namespace cc;
+
+double benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+void report(const String &name, long volume, double dt)
+{
+    fout() << name << "\t" << volume / dt / 1e6 << " MB/s" << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    const long volume = argc > 1 ? String{argv[1]}.toLong() : 64 << 20;
+
+    const bool hasShaNi = sha::useShaNi;
+    const bool hasAvx2 = sha::useAvx2;
+
+    struct Method {
+        const char *name;
+        bool shaNi;
+        bool avx2;
+    };
+
+    const Method methods[] = {
+        { "portable", false, false },
+        { "SHA-NI", true, false },
+        { "AVX2 lanes", false, true }
+    };
+
+    Bytes data = Bytes::allocate(volume);
+    data.fill(0x37);
+
+    for (const Method &method: methods) {
+        if ((method.shaNi && !hasShaNi) || (method.avx2 && !hasAvx2)) continue;
+        if (method.avx2) continue; // lanes only apply to many messages
+
+        sha::useShaNi = method.shaNi;
+        sha::useAvx2 = method.avx2;
+
+        report(String{"SHA-1 one message ("} + method.name + ")", volume, benchmark([&]{ sha1(data); }));
+        report(String{"SHA-256 one message ("} + method.name + ")", volume, benchmark([&]{ sha256(data); }));
+    }
+
+    for (long size: { 64L, 256L, 1024L }) {
+        List<Bytes> messages;
+        for (long i = 0; i + size <= volume / 16; i += size) {
+            messages.append(data.copy(i, i + size));
+        }
+        const long n = messages.count() * size;
+
+        for (const Method &method: methods) {
+            if ((method.shaNi && !hasShaNi) || (method.avx2 && !hasAvx2)) continue;
+
+            sha::useShaNi = method.shaNi;
+            sha::useAvx2 = method.avx2;
+
+            report(Format{"SHA-1 %% byte messages (%%)"} << size << method.name, n, benchmark([&]{ sha1(messages); }));
+            report(Format{"SHA-256 %% byte messages (%%)"} << size << method.name, n, benchmark([&]{ sha256(messages); }));
+        }
+    }
+
+    sha::useShaNi = hasShaNi;
+    sha::useAvx2 = hasAvx2;
+
+    return 0;
+}
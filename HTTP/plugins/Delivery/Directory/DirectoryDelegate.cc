@@ -14,6 +14,10 @@
 #include <cc/File>
 #include <cc/FileInfo>
 #include <cc/Date>
+#include <cc/System>
+#include <cc/exceptions>
+#include <cc/str>
+#include <cmath>
 
 namespace cc {
 
@@ -56,30 +60,263 @@ struct DirectoryDelegate::State: public HttpServiceDelegate::State
             "</html>\n";
     }
 
-    void deliverFile(const String &path)
+    struct ByteRange
     {
-        String content = File{path}.map();
-        String mediaType = serviceInstance().mediaTypes().lookup(path, content);
+        long long i0 { 0 }; ///< index of the first byte
+        long long i1 { 0 }; ///< index behind the last byte
+
+        std::strong_ordering operator<=>(const ByteRange &other) const { return i0 <=> other.i0; }
+    };
+
+    /** Generate an entity tag for a file version
+      *
+      * The entity tag is weak if the file has been modified within the last second,
+      * because it might still be modified without changing its time stamp.
+      */
+    static String entityTag(const FileInfo &status)
+    {
+        const double t = status.lastModified();
+        const long long s = static_cast<long long>(std::floor(t));
+        const long long ns = static_cast<long long>((t - s) * 1e9);
+        String tag = Format{"\"%%-%%-%%\""}
+            << hex(status.iNodeNumber())
+            << hex(status.size())
+            << hex(s * 1000000000 + ns);
+        if (System::now() - t < 1) tag = "W/" + tag;
+        return tag;
+    }
+
+    /** Check if any entity tag listed in \a text matches \a tag
+      * \param text Value of an If-Match, If-None-Match or If-Range header field
+      * \param tag Entity tag of the current file version
+      * \param strong Use the strong comparison function (see RFC 7232, section 2.3.2)
+      */
+    static bool entityTagMatches(const String &text, const String &tag, bool strong)
+    {
+        const bool tagIsWeak = tag.startsWith("W/");
+        if (strong && tagIsWeak) return false;
+        const String opaqueTag = tagIsWeak ? tag.copy(2, tag.count()) : tag;
+
+        for (const String &item: text.split(',')) {
+            String candidate = item.trimmed();
+            if (candidate == "*") return true;
+            if (candidate.startsWith("W/")) {
+                if (strong) continue;
+                candidate = candidate.copy(2, candidate.count());
+            }
+            if (candidate == opaqueTag) return true;
+        }
+
+        return false;
+    }
+
+    /** Check if the client's cached version of the file is still up to date
+      */
+    static bool notModified(const HttpRequest &request, const FileInfo &status, const String &tag)
+    {
+        String h;
+        if (tag != "" && request.header().lookup("If-None-Match", &h)) {
+            return entityTagMatches(h, tag, false);
+        }
+        if (request.header().lookup("If-Modified-Since", &h)) {
+            Date cacheDate = httpDateFromString(h);
+            if (cacheDate) return std::floor(status.lastModified()) <= cacheDate.time();
+        }
+        return false;
+    }
+
+    /** Check if the If-Range precondition (if any) allows a partial response
+      */
+    static bool rangeApplies(const HttpRequest &request, const FileInfo &status, const String &tag)
+    {
+        String h;
+        if (!request.header().lookup("If-Range", &h)) return true;
+        h = h.trimmed();
+        if (h.startsWith('"') || h.startsWith("W/")) return entityTagMatches(h, tag, true);
+        Date date = httpDateFromString(h);
+        return date && std::floor(status.lastModified()) == date.time();
+    }
+
+    /** Read the byte ranges specified by the Range header field \a text
+      * \param text Value of the Range header field
+      * \param size %File size
+      * \param ranges Returns the satisfiable ranges in ascending order with overlapping and adjacent ranges merged
+      * \return True if \a text is syntactically valid
+      */
+    static bool readRanges(const String &text, long long size, Out<List<ByteRange>> ranges)
+    {
+        const long MaxRangeCount = 16;
+
+        String spec = text.trimmed();
+        if (!spec.startsWith("bytes=")) return false;
+        spec = spec.copy(6, spec.count());
+
+        List<String> items = spec.split(',');
+        if (items.count() > MaxRangeCount) return false;
+
+        for (const String &item: items) {
+            String s = item.trimmed();
+            long i = 0;
+            if (!s.find('-', &i)) return false;
+            String first = s.copy(0, i).trimmed();
+            String last = s.copy(i + 1, s.count()).trimmed();
+            long long a = 0, b = 0;
+            if (first == "") {
+                if (last == "" || !last.readNumber<long long, 10>(&b)) return false;
+                if (b == 0 || size == 0) continue;
+                ByteRange range;
+                range.i0 = (b < size) ? size - b : 0;
+                range.i1 = size;
+                ranges().append(range);
+            }
+            else {
+                if (!first.readNumber<long long, 10>(&a)) return false;
+                if (last != "") {
+                    if (!last.readNumber<long long, 10>(&b) || b < a) return false;
+                }
+                else b = size - 1;
+                if (a >= size) continue;
+                ByteRange range;
+                range.i0 = a;
+                range.i1 = (b < size) ? b + 1 : size;
+                ranges().append(range);
+            }
+        }
+
+        ranges().sort();
+
+        List<ByteRange> merged;
+        ByteRange pending;
+        for (const ByteRange &range: ranges()) {
+            if (pending.i1 > 0 && range.i0 <= pending.i1) {
+                if (pending.i1 < range.i1) pending.i1 = range.i1;
+                continue;
+            }
+            if (pending.i1 > 0) merged.append(pending);
+            pending = range;
+        }
+        if (pending.i1 > 0) merged.append(pending);
+        ranges = merged;
+
+        return true;
+    }
+
+    static String contentRange(const ByteRange &range, long long size)
+    {
+        return Format{"bytes %%-%%/%%"} << range.i0 << range.i1 - 1 << size;
+    }
+
+    /** Deliver file \a path
+      * \param cachedStatus Status of the file as found in the file info cache
+      *
+      * Size and entity tag are taken from the opened file, because the cached status might be outdated.
+      */
+    void deliverFile(const HttpRequest &request, const String &path, const FileInfo &cachedStatus)
+    {
+        File file{path};
+        const FileInfo status{file};
+        const String tag = entityTag(status);
+        response().setHeader("ETag", tag);
+
+        if (notModified(request, cachedStatus, tag)) {
+            response().setStatus(HttpStatus::NotModified);
+            response().beginTransmission();
+            response().endTransmission();
+            return;
+        }
+
+        const long long size = status.size();
+        String head = file.readSpan(64);
+        file.seek(0, Seek::Begin);
+        String mediaType = serviceInstance().mediaTypes().lookup(path, head);
+
+        response().setHeader("Accept-Ranges", "bytes");
+
+        List<ByteRange> ranges;
+        String h;
+        if (
+            request.header().lookup("Range", &h) &&
+            rangeApplies(request, status, tag) &&
+            readRanges(h, size, &ranges)
+        ) {
+            if (ranges.count() == 0) {
+                response().setStatus(HttpStatus::RangeNotSatisfiable);
+                response().setHeader("Content-Range", Format{"bytes */%%"} << size);
+                response().transmit();
+                return;
+            }
+            if (ranges.count() == 1) {
+                const ByteRange &range = ranges.first();
+                response().setStatus(HttpStatus::PartialContent);
+                if (mediaType != "") response().setHeader("Content-Type", mediaType);
+                response().setHeader("Content-Range", contentRange(range, size));
+                response().transmitFile(file, range.i0, range.i1 - range.i0);
+                return;
+            }
+            MultipartLayout layout{file, size, mediaType, ranges};
+            // fall back to the full body if the ranges are too fragmented for the multipart response to be any smaller
+            if (layout.contentLength < size) {
+                deliverMultipleRanges(file, layout, ranges);
+                return;
+            }
+        }
+
         if (mediaType != "") response().setHeader("Content-Type", mediaType);
-        response().beginTransmission(content.count());
-        response().write(content);
+        response().transmitFile(file, 0, size);
+    }
+
+    /** Framing of a multipart/byteranges response
+      */
+    struct MultipartLayout
+    {
+        MultipartLayout(const File &file, long long size, const String &mediaType, const List<ByteRange> &ranges):
+            boundary{hex(static_cast<uint64_t>(System::now() * 1e6)) + hex(file.fd())}
+        {
+            for (const ByteRange &range: ranges) {
+                Format part;
+                part << "\r\n--" << boundary << "\r\n";
+                if (mediaType != "") part << "Content-Type: " << mediaType << "\r\n";
+                part << "Content-Range: " << contentRange(range, size) << "\r\n\r\n";
+                partHeaders.append(part);
+                contentLength += partHeaders.last().count() + range.i1 - range.i0;
+            }
+            trailer = "\r\n--" + boundary + "--\r\n";
+            contentLength += trailer.count();
+        }
+
+        String boundary;
+        List<String> partHeaders;
+        String trailer;
+        long long contentLength { 0 };
+    };
+
+    void deliverMultipleRanges(File &file, const MultipartLayout &layout, const List<ByteRange> &ranges)
+    {
+        response().setStatus(HttpStatus::PartialContent);
+        response().setHeader("Content-Type", "multipart/byteranges; boundary=" + layout.boundary);
+        response().beginTransmission(layout.contentLength);
+
+        Bytes buffer = Bytes::allocate(0x10000);
+        long i = 0;
+        for (const ByteRange &range: ranges) {
+            response().write(layout.partHeaders.at(i++));
+            file.seek(range.i0, Seek::Begin);
+            if (file.transferTo(response().payload(), range.i1 - range.i0, buffer) < range.i1 - range.i0) {
+                // the file shrank after the Content-Length was announced, the connection needs to be closed
+                throw InputExhaustion{};
+            }
+        }
+        response().write(layout.trailer);
         response().endTransmission();
     }
 
     void streamFile(const String &path)
     {
         File file{path};
-        String head;
-        long long size = -1;
-        if (file.isSeekable()) {
-            head = file.readSpan(64);
-            size = file.seek(0, Seek::End);
-            file.seek(0, Seek::Begin);
-        }
-        String mediaType = serviceInstance().mediaTypes().lookup(path, head);
+        String mediaType = serviceInstance().mediaTypes().lookup(path, String{});
         if (mediaType != "") response().setHeader("Content-Type", mediaType);
-        response().beginTransmission(size);
-        file.transferTo(response().payload(), size, Bytes::allocate(0x10000));
+        response().beginTransmission(-1);
+        file.transferTo(response().payload(), -1, Bytes::allocate(0x10000));
         response().endTransmission();
     }
 
@@ -94,40 +331,24 @@ struct DirectoryDelegate::State: public HttpServiceDelegate::State
 
         if (!service.showHidden() && path.baseName().startsWith('.')) throw HttpNotFound{};
 
-        FileInfo fileStatus{path};
+        FileInfo fileStatus = service.fileInfo(path);
 
         if (!fileStatus) {
             path.downcase();
-            fileStatus = FileInfo{path};
+            fileStatus = service.fileInfo(path);
             if (!fileStatus) throw HttpNotFound{};
         }
 
-        {
-            String h;
-            if (request.header().lookup("If-Modified-Since", &h)) {
-                Date cacheDate = httpDateFromString(h);
-                if (cacheDate) {
-                    if (fileStatus.lastModified() <= cacheDate.time()) {
-                        response().setStatus(HttpStatus::NotModified);
-                        response().beginTransmission();
-                        response().endTransmission();
-                        return;
-                    }
-                }
-            }
-        }
-
-        response().setHeader("Last-Modified", httpDateToString(Date{fileStatus.lastModified()}));
-
         if (fileStatus.type() == FileType::Directory) {
-            String indexPath, indexName;
+            String indexPath;
+            FileInfo indexStatus;
             const char *candidateNames[] = { "index.html", "index.htm" };
             for (int i = 0, n = sizeof(candidateNames) / sizeof(candidateNames[0]); i < n; ++i) {
-                String candidateName = candidateNames[i];
-                String candidatePath = path / candidateName;
-                if (File::exists(candidatePath)) {
+                String candidatePath = path / candidateNames[i];
+                FileInfo candidateStatus = service.fileInfo(candidatePath);
+                if (candidateStatus) {
                     indexPath = candidatePath;
-                    indexName = candidateName;
+                    indexStatus = candidateStatus;
                     break;
                 }
             }
@@ -145,15 +366,24 @@ struct DirectoryDelegate::State: public HttpServiceDelegate::State
                     return;
                 }
 
-                deliverFile(indexPath);
+                response().setHeader("Last-Modified", httpDateToString(Date{indexStatus.lastModified()}));
+                deliverFile(request, indexPath, indexStatus);
+            }
+            else {
+                if (notModified(request, fileStatus, String{})) {
+                    response().setStatus(HttpStatus::NotModified);
+                    response().beginTransmission();
+                    response().endTransmission();
+                    return;
+                }
+                response().setHeader("Last-Modified", httpDateToString(Date{fileStatus.lastModified()}));
+                listDirectory(request, path);
             }
-            else listDirectory(request, path);
-        }
-        else if (fileStatus.type() == FileType::Regular && fileStatus.size() < 0x10000) {
-            deliverFile(path);
         }
         else {
-            streamFile(path);
+            response().setHeader("Last-Modified", httpDateToString(Date{fileStatus.lastModified()}));
+            if (fileStatus.type() == FileType::Regular) deliverFile(request, path, fileStatus);
+            else streamFile(path);
         }
     }
 };
@@ -17,7 +17,8 @@ namespace cc {
 DirectoryInstance::State::State(const MetaObject &config):
     HttpServiceInstance::State{config},
     path_{config("path").to<String>()},
-    showHidden_{config("show-hidden").to<bool>()}
+    showHidden_{config("show-hidden").to<bool>()},
+    fileInfoCache_{config("file-info-timeout").to<double>()}
 {
     if (path_ == "") {
         throw UsageError{"DirectoryInstance: Mandatory argument \"path\" is missing"};
@@ -54,6 +55,11 @@ bool DirectoryInstance::showHidden() const
     return me().showHidden_;
 }
 
+FileInfo DirectoryInstance::fileInfo(const String &path) const
+{
+    return me().fileInfoCache_.lookup(path);
+}
+
 const DirectoryInstance::State &DirectoryInstance::me() const
 {
     return Object::me.as<State>();
@@ -19,6 +19,7 @@ struct DirectoryService::State: public HttpService::State
     {
         configPrototype_.establish("path", "");
         configPrototype_.establish("show-hidden", false);
+        configPrototype_.establish("file-info-timeout", 1.);
     }
 
     HttpServiceConfigPrototype configPrototype() const override
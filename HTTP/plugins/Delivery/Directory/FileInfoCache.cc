@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/FileInfoCache>
+#include <cc/Map>
+#include <cc/Mutex>
+#include <cc/Guard>
+#include <cc/System>
+
+namespace cc {
+
+struct FileInfoCache::State final: public Object::State
+{
+    struct Entry
+    {
+        FileInfo info;
+        double expiry { 0 };
+    };
+
+    State(double maxAge, long maxCount):
+        maxAge_{maxAge},
+        maxCount_{maxCount}
+    {}
+
+    FileInfo lookup(const String &path)
+    {
+        if (maxAge_ <= 0) return FileInfo{path};
+
+        const double now = System::now();
+
+        {
+            Guard<Mutex> guard{mutex_};
+            Locator pos;
+            if (entries_.find(path, &pos)) {
+                const Entry &entry = entries_.at(pos).value();
+                if (now < entry.expiry) return entry.info;
+            }
+        }
+
+        FileInfo info{path};
+
+        Guard<Mutex> guard{mutex_};
+        if (entries_.count() >= maxCount_) purge(now);
+        entries_.establish(path, Entry{info, now + maxAge_});
+        return info;
+    }
+
+    void purge(double now)
+    {
+        List<String> expired;
+        for (const auto &pair: entries_) {
+            if (pair.value().expiry <= now) expired.append(pair.key());
+        }
+        for (const String &path: expired) entries_.remove(path);
+        if (entries_.count() >= maxCount_) entries_ = Map<String, Entry>{};
+    }
+
+    double maxAge_;
+    long maxCount_;
+    Mutex mutex_;
+    Map<String, Entry> entries_;
+};
+
+FileInfoCache::FileInfoCache(double maxAge, long maxCount):
+    Object{new State{maxAge, maxCount}}
+{}
+
+FileInfo FileInfoCache::lookup(const String &path)
+{
+    return me().lookup(path);
+}
+
+FileInfoCache::State &FileInfoCache::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
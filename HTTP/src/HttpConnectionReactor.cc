@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/HttpConnectionReactor>
+#include <cc/httpDebug>
+#include <cc/IoMonitor>
+#include <cc/Thread>
+#include <cc/System>
+#include <cc/Map>
+#include <atomic>
+
+namespace cc {
+
+struct HttpConnectionReactor::State final: public Object::State
+{
+    struct Parking
+    {
+        HttpClientConnection client;
+        List<Bytes> prefetched;
+        long prefetchedCount { 0 };
+        int nlCount { 0 };
+        double deadline { 0 };
+    };
+
+    static constexpr long HeaderSizeLimit = 0x10000;
+
+    State(
+        const HttpServerConfig &nodeConfig,
+        const PendingConnections &pendingConnections,
+        const ClosedConnections &closedConnections
+    ):
+        nodeConfig_{nodeConfig},
+        pendingConnections_{pendingConnections},
+        closedConnections_{closedConnections}
+    {
+        IoStream::pair(&wakeupSource_, &wakeupSink_);
+        ioMonitor_.watch(wakeupSource_, IoEvent::ReadyRead);
+        thread_ = Thread{[this]{ run(); }};
+        thread_.start();
+    }
+
+    ~State()
+    {
+        shutdown_ = true;
+        wakeup();
+        thread_.wait();
+    }
+
+    const HttpLoggingServiceInstance &errorLoggingInstance() const
+    {
+        return nodeConfig_.errorLoggingInstance();
+    }
+
+    void park(const HttpClientConnection &client)
+    {
+        incoming_.pushBack(client);
+        wakeup();
+    }
+
+    void wakeup()
+    {
+        if (!wakeupPending_.exchange(true)) wakeupSink_.write(" ");
+    }
+
+    void run()
+    {
+        Bytes buffer = Bytes::allocate(0x1000);
+
+        while (!shutdown_) {
+            try {
+                ioMonitor_.wait(
+                    [&](const IoActivity &activity) {
+                        if (activity.target().fd() == wakeupSource_.fd()) admitIncoming(buffer);
+                        else receive(activity.target().fd(), buffer);
+                    },
+                    1000
+                );
+                expire();
+            }
+            catch (Exception &ex) {
+                CCNODE_ERROR() << ex << nl;
+            }
+        }
+
+        List<int> fds;
+        for (const auto &pair: parked_) fds.append(pair.key());
+        for (int fd: fds) close(fd);
+    }
+
+    void admitIncoming(Bytes &buffer)
+    {
+        wakeupSource_.read(&buffer);
+        wakeupPending_ = false;
+
+        HttpClientConnection client;
+        while (incoming_.count() > 0) {
+            incoming_.popFront(&client);
+            admit(client);
+        }
+    }
+
+    void admit(HttpClientConnection &client)
+    {
+        const int fd = client.stream().fd();
+
+        Parking parking;
+        parking.client = client;
+        parking.deadline = System::now() + nodeConfig_.connectionTimeout();
+
+        Bytes prefetched = client.prefetched();
+        client.setPrefetched(Bytes{});
+
+        parked_.establish(fd, parking);
+
+        if (prefetched.count() > 0 && prefetch(parked_(fd), prefetched)) {
+            dispatch(fd);
+            return;
+        }
+
+        ioMonitor_.watch(client.stream(), IoEvent::ReadyRead);
+    }
+
+    void receive(int fd, Bytes &buffer)
+    {
+        Locator pos;
+        if (!parked_.find(fd, &pos)) return;
+
+        Parking &parking = parked_.at(pos).value();
+
+        if (nodeConfig_.isSecure(parking.client.localAddress())) {
+            // the TLS handshake needs to be performed by the worker
+            ioMonitor_.unwatch(parking.client.stream());
+            dispatch(fd);
+            return;
+        }
+
+        long n = 0;
+        try {
+            n = parking.client.stream().read(&buffer);
+        }
+        catch (Exception &)
+        {}
+
+        if (n <= 0) {
+            ioMonitor_.unwatch(parking.client.stream());
+            close(fd);
+            return;
+        }
+
+        if (prefetch(parking, buffer.copy(0, n))) {
+            ioMonitor_.unwatch(parking.client.stream());
+            dispatch(fd);
+        }
+    }
+
+    /** Append \a chunk to the prefetched input and return true if a complete header has been received
+      */
+    bool prefetch(Parking &parking, const Bytes &chunk)
+    {
+        parking.prefetched.append(chunk);
+        parking.prefetchedCount += chunk.count();
+
+        for (long i = 0, n = chunk.count(); i < n; ++i) {
+            const uint8_t ch = chunk.at(i);
+            if (ch == '\r') continue;
+            if (ch == '\n') {
+                if (++parking.nlCount == 2) return true;
+                continue;
+            }
+            parking.nlCount = 0;
+        }
+
+        return parking.prefetchedCount >= HeaderSizeLimit;
+    }
+
+    void dispatch(int fd)
+    {
+        Locator pos;
+        if (!parked_.find(fd, &pos)) return;
+
+        Parking parking = parked_.at(pos).value();
+        parked_.removeAt(pos);
+
+        HttpClientConnection client = parking.client;
+        if (parking.prefetched.count() == 1) client.setPrefetched(parking.prefetched.first());
+        else if (parking.prefetched.count() > 1) client.setPrefetched(String{parking.prefetched});
+        pendingConnections_.pushBack(client, client.priority());
+    }
+
+    void close(int fd)
+    {
+        Locator pos;
+        if (!parked_.find(fd, &pos)) return;
+
+        HttpClientConnection client = parked_.at(pos).value().client;
+        parked_.removeAt(pos);
+
+        try {
+            client.stream().shutdown();
+        }
+        catch (Exception &)
+        {}
+        client.updateDepartureTime();
+        closedConnections_.pushBack(client);
+    }
+
+    void expire()
+    {
+        const double now = System::now();
+        if (now < nextExpiry_) return;
+        nextExpiry_ = now + 1;
+
+        List<int> expired;
+        for (const auto &pair: parked_) {
+            if (pair.value().deadline <= now) expired.append(pair.key());
+        }
+
+        for (int fd: expired) {
+            ioMonitor_.unwatch(parked_(fd).client.stream());
+            close(fd);
+        }
+    }
+
+    HttpServerConfig nodeConfig_;
+    PendingConnections pendingConnections_;
+    ClosedConnections closedConnections_;
+    Channel<HttpClientConnection> incoming_;
+    IoStream wakeupSource_;
+    IoStream wakeupSink_;
+    std::atomic<bool> wakeupPending_ { false };
+    std::atomic<bool> shutdown_ { false };
+    IoMonitor ioMonitor_;
+    Map<int, Parking> parked_;
+    double nextExpiry_ { 0 };
+    Thread thread_;
+};
+
+HttpConnectionReactor::HttpConnectionReactor(
+    const HttpServerConfig &nodeConfig,
+    const PendingConnections &pendingConnections,
+    const ClosedConnections &closedConnections
+):
+    Object{new State{nodeConfig, pendingConnections, closedConnections}}
+{}
+
+void HttpConnectionReactor::park(const HttpClientConnection &client)
+{
+    me().park(client);
+}
+
+HttpConnectionReactor::State &HttpConnectionReactor::me()
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
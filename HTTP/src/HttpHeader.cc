@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/HttpHeader>
+#include <cc/chars>
+#include <cstring>
+
+namespace cc {
+
+bool HttpHeader::lookup(const String &name, Out<String> value) const
+{
+    long i = indexOf(name);
+    if (i < 0) return false;
+    value << valueAt(i);
+    return true;
+}
+
+long HttpHeader::indexOf(const String &name) const
+{
+    const char *text = text_.chars();
+    const char *key = name.chars();
+    const long keyLength = name.count();
+
+    for (long i = count_ - 1; i >= 0; --i) {
+        const Field &f = field(i);
+        if (f.nameLength != keyLength) continue;
+        const char *candidate = text + f.nameOffset;
+        long j = 0;
+        while (j < keyLength && toLower(candidate[j]) == toLower(key[j])) ++j;
+        if (j == keyLength) return i;
+    }
+
+    return -1;
+}
+
+void HttpHeader::append(const Field &f)
+{
+    if (count_ < InlineCapacity) inline_[count_] = f;
+    else overflow_.append(f);
+    ++count_;
+}
+
+void HttpHeader::removeLast()
+{
+    if (count_ > InlineCapacity) overflow_.popBack();
+    --count_;
+}
+
+/** Read the header fields from \a text starting at index \a i0
+  *
+  * Field names and values are trimmed and folded lines (obs-fold) are joined with a single space in-place.
+  * Fields with an empty value are dropped.
+  * \return False if a field is malformed
+  */
+bool HttpHeader::parse(const String &text, long i0)
+{
+    text_ = text;
+    count_ = 0;
+    overflow_ = List<Field>{};
+
+    char *s = text_.chars();
+    const long n = text_.count();
+
+    auto isSpace = [](char ch) { return ch == ' ' || ch == '\t'; };
+
+    for (long i = i0; i < n;) {
+        long j = i;
+        while (j < n && s[j] != '\n') ++j;
+        long k = j;
+        if (k > i && s[k - 1] == '\r') --k;
+        const long next = j + 1;
+
+        if (k == i) break;
+
+        if (isSpace(s[i])) {
+            if (count_ == 0) return false;
+            while (i < k && isSpace(s[i])) ++i;
+            while (k > i && isSpace(s[k - 1])) --k;
+            if (k > i) {
+                Field &f = field(count_ - 1);
+                long d = f.valueOffset + f.valueLength;
+                if (f.valueLength > 0) s[d++] = ' ';
+                else f.valueOffset = d;
+                std::memmove(s + d, s + i, k - i);
+                f.valueLength = static_cast<int>(d + (k - i) - f.valueOffset);
+            }
+            i = next;
+            continue;
+        }
+
+        if (count_ > 0 && field(count_ - 1).valueLength == 0) removeLast();
+
+        long c = i;
+        while (c < k && s[c] != ':') ++c;
+        if (c == k) return false;
+
+        long a0 = i, a1 = c;
+        while (a0 < a1 && isSpace(s[a0])) ++a0;
+        while (a1 > a0 && isSpace(s[a1 - 1])) --a1;
+        long b0 = c + 1, b1 = k;
+        while (b0 < b1 && isSpace(s[b0])) ++b0;
+        while (b1 > b0 && isSpace(s[b1 - 1])) --b1;
+
+        append(Field{
+            static_cast<int>(a0), static_cast<int>(a1 - a0),
+            static_cast<int>(b0), static_cast<int>(b1 - b0)
+        });
+
+        i = next;
+    }
+
+    if (count_ > 0 && field(count_ - 1).valueLength == 0) removeLast();
+
+    return true;
+}
+
+} // namespace cc
@@ -7,17 +7,14 @@
  */
 
 #include <cc/HttpMessageParser>
-#include <cc/TapBuffer>
-#include <cc/StreamTap>
-#include <cc/LineSource>
-#include <cc/TransferLimiter>
 #include <cc/input>
 
 namespace cc {
 
-HttpMessageParser::State::State(const Stream &stream):
-    httpStream_{stream},
-    lineBuffer_{String::allocate(0x999)}
+HttpMessageParser::State::State(const Stream &stream, const Bytes &prefetched):
+    httpStream_{stream, prefetched},
+    inputBuffer_{Bytes::allocate(0x1000)},
+    headerBuffer_{String::allocate(0x1000)}
 {}
 
 bool HttpMessageParser::State::isPayloadConsumed() const
@@ -25,57 +22,45 @@ bool HttpMessageParser::State::isPayloadConsumed() const
     return httpStream_.isPayloadConsumed();
 }
 
+String HttpMessageParser::State::readHeader()
+{
+    long fill = 0;
+
+    while (true) {
+        long n = httpStream_.read(&inputBuffer_);
+        if (n == 0) break;
+        if (fill + n > headerBuffer_.count()) {
+            if (fill + n > HeaderSizeLimit) throw HttpBadRequest{};
+            long capacity = 2 * headerBuffer_.count();
+            while (capacity < fill + n) capacity *= 2;
+            String newBuffer = String::allocate(capacity);
+            headerBuffer_.copyRangeToOffset(0, fill, &newBuffer, 0);
+            headerBuffer_ = newBuffer;
+        }
+        inputBuffer_.copyRangeToOffset(0, n, &headerBuffer_, fill);
+        fill += n;
+    }
+
+    return headerBuffer_.copy(0, fill);
+}
+
 void HttpMessageParser::State::readMessage(Out<HttpMessage> message)
 {
     httpStream_.nextHeader();
 
-    message()->header_.deplete();
     message()->payload_ = httpStream_;
 
-    try {
-        TransferLimiter limiter{httpStream_, 0x10000};
-        LineSource source{limiter, lineBuffer_};
-
-        String line;
-        if (!source.read(&line)) throw HttpCloseRequest{};
-
-        onFirstLineReceived(line, *message);
-
-        String name, value;
-        List<String> multiValue;
-        for (String line; source.read(&line);) {
-            if (line == "") {
-                break;
-            }
-            if (line.at(0) == ' ' || line.at(0) == '\t') {
-                if (multiValue.count() == 0) {
-                    multiValue = List<String>{value};
-                }
-                line.trim();
-                multiValue.append(line);
-                continue;
-            }
-            if (multiValue.count() != 0) {
-                message()->header_.establish(name, multiValue.join());
-                multiValue.deplete();
-            }
-            long i = 0;
-            if (!line.find(':', &i)) throw HttpBadRequest{};
-            name = line.copy(0, i);
-            value = line.copy(i + 1, line.count());
-            name.trim();
-            value.trim();
-            if (value != "") {
-                message()->header_.establish(name, value);
-            }
-        }
-        if (multiValue.count() != 0) {
-            message()->header_.establish(name, multiValue.join());
-        }
-    }
-    catch (InputExhaustion &) {
-        throw HttpBadRequest{};
-    }
+    String text = readHeader();
+    if (text.count() == 0) throw HttpCloseRequest{};
+
+    long i = 0;
+    while (i < text.count() && text.at(i) != '\n') ++i;
+    const long next = (i < text.count()) ? i + 1 : i;
+    if (i > 0 && text.at(i - 1) == '\r') --i;
+
+    onFirstLineReceived(text.copy(0, i), *message);
+
+    if (!message()->header_.parse(text, next)) throw HttpBadRequest{};
 
     onHeaderReceived(*message);
 
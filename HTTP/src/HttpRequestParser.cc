@@ -15,8 +15,8 @@ namespace cc {
 
 struct HttpRequestParser::State final: public HttpMessageParser::State
 {
-    State(const Stream &stream):
-        HttpMessageParser::State{stream}
+    State(const Stream &stream, const Bytes &prefetched):
+        HttpMessageParser::State{stream, prefetched}
     {}
 
     void onFirstLineReceived(const String &line, HttpMessage &message) override
@@ -57,8 +57,8 @@ struct HttpRequestParser::State final: public HttpMessageParser::State
     }
 };
 
-HttpRequestParser::HttpRequestParser(const Stream &stream):
-    HttpMessageParser{new State{stream}}
+HttpRequestParser::HttpRequestParser(const Stream &stream, const Bytes &prefetched):
+    HttpMessageParser{new State{stream, prefetched}}
 {}
 
 HttpRequest HttpRequestParser::readRequest()
@@ -8,14 +8,19 @@
 
 #include <cc/HttpResponseGenerator>
 #include <cc/httpDate>
+#include <cc/exceptions>
 #include <cc/System>
+#ifdef __linux
+#include <sys/sendfile.h>
+#endif
 
 namespace cc {
 
 struct HttpResponseGenerator::State final: public HttpMessageGenerator::State
 {
-    State(const Stream &stream):
-        HttpMessageGenerator::State{stream}
+    State(const Stream &stream, const IoStream &socket = IoStream{}):
+        HttpMessageGenerator::State{stream},
+        socket_{socket}
     {}
 
     void polishHeader() override
@@ -37,6 +42,64 @@ struct HttpResponseGenerator::State final: public HttpMessageGenerator::State
         }
     }
 
+    void transmitFile(File file, long long offset, long long length)
+    {
+        if (length < 0) {
+            length = file.seek(0, Seek::End) - offset;
+            if (length < 0) length = 0;
+        }
+
+        beginTransmission(length);
+
+        long long sent = 0;
+        long long copied = 0;
+
+        if (length > 0) {
+            if (socket_ && contentLength_ == length && !payload_) {
+                sent = sendFile(file, offset, length);
+            }
+            if (sent < length) {
+                file.seek(offset + sent);
+                copied = file.transferTo(payload(), length - sent, Bytes::allocate(0x10000));
+            }
+        }
+
+        endTransmission();
+
+        bytesWritten_ += sent;
+
+        if (sent + copied < length) {
+            // the file shrank after the Content-Length was announced, the connection needs to be closed
+            throw InputExhaustion{};
+        }
+    }
+
+    long long sendFile(const File &file, long long offset, long long length)
+    {
+        long long sent = 0;
+
+        #ifdef __linux
+        off_t pos = offset;
+        while (sent < length) {
+            long long chunk = length - sent;
+            if (chunk > 0x40000000) chunk = 0x40000000;
+            ssize_t n = -1;
+            do n = ::sendfile(socket_.fd(), file.fd(), &pos, chunk);
+            while (n == -1 && errno == EINTR);
+            if (n == -1) {
+                if (sent == 0 && (errno == EINVAL || errno == ENOSYS)) break; // not supported, fall back to copying
+                if (errno == EWOULDBLOCK) throw Timeout{};
+                if (errno == ECONNRESET || errno == EPIPE) throw OutputExhaustion{};
+                CC_SYSTEM_DEBUG_ERROR(errno);
+            }
+            if (n == 0) break;
+            sent += n;
+        }
+        #endif
+
+        return sent;
+    }
+
     void writeFirstLine(Format &sink) override
     {
         sink << "HTTP/1.1 " << +status_ << " " << reasonPhrase_ << "\r\n";
@@ -52,6 +115,7 @@ struct HttpResponseGenerator::State final: public HttpMessageGenerator::State
         return headerWritten_;
     }
 
+    IoStream socket_;
     HttpStatus status_ { 200 };
     String reasonPhrase_;
     String nodeVersion_;
@@ -61,6 +125,15 @@ HttpResponseGenerator::HttpResponseGenerator(const Stream &stream):
     HttpMessageGenerator{new State{stream}}
 {}
 
+HttpResponseGenerator::HttpResponseGenerator(const Stream &stream, const IoStream &socket):
+    HttpMessageGenerator{new State{stream, socket}}
+{}
+
+void HttpResponseGenerator::transmitFile(const File &file, long long offset, long long length)
+{
+    me().transmitFile(file, offset, length);
+}
+
 void HttpResponseGenerator::setStatus(HttpStatus status, const String &reasonPhrase)
 {
     me().status_ = status;
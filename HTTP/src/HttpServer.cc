@@ -10,6 +10,7 @@
 #include <cc/HttpServiceRegistry>
 #include <cc/HttpConnectionManager>
 #include <cc/HttpServiceWorker>
+#include <cc/HttpConnectionReactor>
 #include <cc/httpDebug>
 #include <cc/PluginLoader>
 #include <cc/TlsSessionCache>
@@ -117,11 +118,17 @@ struct HttpServer::State final: public Object::State
         PendingConnections pendingConnections;
         ClosedConnections closedConnections = connectionManager.closedConnections();
 
+        HttpConnectionReactor reactor;
+        if (nodeConfig_.reactor()) {
+            CCNODE_NOTICE() << "Starting connection reactor" << nl;
+            reactor = HttpConnectionReactor{nodeConfig_, pendingConnections, closedConnections};
+        }
+
         CCNODE_NOTICE() << "Creating worker pool (concurrency = " << nodeConfig_.concurrency() << ")" << nl;
 
         Array<HttpServiceWorker> workerPool = Array<HttpServiceWorker>::allocate(nodeConfig_.concurrency());
         for (HttpServiceWorker &worker: workerPool) {
-            worker = HttpServiceWorker{nodeConfig_, pendingConnections, closedConnections, sessionCache};
+            worker = HttpServiceWorker{nodeConfig_, pendingConnections, closedConnections, sessionCache, reactor};
             worker.start();
         }
 
@@ -145,7 +152,8 @@ struct HttpServer::State final: public Object::State
                         HttpClientConnection client{stream, serverSocket.address()};
                         if (connectionManager.accept(&client)) {
                             CCNODE_DEBUG() << "Accepted connection from " << client.peerAddress() << " with priority " << client.priority() << nl;
-                            pendingConnections.pushBack(client, client.priority());
+                            if (reactor) reactor.park(client);
+                            else pendingConnections.pushBack(client, client.priority());
                         }
                         else {
                             CCNODE_DEBUG() << "Rejected connection from " << client.peerAddress() << nl;
@@ -166,6 +174,7 @@ struct HttpServer::State final: public Object::State
                 if (signal == Signal::Interrupt || signal == Signal::Terminate || signal == Signal::HangUp) {
                     CCNODE_NOTICE() << "Received " << signal << ", shutting down ..." << nl;
                     workerPool.deplete();
+                    reactor = HttpConnectionReactor{};
                     CCNODE_NOTICE() << "Shutdown complete" << nl;
                     throw Signaled{signal};
                 }
@@ -77,6 +77,7 @@ struct HttpServerConfig::State: public Object::State
         daemonName_ = config("daemon-name").to<String>();
         pidPath_ = config("pid-file").to<String>();
         concurrency_ = config("concurrency").to<long>();
+        reactor_ = config("reactor").to<bool>();
         serviceWindow_ = config("service-window").to<long>();
         connectionLimit_ = config("connection-limit").to<long>();
         connectionTimeout_ = config("connection-timeout").to<double>();
@@ -137,6 +138,7 @@ struct HttpServerConfig::State: public Object::State
     String daemonName_;
     String pidPath_;
     long concurrency_;
+    bool reactor_;
     long serviceWindow_;
     long connectionLimit_;
     double connectionTimeout_;
@@ -194,6 +196,14 @@ long HttpServerConfig::securePort() const
     return me().securePort_;
 }
 
+bool HttpServerConfig::isSecure(const SocketAddress &localAddress) const
+{
+    return
+        me().forceSecureTransport_ ||
+        localAddress.port() == 443 ||
+        localAddress.port() == 4443;
+}
+
 String HttpServerConfig::user() const
 {
     return me().user_;
@@ -229,6 +239,11 @@ long HttpServerConfig::concurrency() const
     return me().concurrency_;
 }
 
+bool HttpServerConfig::reactor() const
+{
+    return me().reactor_;
+}
+
 long HttpServerConfig::serviceWindow() const
 {
     return me().serviceWindow_;
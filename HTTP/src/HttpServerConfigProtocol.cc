@@ -38,6 +38,7 @@ public:
             16
             #endif
         );
+        establish("reactor", false);
         establish("service-window", 30);
         establish("connection-limit", 32);
         establish("connection-timeout", 10.);
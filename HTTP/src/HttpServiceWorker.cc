@@ -20,12 +20,14 @@ HttpServiceWorkerState::HttpServiceWorkerState(
     const HttpServerConfig &nodeConfig,
     const PendingConnections &pendingConnections,
     const ClosedConnections &closedConnections,
-    const TlsSessionCache &sessionCache
+    const TlsSessionCache &sessionCache,
+    const HttpConnectionReactor &reactor
 ):
     nodeConfig_{nodeConfig},
     pendingConnections_{pendingConnections},
     closedConnections_{closedConnections},
-    sessionCache_{sessionCache}
+    sessionCache_{sessionCache},
+    reactor_{reactor}
 {}
 
 HttpServiceWorkerState::~HttpServiceWorkerState()
@@ -60,7 +62,8 @@ void HttpServiceWorkerState::run()
             {}
 
             if (tap_) tap_ = StreamTap{};
-            closeConnection();
+            if (parked_) parkConnection();
+            else closeConnection();
 
             serviceDelegate_ = HttpServiceDelegate{};
             serviceInstance_ = HttpServiceInstance{};
@@ -87,11 +90,10 @@ void HttpServiceWorkerState::setupTap(Stream &stream)
 
 void HttpServiceWorkerState::initiate(Stream &stream)
 {
-    if (
-        nodeConfig_.forceSecureTransport() ||
-        client_.localAddress().port() == 443 ||
-        client_.localAddress().port() == 4443
-    ) {
+    secure_ = nodeConfig_.isSecure(client_.localAddress());
+    parked_ = false;
+
+    if (secure_) {
         TlsServerStream tlsStream{client_.stream(), client_.peerAddress(), nodeConfig_.tlsOptions(), sessionCache_};
         tlsStream.handshake(
             [this](const String &serverName, const SocketAddress &peerAddress){
@@ -106,7 +108,8 @@ void HttpServiceWorkerState::initiate(Stream &stream)
     }
     else {
         setupTap(stream);
-        requestParser_ = HttpRequestParser{stream};
+        requestParser_ = HttpRequestParser{stream, client_.prefetched()};
+        client_.setPrefetched(Bytes{});
         HttpRequest request = readRequest();
         serviceInstance_ = nodeConfig_.selectService(request.host(), request.uri());
         pendingRequest_ = request;
@@ -120,7 +123,7 @@ void HttpServiceWorkerState::initiate(Stream &stream)
 
 void HttpServiceWorkerState::serve(Stream &stream)
 {
-    int requestCount = 0;
+    int requestCount = client_.requestCount();
     bool upgrade = false;
 
     while (client_)
@@ -130,11 +133,13 @@ void HttpServiceWorkerState::serve(Stream &stream)
             // CCNODE_DEBUG() << "Reading request..." << nl;
 
             request = readRequest();
-            ++requestCount;
+            client_.setRequestCount(++requestCount);
 
             ScopeGuard guard{[this]{ response_ = HttpResponseGenerator{}; }};
 
-            response_ = HttpResponseGenerator{stream};
+            response_ = (secure_ || tap_) ?
+                HttpResponseGenerator{stream} :
+                HttpResponseGenerator{stream, client_.stream()};
             response_.setNodeVersion(nodeConfig_.version());
 
             serviceDelegate_.process(request);
@@ -155,6 +160,13 @@ void HttpServiceWorkerState::serve(Stream &stream)
                 requestCount >= serviceInstance_.requestLimit() ||
                 (request.majorVersion() == 1 && request.minorVersion() == 0)
             ) break;
+
+            if (reactor_ && !secure_) {
+                // hand the idle connection over to the reactor until the next request arrives
+                client_.setPrefetched(requestParser_.pendingInput());
+                parked_ = true;
+                break;
+            }
         }
         catch (HttpError &error)
         {
@@ -192,10 +204,25 @@ HttpRequest HttpServiceWorkerState::readRequest()
     return request;
 }
 
+void HttpServiceWorkerState::parkConnection()
+{
+    if (client_) {
+        reactor_.park(client_);
+        client_ = HttpClientConnection{};
+    }
+    parked_ = false;
+}
+
 void HttpServiceWorkerState::closeConnection()
 {
     if (client_) {
         // CCNODE_DEBUG() << "Closing connection to " << client_.peerAddress() << nl;
+        requestParser_ = HttpRequestParser{}; // ends a TLS session while the socket is still writable
+        try {
+            client_.stream().shutdown();
+        }
+        catch (Exception &)
+        {}
         client_.updateDepartureTime();
         closedConnections_.pushBack(client_);
         client_ = HttpClientConnection{};
@@ -206,14 +233,16 @@ HttpServiceWorker::HttpServiceWorker(
     const HttpServerConfig &nodeConfig,
     const PendingConnections &pendingConnections,
     const ClosedConnections &closedConnections,
-    const TlsSessionCache &sessionCache
+    const TlsSessionCache &sessionCache,
+    const HttpConnectionReactor &reactor
 ):
     Object{
         new State{
             nodeConfig,
             pendingConnections,
             closedConnections,
-            sessionCache
+            sessionCache,
+            reactor
         }
     }
 {}
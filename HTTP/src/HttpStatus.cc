@@ -47,6 +47,7 @@ const char *httpReasonPhrase(HttpStatus status)
         case HttpStatus::PayloadTooLarge:             s = "Request Entity Too Large"; break;
         case HttpStatus::RequestUriTooLong:           s = "Request-URI Too Long"; break;
         case HttpStatus::UnsupportedMediaType:        s = "Unsupported Media Type"; break;
+        case HttpStatus::RangeNotSatisfiable:         s = "Range Not Satisfiable"; break;
         case HttpStatus::InternalServerError:         s = "Internal Server Error"; break;
         case HttpStatus::NotImplemented:              s = "Not Implemented"; break;
         case HttpStatus::BadGateway:                  s = "Bad Gateway"; break;
@@ -14,9 +14,11 @@ namespace cc {
 
 struct HttpStream::State: public Stream::State
 {
-    State(const Stream &stream):
+    State(const Stream &stream, const Bytes &prefetched):
         stream_{stream}
-    {}
+    {
+        if (prefetched.count() > 0) pending_ = prefetched;
+    }
 
     bool isPayloadConsumed() const
     {
@@ -69,6 +71,11 @@ struct HttpStream::State: public Stream::State
         }
     }
 
+    Bytes pendingInput() const
+    {
+        return pending_ ? pending_.copy(pendingIndex_, pending_.count()) : Bytes{};
+    }
+
     bool waitEstablished(int timeout) override
     {
         return stream_.waitEstablished(timeout);
@@ -176,8 +183,8 @@ struct HttpStream::State: public Stream::State
     bool chunked_ { false };
 };
 
-HttpStream::HttpStream(const Stream &stream):
-    Stream{new State{stream}}
+HttpStream::HttpStream(const Stream &stream, const Bytes &prefetched):
+    Stream{new State{stream, prefetched}}
 {}
 
 bool HttpStream::isPayloadConsumed() const
@@ -185,6 +192,11 @@ bool HttpStream::isPayloadConsumed() const
     return me().isPayloadConsumed();
 }
 
+Bytes HttpStream::pendingInput() const
+{
+    return me().pendingInput();
+}
+
 void HttpStream::nextHeader()
 {
     me().nextHeader();
@@ -11,10 +11,14 @@
 #include <cc/WebSocketPing>
 #include <cc/WebSocketPong>
 #include <cc/bits>
+#include <cstring>
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
-WebSocketFrame::State::State(ByteSource &source, long maxPayloadSize)
+WebSocketFrame::State::State(ByteSource &source, const String &buffer, long maxPayloadSize)
 {
     assert(source.endian() == ByteOrder::BigEndian);
 
@@ -43,7 +47,13 @@ WebSocketFrame::State::State(ByteSource &source, long maxPayloadSize)
         mask = source.readUInt32();
     }
 
-    payload_ = String::allocate(len);
+    if (len <= static_cast<uint64_t>(buffer.count())) {
+        payload_ = buffer;
+        if (len < static_cast<uint64_t>(payload_.count())) payload_ = payload_.select(0, len);
+    }
+    else {
+        payload_ = String::allocate(len);
+    }
     source.read(&payload_);
 
     if (masked) {
@@ -88,9 +98,49 @@ void WebSocketFrame::State::writeTo(ByteSink &sink, uint32_t mask)
 
 void WebSocketFrame::State::xorPayloadWithMask(uint32_t mask)
 {
-    for (long i = 0, n = payload_.count(); i < n; ++i) {
-        unsigned j = i & 0x3;
-        payload_[i] ^= static_cast<uint8_t>(mask >> (8 * (3 - j)));
+    applyMask(payload_.items(), payload_.count(), mask);
+}
+
+void WebSocketFrame::applyMask(uint8_t *data, long size, uint32_t mask)
+{
+    const uint8_t key[4] {
+        static_cast<uint8_t>(mask >> 24),
+        static_cast<uint8_t>(mask >> 16),
+        static_cast<uint8_t>(mask >> 8),
+        static_cast<uint8_t>(mask)
+    };
+
+    uint32_t key32 = 0;
+    std::memcpy(&key32, key, sizeof(key32));
+
+    long i = 0;
+
+    #ifdef __AVX2__
+    const __m256i key256 = _mm256_set1_epi32(static_cast<int>(key32));
+    for (; i + 32 <= size; i += 32) {
+        __m256i *p = reinterpret_cast<__m256i *>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key256));
+    }
+    #endif
+
+    #ifdef __SSE2__
+    const __m128i key128 = _mm_set1_epi32(static_cast<int>(key32));
+    for (; i + 16 <= size; i += 16) {
+        __m128i *p = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key128));
+    }
+    #endif
+
+    const uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x;
+        std::memcpy(&x, data + i, sizeof(x));
+        x ^= key64;
+        std::memcpy(data + i, &x, sizeof(x));
+    }
+
+    for (; i < size; ++i) {
+        data[i] ^= key[i & 3];
     }
 }
 
@@ -32,7 +32,7 @@ struct WebSocketStream::State final: public Object::State
 
         while (isOpen_)
         try {
-            WebSocketFrame frame { source_, maxIncomingMessageSize_ };
+            WebSocketFrame frame { source_, frameBuffer_, maxIncomingMessageSize_ };
 
             if (WebSocketPing ping { frame }; ping) {
                 write(WebSocketPong::createFrame(ping));
@@ -54,7 +54,7 @@ struct WebSocketStream::State final: public Object::State
                     throw WebSocketFrame::FrameToBig{};
                 }
                 else {
-                    pending.pushBack(frame.payload());
+                    pending.pushBack(retain(frame.payload()));
                     pendingSize += frame.payload().count();
                     if (frame.fin()) {
                         *message = String { pending };
@@ -75,7 +75,7 @@ struct WebSocketStream::State final: public Object::State
                 }
                 else {
                     pending.deplete();
-                    pending.pushBack(frame.payload());
+                    pending.pushBack(retain(frame.payload()));
                     pendingSize = frame.payload().count();
                 }
             }
@@ -88,6 +88,13 @@ struct WebSocketStream::State final: public Object::State
         return isOpen_;
     }
 
+    /** Make sure \a payload survives reading the next frame
+      */
+    String retain(const String &payload) const
+    {
+        return frameBuffer_ ? payload.copy() : payload;
+    }
+
     bool write(const String &message, WebSocketMessage::Type type, uint32_t mask)
     {
         if (message.count() > maxOutgoingFramePayloadSize_) {
@@ -148,6 +155,7 @@ struct WebSocketStream::State final: public Object::State
     bool doMask_ { false };
     long maxOutgoingFramePayloadSize_ { std::numeric_limits<long>::max() };
     long maxIncomingMessageSize_ { std::numeric_limits<long>::max() };
+    String frameBuffer_;
     WebSocketStatus status_ { WebSocketStatus::Ok };
     Function<void()> onPingReceived_;
     Function<void()> onPongReceived_;
@@ -169,6 +177,12 @@ WebSocketStream &WebSocketStream::maxIncomingMessageSize(long size)
     return *this;
 }
 
+WebSocketStream &WebSocketStream::incomingFrameBuffer(const String &buffer)
+{
+    me().frameBuffer_ = buffer;
+    return *this;
+}
+
 WebSocketStream &WebSocketStream::onPingReceived(Function<void()> &&f)
 {
     me().onPingReceived_ = std::move(f);
@@ -0,0 +1,131 @@
+#include <cc/HttpServer>
+#include <cc/HttpResponseParser>
+#include <cc/ClientSocket>
+#include <cc/Thread>
+#include <cc/Format>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    const String config {
+        "Node {\n"
+        "    address: \"127.0.0.1\"\n"
+        "    port: 8160\n"
+        "    family: IPv4\n"
+        "    concurrency: 2\n"
+        "    reactor: true\n"
+        "    connection-timeout: 1\n"
+        "    Echo {\n"
+        "        host: *\n"
+        "    }\n"
+        "}\n"
+    };
+
+    auto request = [](const String &path, bool close = false) -> String {
+        return Format{"GET %% HTTP/1.1\r\nHost: 127.0.0.1\r\n%%\r\n"}
+            << path
+            << (close ? "Connection: close\r\n" : "");
+    };
+
+    auto readEcho = [](HttpResponseParser &parser) -> String {
+        HttpResponse response = parser.readResponse();
+        if (response.status() != HttpStatus::OK) return String{};
+        String echo = response.payload().readAll();
+        long i = 0;
+        if (!echo.find('\r', &i)) return String{};
+        return echo.copy(0, i);
+    };
+
+    auto isClosed = [](StreamSocket &socket) {
+        if (!socket.wait(IoEvent::ReadyRead, 5000)) return false;
+        Bytes buffer = Bytes::allocate(16);
+        return socket.read(&buffer) == 0;
+    };
+
+    TestCase {
+        "PipelinedKeepAlive",
+        [=]{
+            HttpServer server{config};
+            server.start();
+            SocketAddress address = server.waitStarted();
+            CC_INSPECT(address);
+
+            const int connectionCount = 8;
+            const int batchSize = 3;
+
+            struct Outcome {
+                List<String> echoes;
+                bool closed { false };
+            };
+            Array<Outcome> outcomes = Array<Outcome>::allocate(connectionCount);
+            List<Thread> clients;
+
+            for (int i = 0; i < connectionCount; ++i) {
+                clients.append(Thread{[=, &outcomes]{
+                    Outcome &outcome = outcomes[i];
+                    try {
+                        ClientSocket socket{address};
+                        if (!socket.waitEstablished(5000)) return;
+                        HttpResponseParser parser{socket};
+
+                        // several requests sent in one go, answered in order on the same connection
+                        String batch;
+                        for (int j = 0; j < batchSize; ++j) batch += request(Format{"/%%/%%"} << i << j);
+                        socket.write(batch);
+                        for (int j = 0; j < batchSize; ++j) outcome.echoes.append(readEcho(parser));
+
+                        // the idle connection is parked in the reactor until the next request arrives
+                        Thread::sleep(0.2);
+                        socket.write(request(Format{"/%%/%%"} << i << batchSize, true));
+                        outcome.echoes.append(readEcho(parser));
+
+                        outcome.closed = isClosed(socket);
+                    }
+                    catch (Exception &)
+                    {}
+                }});
+            }
+
+            for (Thread &client: clients) client.start();
+            for (Thread &client: clients) client.wait();
+
+            for (int i = 0; i < connectionCount; ++i) {
+                const Outcome &outcome = outcomes.at(i);
+                CC_VERIFY(outcome.echoes.count() == batchSize + 1);
+                for (int j = 0; j <= batchSize; ++j) {
+                    CC_CHECK(outcome.echoes.at(j) == String{Format{"GET /%%/%% HTTP/1.1"} << i << j});
+                }
+                CC_CHECK(outcome.closed);
+            }
+
+            server.shutdown();
+            server.wait();
+        }
+    };
+
+    TestCase {
+        "IdleTimeout",
+        [=]{
+            HttpServer server{config};
+            server.start();
+            SocketAddress address = server.waitStarted();
+
+            ClientSocket socket{address};
+            CC_VERIFY(socket.waitEstablished(5000));
+            HttpResponseParser parser{socket};
+
+            socket.write(request("/idle"));
+            CC_CHECK(readEcho(parser) == "GET /idle HTTP/1.1");
+
+            // the parked connection is closed by the reactor after connection-timeout
+            CC_CHECK(isClosed(socket));
+
+            server.shutdown();
+            server.wait();
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
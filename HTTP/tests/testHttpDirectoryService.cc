@@ -0,0 +1,275 @@
+#include <cc/HttpServer>
+#include <cc/HttpResponseParser>
+#include <cc/ClientSocket>
+#include <cc/httpDate>
+#include <cc/File>
+#include <cc/Dir>
+#include <cc/Date>
+#include <cc/System>
+#include <cc/Format>
+#include <cc/testing>
+#include <cmath>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    class DirectoryFixture
+    {
+    public:
+        DirectoryFixture():
+            dirPath_{Dir::createTemp()},
+            server_{
+                String{
+                    Format{
+                        "Node {\n"
+                        "    address: \"127.0.0.1\"\n"
+                        "    port: 8240\n"
+                        "    family: IPv4\n"
+                        "    concurrency: 1\n"
+                        "    Directory {\n"
+                        "        host: *\n"
+                        "        path: \"%%\"\n"
+                        "    }\n"
+                        "}\n"
+                    } << dirPath_
+                }
+            }
+        {
+            String data = String::allocate(1000);
+            for (long i = 0; i < data.count(); ++i) data[i] = 'a' + i % 26;
+            data_ = data;
+
+            // old enough to be served with a strong entity tag
+            lastModified_ = std::floor(System::now()) - 3600;
+            File::save(dirPath_ / "data.txt", data_);
+            File::setTimes(dirPath_ / "data.txt", lastModified_, lastModified_);
+
+            // modified within the last second (as far as the server can tell), therefore served with a weak entity tag
+            File::save(dirPath_ / "fresh.txt", data_);
+            File::setTimes(dirPath_ / "fresh.txt", lastModified_, System::now() + 3600);
+
+            server_.start();
+            address_ = server_.waitStarted();
+        }
+
+        ~DirectoryFixture()
+        {
+            server_.shutdown();
+            server_.wait();
+            Dir::deplete(dirPath_);
+            Dir::remove(dirPath_);
+        }
+
+        const String &data() const { return data_; }
+
+        String lastModified() const { return httpDateToString(Date{lastModified_}); }
+
+        HttpResponse get(const String &path, const String &header = String{}, Out<String> payload = None{}) const
+        {
+            ClientSocket socket{address_};
+            socket.waitEstablished();
+            socket.write(
+                Format{"GET %% HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n%%\r\n"}
+                    << path << header
+            );
+            HttpResponse response = HttpResponseParser{socket}.readResponse();
+            payload << response.payload().readAll();
+            return response;
+        }
+
+    private:
+        String dirPath_;
+        HttpServer server_;
+        SocketAddress address_;
+        String data_;
+        double lastModified_ { 0 };
+    };
+
+    TestCase {
+        "ByteRanges",
+        []{
+            DirectoryFixture fixture;
+            const String &data = fixture.data();
+            String payload;
+
+            HttpResponse response = fixture.get("/data.txt", String{}, &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+            CC_CHECK(response.header("Accept-Ranges") == "bytes");
+            CC_CHECK(payload == data);
+
+            response = fixture.get("/data.txt", "Range: bytes=10-19\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 10-19/1000");
+            CC_CHECK(payload == data.copy(10, 20));
+
+            response = fixture.get("/data.txt", "Range: bytes=-10\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 990-999/1000");
+            CC_CHECK(payload == data.copy(990, 1000));
+
+            response = fixture.get("/data.txt", "Range: bytes=-5000\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 0-999/1000");
+
+            response = fixture.get("/data.txt", "Range: bytes=995-\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 995-999/1000");
+            CC_CHECK(payload == data.copy(995, 1000));
+
+            response = fixture.get("/data.txt", "Range: bytes=990-5000\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 990-999/1000");
+
+            for (const String &range: List<String>{ "bytes=1000-", "bytes=-0", "bytes=2000-3000,1000-" }) {
+                response = fixture.get("/data.txt", "Range: " + range + "\r\n");
+                CC_INSPECT(range);
+                CC_CHECK(response.status() == HttpStatus::RangeNotSatisfiable);
+                CC_CHECK(response.header("Content-Range") == "bytes */1000");
+            }
+
+            // syntactically invalid ranges are ignored
+            for (const String &range: List<String>{ "lines=1-2", "bytes=20-10", "bytes=x-", "bytes=1" }) {
+                response = fixture.get("/data.txt", "Range: " + range + "\r\n", &payload);
+                CC_INSPECT(range);
+                CC_CHECK(response.status() == HttpStatus::OK);
+                CC_CHECK(payload == data);
+            }
+        }
+    };
+
+    TestCase {
+        "MultipleByteRanges",
+        []{
+            DirectoryFixture fixture;
+            const String &data = fixture.data();
+            String payload;
+
+            HttpResponse response = fixture.get("/data.txt", "Range: bytes=500-509, 0-9\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Type").startsWith("multipart/byteranges; boundary="));
+            {
+                const String boundary = response.header("Content-Type").copy(31, response.header("Content-Type").count());
+                long i0 = 0, i1 = 0;
+                CC_VERIFY(payload.find("Content-Range: bytes 0-9/1000\r\n\r\n" + data.copy(0, 10), &i0));
+                CC_VERIFY(payload.find("Content-Range: bytes 500-509/1000\r\n\r\n" + data.copy(500, 510), &i1));
+                CC_CHECK(i0 < i1);
+                CC_CHECK(payload.endsWith("\r\n--" + boundary + "--\r\n"));
+            }
+
+            // overlapping and adjacent ranges are merged
+            response = fixture.get("/data.txt", "Range: bytes=10-19, 15-29, 30-39\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 10-39/1000");
+            CC_CHECK(payload == data.copy(10, 40));
+
+            response = fixture.get("/data.txt", "Range: bytes=0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-,0-\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(response.header("Content-Range") == "bytes 0-999/1000");
+            CC_CHECK(payload == data);
+
+            // too fragmented to be worth a partial response
+            List<String> parts;
+            for (int i = 0; i < 16; ++i) parts.append(Format{"%%-%%"} << i * 31 << i * 31 + 29);
+            response = fixture.get("/data.txt", "Range: bytes=" + parts.join(',') + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+            CC_CHECK(payload == data);
+
+            // too many ranges
+            response = fixture.get("/data.txt", "Range: bytes=0-0,2-2,4-4,6-6,8-8,10-10,12-12,14-14,16-16,18-18,20-20,22-22,24-24,26-26,28-28,30-30,32-32\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+        }
+    };
+
+    TestCase {
+        "IfRange",
+        []{
+            DirectoryFixture fixture;
+            const String &data = fixture.data();
+            String payload;
+
+            const String tag = fixture.get("/data.txt").header("ETag");
+            CC_INSPECT(tag);
+            CC_VERIFY(tag.startsWith('"'));
+
+            HttpResponse response = fixture.get("/data.txt", "Range: bytes=0-9\r\nIf-Range: " + tag + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(payload == data.copy(0, 10));
+
+            response = fixture.get("/data.txt", "Range: bytes=0-9\r\nIf-Range: \"outdated\"\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+            CC_CHECK(payload == data);
+
+            // If-Range requires a strong match
+            response = fixture.get("/data.txt", "Range: bytes=0-9\r\nIf-Range: W/" + tag + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+
+            const String weakTag = fixture.get("/fresh.txt").header("ETag");
+            CC_INSPECT(weakTag);
+            CC_VERIFY(weakTag.startsWith("W/"));
+            response = fixture.get("/fresh.txt", "Range: bytes=0-9\r\nIf-Range: " + weakTag + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+
+            response = fixture.get("/data.txt", "Range: bytes=0-9\r\nIf-Range: " + fixture.lastModified() + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::PartialContent);
+            CC_CHECK(payload == data.copy(0, 10));
+
+            response = fixture.get("/data.txt", "Range: bytes=0-9\r\nIf-Range: " + httpDateToString(Date{System::now()}) + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+            CC_CHECK(payload == data);
+        }
+    };
+
+    TestCase {
+        "IfNoneMatch",
+        []{
+            DirectoryFixture fixture;
+
+            const String tag = fixture.get("/data.txt").header("ETag");
+            CC_VERIFY(tag.startsWith('"'));
+
+            CC_CHECK(fixture.get("/data.txt", "If-None-Match: " + tag + "\r\n").status() == HttpStatus::NotModified);
+            CC_CHECK(fixture.get("/data.txt", "If-None-Match: \"other\", " + tag + "\r\n").status() == HttpStatus::NotModified);
+            CC_CHECK(fixture.get("/data.txt", "If-None-Match: *\r\n").status() == HttpStatus::NotModified);
+            CC_CHECK(fixture.get("/data.txt", "If-None-Match: \"other\"\r\n").status() == HttpStatus::OK);
+
+            // If-None-Match uses the weak comparison
+            CC_CHECK(fixture.get("/data.txt", "If-None-Match: W/" + tag + "\r\n").status() == HttpStatus::NotModified);
+
+            const String weakTag = fixture.get("/fresh.txt").header("ETag");
+            CC_VERIFY(weakTag.startsWith("W/"));
+            CC_CHECK(fixture.get("/fresh.txt", "If-None-Match: " + weakTag + "\r\n").status() == HttpStatus::NotModified);
+            CC_CHECK(fixture.get("/fresh.txt", "If-None-Match: " + weakTag.copy(2, weakTag.count()) + "\r\n").status() == HttpStatus::NotModified);
+
+            // If-None-Match takes precedence over If-Modified-Since
+            CC_CHECK(
+                fixture.get("/data.txt", "If-None-Match: \"other\"\r\nIf-Modified-Since: " + fixture.lastModified() + "\r\n").status() ==
+                HttpStatus::OK
+            );
+        }
+    };
+
+    TestCase {
+        "IfModifiedSince",
+        []{
+            DirectoryFixture fixture;
+            String payload;
+
+            HttpResponse response = fixture.get("/data.txt", "If-Modified-Since: " + fixture.lastModified() + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::NotModified);
+            CC_CHECK(payload == "");
+
+            response = fixture.get("/data.txt", "If-Modified-Since: " + httpDateToString(Date{System::now()}) + "\r\n");
+            CC_CHECK(response.status() == HttpStatus::NotModified);
+
+            response = fixture.get("/data.txt", "If-Modified-Since: " + httpDateToString(Date{System::now() - 7200}) + "\r\n", &payload);
+            CC_CHECK(response.status() == HttpStatus::OK);
+            CC_CHECK(payload == fixture.data());
+
+            response = fixture.get("/data.txt", "If-Modified-Since: yesterday\r\n");
+            CC_CHECK(response.status() == HttpStatus::OK);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
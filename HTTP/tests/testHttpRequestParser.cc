@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/HttpRequestParser>
+#include <cc/HttpError>
+#include <cc/ReplaySource>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    TestCase {
+        "HeaderFields",
+        []{
+            ReplaySource source { String {
+                "GET /index.html HTTP/1.1\r\n"
+                "Host: Example.COM\r\n"
+                "content-length: 5\r\n"
+                "X-Folded: one\r\n"
+                "  two\r\n"
+                "\tthree\r\n"
+                "X-Empty:\r\n"
+                "X-Padded :  value  \r\n"
+                "Accept: text/html\r\n"
+                "Accept: text/plain\r\n"
+                "\r\n"
+                "hello"
+            } };
+
+            HttpRequestParser parser { source };
+            HttpRequest request = parser.readRequest();
+
+            CC_CHECK(request.method() == "GET");
+            CC_CHECK(request.uri() == "/index.html");
+            CC_CHECK(request.host() == "example.com");
+            CC_CHECK(request.header().count() == 6);
+            CC_CHECK(request.header("Content-Length") == "5");
+            CC_CHECK(request.header("X-FOLDED") == "one two three");
+            CC_CHECK(!request.header().contains("X-Empty"));
+            CC_CHECK(request.header("X-Padded") == "value");
+            CC_CHECK(request.header("Accept") == "text/plain");
+            CC_CHECK(request.header().nameAt(1) == "content-length");
+            CC_CHECK(request.payload().readAll() == "hello");
+
+            List<String> names;
+            for (const KeyValue<String> &field: request.header()) names.append(field.key());
+            CC_CHECK(names.join(',') == "Host,content-length,X-Folded,X-Padded,Accept,Accept");
+        }
+    };
+
+    TestCase {
+        "PipelinedRequests",
+        []{
+            ReplaySource source { String {
+                "GET /a HTTP/1.1\r\nHost: a\r\n\r\n"
+                "POST /b HTTP/1.1\r\nHost: b\r\nContent-Length: 3\r\n\r\nxyz"
+                "GET /c HTTP/1.0\nHost: c\n\n"
+            } };
+
+            HttpRequestParser parser { source };
+            CC_CHECK(parser.readRequest().uri() == "/a");
+            HttpRequest request = parser.readRequest();
+            CC_CHECK(request.uri() == "/b");
+            CC_CHECK(request.payload().readAll() == "xyz");
+            request = parser.readRequest();
+            CC_CHECK(request.uri() == "/c");
+            CC_CHECK(request.host() == "c");
+            CC_CHECK(request.minorVersion() == 0);
+        }
+    };
+
+    TestCase {
+        "MalformedHeaderField",
+        []{
+            ReplaySource source { String { "GET / HTTP/1.1\r\nHost: a\r\nno colon here\r\n\r\n" } };
+            HttpRequestParser parser { source };
+            bool rejected = false;
+            try { parser.readRequest(); }
+            catch (HttpBadRequest &) { rejected = true; }
+            CC_CHECK(rejected);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
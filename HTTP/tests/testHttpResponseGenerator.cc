@@ -0,0 +1,123 @@
+#include <cc/HttpResponseGenerator>
+#include <cc/CaptureSink>
+#include <cc/IoStream>
+#include <cc/File>
+#include <cc/exceptions>
+#include <cc/testing>
+
+namespace cc {
+
+/** Truncate a file as soon as more than a given number of bytes have been written
+  */
+class TruncatingSink final: public Stream
+{
+public:
+    TruncatingSink(const String &path, long long threshold, long long newSize):
+        Stream{new State{path, threshold, newSize}}
+    {}
+
+    long long totalWritten() const { return me().totalWritten_; }
+
+private:
+    struct State final: public Stream::State
+    {
+        State(const String &path, long long threshold, long long newSize):
+            path_{path},
+            threshold_{threshold},
+            newSize_{newSize}
+        {}
+
+        void write(const Bytes &buffer, long fill) override
+        {
+            totalWritten_ += (fill < 0) ? buffer.count() : fill;
+            if (threshold_ >= 0 && totalWritten_ > threshold_) {
+                File{path_, FileOpen::WriteOnly}.truncate(newSize_);
+                threshold_ = -1;
+            }
+        }
+
+        String path_;
+        long long threshold_;
+        long long newSize_;
+        long long totalWritten_ { 0 };
+    };
+
+    const State &me() const { return Object::me.as<State>(); }
+};
+
+} // namespace cc
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    auto createFile = [](long long size) {
+        String path = File::createTemp();
+        String data = String::allocate(size);
+        for (long i = 0; i < data.count(); ++i) data[i] = 'a' + i % 26;
+        File::save(path, data);
+        return path;
+    };
+
+    TestCase {
+        "TransmitFile",
+        [=]{
+            String path = createFile(100000);
+            CaptureSink sink;
+            HttpResponseGenerator response{sink};
+            response.transmitFile(File{path});
+            String message = sink.collect();
+            CC_CHECK(message.contains("Content-Length:100000\r\n"));
+            CC_CHECK(message.endsWith(File{path}.map()));
+            CC_CHECK(response.bytesWritten() == 100000);
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "TruncatedWhileCopying",
+        [=]{
+            String path = createFile(0x40000);
+            TruncatingSink sink{path, 0x10000, 0x18000};
+            HttpResponseGenerator response{sink};
+            bool failed = false;
+            try {
+                response.transmitFile(File{path});
+            }
+            catch (InputExhaustion &) {
+                failed = true;
+            }
+            CC_CHECK(failed);
+            CC_INSPECT(sink.totalWritten());
+            CC_CHECK(sink.totalWritten() < 0x40000);
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "TruncatedBeforeSendFile",
+        [=]{
+            String path = createFile(20000);
+            IoStream a, b;
+            IoStream::pair(&a, &b);
+            HttpResponseGenerator response{a, a};
+            bool failed = false;
+            try {
+                File file{path};
+                File{path, FileOpen::WriteOnly}.truncate(10000);
+                response.transmitFile(file, 0, 20000);
+            }
+            catch (InputExhaustion &) {
+                failed = true;
+            }
+            CC_CHECK(failed);
+            a.close();
+            String message = b.readAll();
+            CC_CHECK(message.contains("Content-Length:20000\r\n"));
+            CC_CHECK(message.endsWith(File{path}.map()));
+            File::unlink(path);
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
@@ -7,6 +7,7 @@
  */
 
 #include <cc/WebSocketStream>
+#include <cc/WebSocketFrame>
 #include <cc/CaptureSink>
 #include <cc/ReplaySource>
 #include <cc/HexDump>
@@ -173,5 +174,69 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "MaskingKernel",
+        []{
+            const uint32_t mask = 0x37FA213D;
+            for (long n = 0; n < 100; ++n) {
+                Bytes data = Bytes::allocate(n);
+                for (long i = 0; i < n; ++i) data[i] = static_cast<uint8_t>(i * 7);
+                Bytes expected = data.copy();
+                for (long i = 0; i < n; ++i) expected[i] ^= static_cast<uint8_t>(mask >> (8 * (3 - (i & 3))));
+                WebSocketFrame::applyMask(data.items(), n, mask);
+                CC_CHECK(data == expected);
+            }
+        }
+    };
+
+    TestCase {
+        "TextMessageMultipleFrameToServerWithFrameBuffer",
+        []{
+            const String testMessage = "Hello, world! Hello, world! Hello, world!";
+
+            CaptureSink sink;
+            {
+                WebSocketStream webSocket { sink, WebSocketStream::Type::ClientToServer };
+                webSocket.maxOutgoingFramePayloadSize(16);
+                CC_CHECK(webSocket.write(testMessage.copy(), WebSocketMessage::Type::Text));
+                CC_CHECK(webSocket.write(String{"Bye!"}, WebSocketMessage::Type::Text));
+            }
+
+            ReplaySource source { sink.writtenData() };
+            {
+                String buffer = String::allocate(32);
+                WebSocketStream webSocket { source, WebSocketStream::Type::ClientToServer };
+                webSocket.incomingFrameBuffer(buffer);
+                String message;
+                CC_CHECK(webSocket.read(&message));
+                CC_CHECK(message == testMessage);
+                CC_CHECK(webSocket.read(&message));
+                CC_CHECK(message == "Bye!");
+            }
+        }
+    };
+
+    TestCase {
+        "LargeBinaryMessageToServer",
+        []{
+            String testMessage = String::allocate(100000);
+            for (long i = 0; i < testMessage.count(); ++i) testMessage[i] = static_cast<char>(i % 251);
+
+            CaptureSink sink;
+            {
+                WebSocketStream webSocket { sink, WebSocketStream::Type::ClientToServer };
+                CC_CHECK(webSocket.write(testMessage.copy(), WebSocketMessage::Type::Binary));
+            }
+
+            ReplaySource source { sink.writtenData() };
+            {
+                WebSocketStream webSocket { source, WebSocketStream::Type::ClientToServer };
+                String message;
+                CC_CHECK(webSocket.read(&message));
+                CC_CHECK(message == testMessage);
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
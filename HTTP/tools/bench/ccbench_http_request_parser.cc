@@ -0,0 +1,57 @@
+#include <cc/HttpRequestParser>
+#include <cc/MemoryStream>
+#include <cc/System>
+#include <cc/stdio>
+#include <cmath>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    const int n = argc > 1 ? String{argv[1]}.toInt() : 100000;
+
+    const String request {
+        "GET /static/js/app.bundle.js?v=20210517 HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:88.0) Gecko/20100101 Firefox/88.0\r\n"
+        "Accept: */*\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Referer: https://www.example.com/index.html\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=8f4e3b2a1c9d; theme=dark; consent=1\r\n"
+        "Sec-Fetch-Dest: script\r\n"
+        "Sec-Fetch-Mode: no-cors\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "If-Modified-Since: Mon, 17 May 2021 10:00:00 GMT\r\n"
+        "If-None-Match: \"5f3a-1b2c-17d8e9f0a1b2c3d4\"\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "Pragma: no-cache\r\n"
+        "\r\n"
+    };
+
+    const int batch = 1000;
+    List<String> parts;
+    for (int i = 0; i < batch; ++i) parts.append(request);
+    const String input { parts };
+
+    fout() << "Parsing " << n << " requests with 15 header fields each... ";
+
+    long long fieldCount = 0;
+    double t = System::now();
+
+    for (int i = 0; i < n; i += batch) {
+        HttpRequestParser parser{MemoryStream{input}};
+        for (int j = 0; j < batch && i + j < n; ++j) {
+            HttpRequest request = parser.readRequest();
+            fieldCount += request.header().count();
+            if (request.header("Host") == "") return 1;
+        }
+    }
+
+    t = System::now() - t;
+
+    fout() << std::round(t * 1000) << " ms (" << std::round(n / t) << " requests/s, " << fieldCount / n << " fields/request)\n";
+
+    return 0;
+}
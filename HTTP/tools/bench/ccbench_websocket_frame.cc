@@ -0,0 +1,70 @@
+#include <cc/WebSocketFrame>
+#include <cc/CaptureSink>
+#include <cc/MemoryStream>
+#include <cc/System>
+#include <cc/stdio>
+#include <cmath>
+
+using namespace cc;
+
+double benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+void xorPayloadBytewise(uint8_t *data, long size, uint32_t mask)
+{
+    for (long i = 0; i < size; ++i) {
+        unsigned j = i & 0x3;
+        data[i] ^= static_cast<uint8_t>(mask >> (8 * (3 - j)));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const long volume = argc > 1 ? String{argv[1]}.toLong() : 64 << 20;
+    const uint32_t mask = 0x37FA213D;
+
+    for (long size: { 64L, 4096L, 1L << 20 }) {
+        const long count = volume / size;
+
+        String payload = String::allocate(size, 'x');
+        Bytes input;
+        {
+            CaptureSink capture;
+            ByteSink sink { capture, ByteOrder::BigEndian };
+            for (long i = 0; i < count; ++i) {
+                WebSocketFrame{WebSocketFrame::Type::Binary, payload.copy()}.writeTo(sink, mask);
+            }
+            input = capture.writtenData();
+        }
+
+        double dt = benchmark([&]{ for (long i = 0; i < count; ++i) xorPayloadBytewise(payload.items(), size, mask); });
+        fout() << size << " B frames\tbytewise masking\t" << std::round(volume / dt / 1e6) << " MB/s\n";
+
+        dt = benchmark([&]{ for (long i = 0; i < count; ++i) WebSocketFrame::applyMask(payload.items(), size, mask); });
+        fout() << size << " B frames\tword-wise masking\t" << std::round(volume / dt / 1e6) << " MB/s\n";
+
+        dt = benchmark([&]{
+            ByteSource source { MemoryStream{input}, ByteOrder::BigEndian };
+            for (long i = 0; i < count; ++i) WebSocketFrame frame { source };
+        });
+        fout() << size << " B frames\tdecoding\t" << std::round(volume / dt / 1e6) << " MB/s\n";
+
+        String buffer = String::allocate(size);
+        dt = benchmark([&]{
+            ByteSource source { MemoryStream{input}, ByteOrder::BigEndian };
+            for (long i = 0; i < count; ++i) WebSocketFrame frame { source, buffer };
+        });
+        fout() << size << " B frames\tdecoding into a reusable buffer\t" << std::round(volume / dt / 1e6) << " MB/s\n";
+    }
+
+    return 0;
+}
@@ -93,6 +93,7 @@ int main(int argc, char *argv[])
             "  -user      switch to user after opening listening socket\n"
             "  -daemon    start as a daemon\n"
             "  -pid-file  write PID in given file\n"
+            "  -reactor   park idle connections in an event loop\n"
         ) << toolName;
     }
 
@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/JsonReader>
+#include <cc/MetaError>
+#include <cc/Color>
+#include <cc/Version>
+#include <cc/Format>
+#include <charconv>
+#include <cstring>
+
+namespace cc {
+
+struct JsonReader::State final: public Object::State
+{
+    State(const Stream &source, const String &buffer):
+        source_{source},
+        buffer_{buffer},
+        n_{source ? 0 : buffer.count()}
+    {}
+
+    bool read(JsonHandler &handler)
+    {
+        depth_ = 0;
+        if (!skipSpace()) return false;
+        readEvents(handler);
+        return true;
+    }
+
+    bool read(Out<Variant> value)
+    {
+        depth_ = 0;
+        if (!skipSpace()) return false;
+        value = readValue();
+        return true;
+    }
+
+    bool readObject(const MetaPrototype &prototype, Out<MetaObject> object)
+    {
+        depth_ = 0;
+        if (!skipSpace()) return false;
+        object = readObject(prototype);
+        return true;
+    }
+
+    Variant readDocument()
+    {
+        depth_ = 0;
+        if (!skipSpace()) fail("Unexpected end of input");
+        Variant value = readValue();
+        if (skipSpace()) fail("Expected end of input");
+        return value;
+    }
+
+    void readEvents(JsonHandler &handler)
+    {
+        int ch = peek();
+        if (ch == '{') {
+            handler.beginObject();
+            readMembers([&](const String &name){
+                handler.key(name);
+                readEvents(handler);
+            });
+            handler.endObject();
+        }
+        else if (ch == '[') {
+            handler.beginArray();
+            readItems([&]{ readEvents(handler); });
+            handler.endArray();
+        }
+        else {
+            handler.value(readScalar());
+        }
+    }
+
+    Variant readValue()
+    {
+        int ch = peek();
+        if (ch == '{') {
+            return readObject(MetaPrototype{});
+        }
+        else if (ch == '[') {
+            List<Variant> list;
+            readItems([&]{ list.append(readValue()); });
+            return list;
+        }
+        return readScalar();
+    }
+
+    MetaObject readObject(const MetaPrototype &prototype)
+    {
+        if (peek() != '{') fail("Expected an object value");
+
+        MetaObject object = prototype ? prototype.produce() : MetaObject{String{}};
+
+        readMembers([&](const String &name){
+            long long memberOffset = offset();
+            Variant memberValue;
+            if (prototype) {
+                Variant defaultValue;
+                if (!prototype.members().lookup(name, &defaultValue)) {
+                    fail(Format{"Illegal member \"%%\" in %%"} << name << prototype.className(), memberOffset);
+                }
+                if (defaultValue.is<MetaPrototype>()) memberValue = readObject(defaultValue.to<MetaPrototype>());
+                else memberValue = readValue(defaultValue);
+            }
+            else {
+                memberValue = readValue();
+            }
+            if (!object.members().insert(name, memberValue)) {
+                fail(Format{"Ambiguous value for member \"%%\""} << name, memberOffset);
+            }
+        });
+
+        if (prototype) {
+            prototype.autocomplete(&object);
+            try {
+                object.realize();
+            }
+            catch (MetaError &error) {
+                fail(error.message());
+            }
+        }
+
+        return object;
+    }
+
+    Variant readValue(const Variant &prototype)
+    {
+        if (prototype.is<void>()) return readValue();
+        if (prototype.is<List<String>>()) return readList<String>();
+        if (prototype.is<List<double>>()) return readList<double>();
+        if (prototype.is<List<long>>()) return readList<long>();
+        if (prototype.is<List<bool>>()) return readList<bool>();
+
+        long long valueOffset = offset();
+        Variant value = readValue();
+
+        if (!prototype.sameTypeAs(value)) {
+            if (prototype.is<String>()) {
+                if (!value.is<MetaObject>() && !value.is<List<Variant>>()) value = str(value);
+            }
+            else if (prototype.is<double>() && value.is<long>()) value = value.to<double>();
+            else if (prototype.is<Color>() && value.is<String>()) value = Color{value.to<String>()};
+            else if (prototype.is<Version>() && value.is<String>()) value = Version{value.to<String>()};
+            else if (prototype.is<List<Variant>>()) value = List<Variant>{value};
+
+            if (!prototype.sameTypeAs(value)) {
+                fail(Format{"Expected a value of type %%"} << prototype.typeName(), valueOffset);
+            }
+        }
+
+        return value;
+    }
+
+    template<class T>
+    List<T> readList()
+    {
+        Variant itemPrototype{T{}};
+        List<T> list;
+        if (peek() == '[') {
+            readItems([&]{ list.append(readValue(itemPrototype).template to<T>()); });
+        }
+        else {
+            list.append(readValue(itemPrototype).template to<T>());
+        }
+        return list;
+    }
+
+    template<class F>
+    void readMembers(F &&readMember)
+    {
+        enter();
+        ++i_;
+        if (!skipSpace()) fail("Missing closing '}'");
+        if (peek() == '}') {
+            ++i_;
+            --depth_;
+            return;
+        }
+        while (true) {
+            if (peek() != '"') fail("Expected a member name");
+            String name = readString();
+            skipSpace();
+            if (peek() != ':') fail("Expected ':'");
+            ++i_;
+            if (!skipSpace()) fail("Expected a value");
+            readMember(name);
+            skipSpace();
+            int ch = peek();
+            if (ch == '}') break;
+            if (ch != ',') fail("Expected ',' or '}'");
+            ++i_;
+            skipSpace();
+        }
+        ++i_;
+        --depth_;
+    }
+
+    template<class F>
+    void readItems(F &&readItem)
+    {
+        enter();
+        ++i_;
+        if (!skipSpace()) fail("Missing closing ']'");
+        if (peek() == ']') {
+            ++i_;
+            --depth_;
+            return;
+        }
+        while (true) {
+            readItem();
+            skipSpace();
+            int ch = peek();
+            if (ch == ']') break;
+            if (ch != ',') fail("Expected ',' or ']'");
+            ++i_;
+            if (!skipSpace()) fail("Expected a value");
+        }
+        ++i_;
+        --depth_;
+    }
+
+    void enter()
+    {
+        if (++depth_ > maxDepth_) fail("Maximum nesting depth exceeded");
+    }
+
+    Variant readScalar()
+    {
+        int ch = peek();
+        if (ch == '"') return readString();
+        if (ch == '-' || ('0' <= ch && ch <= '9')) return readNumber();
+        if ('a' <= ch && ch <= 'z') {
+            long long wordOffset = offset();
+            char word[8];
+            long n = readToken(word, sizeof(word), [](char ch){ return 'a' <= ch && ch <= 'z'; });
+            if (n == 4 && std::memcmp(word, "true", 4) == 0) return true;
+            if (n == 5 && std::memcmp(word, "false", 5) == 0) return false;
+            if (n == 4 && std::memcmp(word, "null", 4) == 0) return Variant{};
+            fail("Expected a value", wordOffset);
+        }
+        fail(ch < 0 ? "Unexpected end of input" : "Expected a value");
+    }
+
+    Variant readNumber()
+    {
+        long long numberOffset = offset();
+        char number[MaxNumberLength];
+        bool isReal = false;
+        long n = readToken(number, MaxNumberLength,
+            [&isReal](char ch){
+                if ('0' <= ch && ch <= '9') return true;
+                if (ch == '.' || ch == 'e' || ch == 'E') return isReal = true;
+                return ch == '-' || ch == '+';
+            }
+        );
+        const char *e = number + n;
+        if (!isReal) {
+            long x = 0;
+            auto result = std::from_chars(number, e, x);
+            if (result.ec == std::errc{} && result.ptr == e) return x;
+            if (result.ec != std::errc::result_out_of_range) fail("Illegal number syntax", numberOffset);
+        }
+        double x = 0;
+        auto result = std::from_chars(number, e, x);
+        if (result.ec != std::errc{} || result.ptr != e) fail("Illegal number syntax", numberOffset);
+        return x;
+    }
+
+    String readString()
+    {
+        ++i_;
+        List<String> parts;
+        bool escaped = false;
+        bool pending = false;
+        while (true) {
+            const char *p = buffer_.chars();
+            long i0 = i_;
+            if (pending && i_ < n_) {
+                ++i_;
+                pending = false;
+            }
+            while (i_ < n_) {
+                char ch = p[i_];
+                if (ch == '"') break;
+                if (ch == '\n') fail("Missing closing '\"'");
+                ++i_;
+                if (ch == '\\') {
+                    escaped = true;
+                    if (i_ == n_) {
+                        pending = true;
+                        break;
+                    }
+                    ++i_;
+                }
+            }
+            if (i_ < n_) {
+                String s = buffer_.copy(i0, i_);
+                ++i_;
+                if (parts.count() > 0) {
+                    parts.append(s);
+                    s = parts.join();
+                }
+                if (escaped) s.expand();
+                return s;
+            }
+            parts.append(buffer_.copy(i0, i_));
+            if (!fill()) fail("Missing closing '\"'");
+        }
+    }
+
+    /** Read a token of at most \a maxCount characters satisfying \a match into \a token
+      */
+    template<class F>
+    long readToken(char *token, long maxCount, F &&match)
+    {
+        long n = 0;
+        do {
+            const char *p = buffer_.chars();
+            while (i_ < n_ && match(p[i_])) {
+                if (n == maxCount) fail("Value too long");
+                token[n++] = p[i_++];
+            }
+        } while (i_ == n_ && fill());
+        return n;
+    }
+
+    bool skipSpace()
+    {
+        do {
+            const char *p = buffer_.chars();
+            for (; i_ < n_; ++i_) {
+                char ch = p[i_];
+                if (ch == '\n') {
+                    ++line_;
+                    lineStart_ = bufferOffset_ + i_ + 1;
+                }
+                else if (ch != ' ' && ch != '\t' && ch != '\r') return true;
+            }
+        } while (fill());
+        return false;
+    }
+
+    int peek()
+    {
+        if (i_ == n_ && !fill()) return -1;
+        return static_cast<unsigned char>(buffer_.at(i_));
+    }
+
+    bool fill()
+    {
+        if (!source_ || eoi_) return false;
+        bufferOffset_ += n_;
+        i_ = 0;
+        n_ = source_.read(&buffer_);
+        if (n_ <= 0) {
+            n_ = 0;
+            eoi_ = true;
+        }
+        return n_ > 0;
+    }
+
+    long long offset() const
+    {
+        return bufferOffset_ + i_;
+    }
+
+    [[noreturn]] void fail(const String &hint, long long errorOffset = -1) const
+    {
+        if (errorOffset < 0) errorOffset = offset();
+        long long column = errorOffset - lineStart_ + 1;
+        if (column < 1) column = 1;
+        long i1 = errorOffset - bufferOffset_;
+        long i0 = lineStart_ - bufferOffset_;
+        if (i1 < 0 || n_ < i1) i0 = i1 = 0;
+        else if (i0 < 0) i0 = 0;
+        String excerpt = buffer_.copy(i0, i1);
+        throw TextError{excerpt, excerpt.count(), Format{"%%:%%: %%"} << line_ << column << hint};
+    }
+
+    static constexpr long MaxNumberLength = 64;
+
+    Stream source_;
+    String buffer_;
+    long long bufferOffset_ { 0 };
+    long i_ { 0 };
+    long n_ { 0 };
+    bool eoi_ { false };
+    long line_ { 1 };
+    long long lineStart_ { 0 };
+    int depth_ { 0 };
+    int maxDepth_ { DefaultMaxDepth };
+};
+
+JsonReader::JsonReader(const String &text):
+    Object{new State{Stream{}, text}}
+{}
+
+JsonReader::JsonReader(const Stream &source, long chunkSize):
+    Object{new State{source, String::allocate(chunkSize)}}
+{}
+
+bool JsonReader::read(JsonHandler &handler)
+{
+    return me().read(handler);
+}
+
+bool JsonReader::read(Out<Variant> value)
+{
+    return me().read(value);
+}
+
+bool JsonReader::readObject(const MetaPrototype &prototype, Out<MetaObject> object)
+{
+    return me().readObject(prototype, object);
+}
+
+Variant JsonReader::readDocument()
+{
+    return me().readDocument();
+}
+
+int JsonReader::maxDepth() const
+{
+    return me().maxDepth_;
+}
+
+void JsonReader::setMaxDepth(int depth)
+{
+    me().maxDepth_ = depth;
+}
+
+long long JsonReader::offset() const
+{
+    return me().offset();
+}
+
+JsonReader::State &JsonReader::me()
+{
+    return Object::me.as<State>();
+}
+
+const JsonReader::State &JsonReader::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
@@ -15,11 +15,14 @@ struct Pattern::State final: public Object::State
 {
     State(const String &text):
         definition_{&rule_},
-        rule_{PatternSyntax{}.compile(text)},
+        rule_{PatternSyntax{}.compile(text, &automaton_)},
         text_{text}
     {}
 
+    bool hasAutomaton() const { return automaton_ && usePatternAutomaton; }
+
     SyntaxDefinition definition_;
+    PatternAutomaton automaton_;
     SyntaxRule rule_;
     String text_;
 };
@@ -30,6 +33,10 @@ Pattern::Pattern(const String &text):
 
 bool Pattern::match(const String &text, Out< List<Range> > captures) const
 {
+    if (!captures.requested() && me().hasAutomaton()) {
+        return me().automaton_.matchAt(text);
+    }
+
     Token token = me().definition_.match(text);
     if (captures.requested()) {
         captures = List<Range>{};
@@ -44,7 +51,14 @@ bool Pattern::match(const String &text, Out< List<Range> > captures) const
 
 Range Pattern::findIn(const String &text, Out<long> offset) const
 {
-    Token token = me().definition_.findIn(text, offset());
+    Token token;
+    if (me().hasAutomaton()) {
+        long i = me().automaton_.findIn(text, offset());
+        if (i >= 0) token = me().definition_.match(text, i);
+    }
+    else {
+        token = me().definition_.findIn(text, offset());
+    }
     Range range;
     if (token) {
         offset = token.i0();
@@ -55,7 +69,24 @@ Range Pattern::findIn(const String &text, Out<long> offset) const
 
 List<String> Pattern::breakUp(const String &text) const
 {
-    return me().definition_.breakUp(text);
+    if (!me().hasAutomaton()) return me().definition_.breakUp(text);
+
+    List<String> parts;
+
+    for (long i = 0; i < text.count();) {
+        long j = i;
+        Range range = findIn(text, &j);
+        if (range) {
+            parts.append(text.copy(i, range.i0()));
+            i = range.i1();
+        }
+        else {
+            parts.append(text.copy(i, text.count()));
+            break;
+        }
+    }
+
+    return parts;
 }
 
 long Pattern::matchLength() const
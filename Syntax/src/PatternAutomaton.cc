@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/PatternAutomaton>
+#include <cc/Array>
+#include <cc/Set>
+#include <cc/Map>
+#include <cc/str>
+#include <cstring>
+
+namespace cc {
+
+bool usePatternAutomaton { true };
+
+struct PatternAutomaton::State final: public Object::State
+{
+    static constexpr std::int32_t Dead = -1;
+    static constexpr std::int32_t Accept = -2;
+    static constexpr std::int32_t Overflow = -3;
+
+    /** Transition table of a deterministic automaton
+      */
+    struct Table {
+        Array<std::int32_t> next; // 256 transitions per state
+        Array<bool> accepting; // accepting at end of input
+        std::int32_t start[2] { Dead, Dead }; // start state at the begin of input and elsewhere
+    };
+
+    static State *create(const List<Step> &steps)
+    {
+        Array<Step> anchoredSteps = Array<Step>::allocate(steps.count());
+        Array<Step> searchSteps = Array<Step>::allocate(steps.count() + 1);
+        searchSteps[0] = Step{StepType::Gap};
+        long i = 0;
+        for (const Step &step: steps) {
+            anchoredSteps[i] = step;
+            searchSteps[++i] = step;
+        }
+
+        State *state = new State;
+        if (
+            !build(anchoredSteps, &state->anchored_) ||
+            !build(searchSteps, &state->searching_)
+        ) {
+            delete state;
+            return nullptr;
+        }
+        state->prepareFilter(anchoredSteps);
+        return state;
+    }
+
+    /** A thread is a position (i, c) inside the pattern: i-th step, c repetitions matched so far
+      */
+    static long thread(long i, long c) { return (i << 32) | c; }
+
+    /** Advance thread (\a i, \a c) over character \a ch (or end of input if \a ch < 0)
+      * \return True if the pattern has been matched before \a ch
+      */
+    static bool advance(const Array<Step> &steps, long i, long c, int ch, bool atBoi, Set<long> &threads)
+    {
+        for (long n = steps.count(); i < n;) {
+            const Step &step = steps[i];
+            switch (step.type) {
+                case StepType::Gap: {
+                    if (ch >= 0) threads.insert(thread(i, 0));
+                    ++i;
+                    c = 0;
+                    break;
+                }
+                case StepType::Boi: {
+                    if (!atBoi) return false;
+                    ++i;
+                    break;
+                }
+                case StepType::Eoi: {
+                    if (ch >= 0) return false;
+                    ++i;
+                    break;
+                }
+                case StepType::Chars: {
+                    if (ch >= 0 && c < step.maxRepeat && step.chars.test(ch)) {
+                        ++c;
+                        if (step.maxRepeat == std::numeric_limits<long>::max() && c > step.minRepeat) {
+                            c = step.minRepeat; // any further repetition behaves the same
+                        }
+                        threads.insert(thread(i, c));
+                        return false;
+                    }
+                    if (c < step.minRepeat) return false;
+                    ++i;
+                    c = 0;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    static bool build(const Array<Step> &steps, Table *table)
+    {
+        Map<String, std::int32_t> ids;
+        List< Set<long> > states;
+        List<bool> boiFlags;
+
+        auto intern = [&](const Set<long> &threads, bool atBoi) -> std::int32_t
+        {
+            List<String> parts;
+            parts << (atBoi ? "^" : "");
+            for (long t: threads) parts << hex(t);
+            String key{parts, ','};
+            std::int32_t id = 0;
+            if (ids.lookup(key, &id)) return id;
+            if (states.count() >= MaxStates) return Overflow;
+            id = states.count();
+            ids.insert(key, id);
+            states.append(threads);
+            boiFlags.append(atBoi);
+            return id;
+        };
+
+        Set<long> init;
+        init.insert(thread(0, 0));
+        table->start[0] = intern(init, true);
+        table->start[1] = intern(init, false);
+
+        List< Array<std::int32_t> > rows;
+        List<bool> accepting;
+
+        for (long s = 0; s < states.count(); ++s) {
+            const Set<long> threads = states.at(s);
+            const bool atBoi = boiFlags.at(s);
+            Array<std::int32_t> row = Array<std::int32_t>::allocate(256);
+            for (int ch = 0; ch < 256; ++ch) {
+                Set<long> next;
+                bool accept = false;
+                for (long t: threads) {
+                    if (advance(steps, t >> 32, t & 0xFFFFFFFF, ch, atBoi, next)) {
+                        accept = true;
+                        break;
+                    }
+                }
+                row[ch] = accept ? Accept : next.count() == 0 ? Dead : intern(next, false);
+                if (row[ch] == Overflow) return false;
+            }
+            bool accept = false;
+            for (long t: threads) {
+                Set<long> next;
+                if (advance(steps, t >> 32, t & 0xFFFFFFFF, -1, atBoi, next)) {
+                    accept = true;
+                    break;
+                }
+            }
+            rows.append(row);
+            accepting.append(accept);
+        }
+
+        table->next = Array<std::int32_t>::allocate(rows.count() * 256);
+        table->accepting = Array<bool>::allocate(rows.count());
+        long s = 0;
+        for (const Array<std::int32_t> &row: rows) {
+            std::memcpy(&table->next[s * 256], &row[0], 256 * sizeof(std::int32_t));
+            table->accepting[s] = accepting.at(s);
+            ++s;
+        }
+
+        return true;
+    }
+
+    static bool run(const Table &table, const String &text, long offset)
+    {
+        const std::uint8_t *p = reinterpret_cast<const std::uint8_t *>(text.chars());
+        const std::int32_t *next = &table.next[0];
+        std::int32_t s = table.start[offset != 0];
+        for (long i = offset, n = text.count(); i < n; ++i) {
+            s = next[(s << 8) | p[i]];
+            if (s < 0) return s == Accept;
+        }
+        return table.accepting[s];
+    }
+
+    /** Determine the literal prefix and the possible first characters of a match
+      */
+    void prepareFilter(const Array<Step> &steps)
+    {
+        long m = 0;
+        while (
+            m < steps.count() &&
+            steps[m].type == StepType::Chars &&
+            steps[m].minRepeat == 1 && steps[m].maxRepeat == 1 &&
+            steps[m].chars.count() == 1
+        ) {
+            ++m;
+        }
+        prefix_ = String::allocate(m);
+        for (long i = 0; i < m; ++i) {
+            int ch = 0;
+            while (!steps[i].chars.test(ch)) ++ch;
+            prefix_[i] = static_cast<char>(ch);
+        }
+
+        for (std::int32_t s: anchored_.start) {
+            if (anchored_.accepting[s]) first_.set();
+            for (int ch = 0; ch < 256; ++ch) {
+                if (anchored_.next[s * 256 + ch] != Dead) first_.set(ch);
+            }
+        }
+    }
+
+    /** Skip to the next offset in \a text where a match could start
+      */
+    long skip(const String &text, long offset) const
+    {
+        if (prefix_.count() > 1) {
+            text.find(prefix_, &offset);
+        }
+        else if (prefix_.count() == 1) {
+            text.find(prefix_.at(0), &offset);
+        }
+        else if (!first_.all()) {
+            const std::uint8_t *p = reinterpret_cast<const std::uint8_t *>(text.chars());
+            for (long n = text.count(); offset < n && !first_.test(p[offset]); ++offset);
+        }
+        return offset;
+    }
+
+    bool matchAt(const String &text, long offset) const
+    {
+        return run(anchored_, text, offset);
+    }
+
+    long findIn(const String &text, long offset) const
+    {
+        if (offset < 0 || !run(searching_, text, offset)) return -1;
+
+        for (long n = text.count(); offset < n; ++offset) {
+            offset = skip(text, offset);
+            if (offset >= n) break;
+            if (run(anchored_, text, offset)) return offset;
+        }
+
+        return -1;
+    }
+
+    Table anchored_;
+    Table searching_;
+    String prefix_;
+    std::bitset<256> first_;
+};
+
+PatternAutomaton PatternAutomaton::create(const List<Step> &steps)
+{
+    State *state = State::create(steps);
+    return state ? PatternAutomaton{state} : PatternAutomaton{};
+}
+
+PatternAutomaton::PatternAutomaton(State *newState):
+    Object{newState}
+{}
+
+bool PatternAutomaton::matchAt(const String &text, long offset) const
+{
+    return me().matchAt(text, offset);
+}
+
+long PatternAutomaton::findIn(const String &text, long offset) const
+{
+    return me().findIn(text, offset);
+}
+
+long PatternAutomaton::stateCount() const
+{
+    return me().anchored_.accepting.count() + me().searching_.accepting.count();
+}
+
+const PatternAutomaton::State &PatternAutomaton::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
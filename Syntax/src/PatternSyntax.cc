@@ -7,6 +7,7 @@
  */
 
 #include <cc/PatternSyntax>
+#include <cc/PatternAutomaton>
 #include <cc/Array>
 #include <cc/Queue>
 #include <cc/input>
@@ -285,6 +286,98 @@ struct PatternSyntax::State: public SyntaxDefinition::State
             NotBehind{compileChoice(text, token.children().first())}.as<SyntaxNode>();
     }
 
+    using Step = PatternAutomaton::Step;
+    using StepType = PatternAutomaton::StepType;
+
+    bool compileSteps(const String &text, List<Step> &steps) const
+    {
+        if (text.count() == 0) return true;
+
+        Token token = match(text);
+        if (!token) return false;
+
+        const Token &choice = token.children().first();
+        return choice.children().count() == 1 && compileSteps(text, choice.children().first(), steps, true);
+    }
+
+    bool compileSteps(const String &text, const Token &token, List<Step> &steps, bool outermost) const
+    {
+        for (const Token &child: token.children()) {
+            if (child.rule() == string) {
+                for (const Token &item: child.children()) {
+                    Step step;
+                    step.chars.set(static_cast<std::uint8_t>(readChar(text, item)));
+                    steps.append(step);
+                }
+            }
+            else if (child.rule() == gap) {
+                if (!outermost) return false;
+                steps.append(Step{StepType::Gap});
+            }
+            else if (child.rule() == boi) steps.append(Step{StepType::Boi});
+            else if (child.rule() == eoi) steps.append(Step{StepType::Eoi});
+            else if (child.rule() == repeat) {
+                Step step;
+                step.minRepeat = 0;
+                step.maxRepeat = std::numeric_limits<long>::max();
+                for (const Token &item: child.children()) {
+                    if (item.rule() == minRepeat) step.minRepeat = readNumber<long>(text.copy(item));
+                    else if (item.rule() == maxRepeat) step.maxRepeat = readNumber<long>(text.copy(item));
+                    else break;
+                }
+                if (!compileChars(text, child.children().last(), step.chars)) return false;
+                steps.append(step);
+            }
+            else if (child.rule() == group) {
+                const Token &choice = child.children().first();
+                if (choice.children().count() == 1) {
+                    if (!compileSteps(text, choice.children().first(), steps, false)) return false;
+                }
+                else {
+                    Step step;
+                    if (!compileChars(text, choice, step.chars)) return false;
+                    steps.append(step);
+                }
+            }
+            else {
+                Step step;
+                if (!compileChars(text, child, step.chars)) return false;
+                steps.append(step);
+            }
+        }
+        return true;
+    }
+
+    bool compileChars(const String &text, const Token &token, std::bitset<256> &chars) const
+    {
+        if (token.rule() == choice) {
+            for (const Token &child: token.children()) {
+                if (child.children().count() != 1) return false;
+                if (!compileChars(text, child.children().first(), chars)) return false;
+            }
+        }
+        else if (token.rule() == group) {
+            return compileChars(text, token.children().first(), chars);
+        }
+        else if (token.rule() == character) {
+            chars.set(static_cast<std::uint8_t>(readChar(text, token)));
+        }
+        else if (token.rule() == any) {
+            chars.set();
+        }
+        else if (token.rule() == rangeMinMax || token.rule() == rangeExplicit) {
+            SyntaxNode node = (token.rule() == rangeMinMax) ? compileRangeMinMax(text, token) : compileRangeExplicit(text, token);
+            for (int ch = 0; ch < 256; ++ch) {
+                char x = static_cast<char>(ch);
+                Token production;
+                if (node.matchNext(String{&x, 1}, 0, production) == 1) chars.set(ch);
+            }
+        }
+        else return false;
+
+        return true;
+    }
+
     char readChar(const String &text, const Token &token) const
     {
         if (token.i1() - token.i0() > 1) {
@@ -372,6 +465,16 @@ SyntaxRule PatternSyntax::compile(const String &text) const
     return SyntaxRule{me().compile(text)};
 }
 
+SyntaxRule PatternSyntax::compile(const String &text, Out<PatternAutomaton> automaton) const
+{
+    SyntaxRule rule = compile(text);
+    List<PatternAutomaton::Step> steps;
+    if (me().compileSteps(text, steps)) {
+        automaton = PatternAutomaton::create(steps);
+    }
+    return rule;
+}
+
 const PatternSyntax::State &PatternSyntax::me() const
 {
     return Object::me.as<State>();
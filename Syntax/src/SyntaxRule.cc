@@ -25,6 +25,8 @@ struct SyntaxRule::State: public SyntaxNode::State
 
     long matchNext(const String &text, long offset, Token &production) const override
     {
+        if (memoized_) return matchMemoized(text, offset, production);
+
         Token token{&production};
         token.setRule(Object::alias<SyntaxRule>(this));
 
@@ -39,11 +41,49 @@ struct SyntaxRule::State: public SyntaxNode::State
         return range[1];
     }
 
+    long matchMemoized(const String &text, long offset, Token &production) const
+    {
+        long end = -1;
+        Token token;
+
+        if (production.recall(this, offset, &end, &token)) {
+            if (end != -1) {
+                token.setParent(production);
+                production.children().emplaceBack(token);
+            }
+            return end;
+        }
+
+        token = Token{&production};
+        token.setRule(Object::alias<SyntaxRule>(this));
+
+        Range range{offset};
+        range[1] = entry_.matchNext(text, range[0], token);
+
+        if (range[1] != -1) {
+            token.setRange(range);
+            production.children().emplaceBack(token);
+        }
+
+        production.memorize(this, offset, range[1], token);
+
+        return range[1];
+    }
+
     long matchLength() const override
     {
         return entry_.matchLength();
     }
 
+    bool first(syntax::FirstSet &set) const override
+    {
+        if (analyzing_) return false;
+        analyzing_ = true;
+        bool ok = entry_.first(set);
+        analyzing_ = false;
+        return ok;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "SyntaxRule{" << entry_.explain() << "}";
@@ -52,6 +92,8 @@ struct SyntaxRule::State: public SyntaxNode::State
     SyntaxNode entry_;
     Object metaData_;
     String name_;
+    bool memoized_ { false };
+    mutable bool analyzing_ { false };
 };
 
 SyntaxRule::SyntaxRule(const SyntaxNode &entry):
@@ -81,6 +123,16 @@ syntax::SyntaxNode SyntaxRule::entry() const
     return me().entry_;
 }
 
+bool SyntaxRule::isMemoized() const
+{
+    return me().memoized_;
+}
+
+void SyntaxRule::setMemoized(bool on)
+{
+    me().memoized_ = on;
+}
+
 Object SyntaxRule::metaData() const
 {
     return me().metaData_;
@@ -14,7 +14,22 @@ namespace cc {
 
 struct Token::MatchState
 {
+    struct MemoKey
+    {
+        const void *rule;
+        long offset;
+
+        std::strong_ordering operator<=>(const MemoKey &other) const = default;
+    };
+
+    struct Memo
+    {
+        long end;
+        Token token;
+    };
+
     Map<String, String> captures_;
+    Map<MemoKey, Memo> memo_;
 };
 
 String Token::State::capturedValue(const String &name) const
@@ -31,6 +46,25 @@ void Token::State::setCapturedValue(const String &name, const String &value)
     root->matchState_->captures_.establish(name, value);
 }
 
+bool Token::State::recall(const void *rule, long offset, Out<long> end, Out<Token> token) const
+{
+    const State *root = getRoot();
+    if (!root->matchState_) return false;
+    Locator pos;
+    if (!root->matchState_->memo_.find(MatchState::MemoKey{rule, offset}, &pos)) return false;
+    const MatchState::Memo &memo = root->matchState_->memo_.at(pos).value();
+    end << memo.end;
+    token << memo.token;
+    return true;
+}
+
+void Token::State::memorize(const void *rule, long offset, long end, const Token &token)
+{
+    const State *root = getRoot();
+    if (!root->matchState_) root->matchState_ = new MatchState;
+    root->matchState_->memo_.insert(MatchState::MemoKey{rule, offset}, MatchState::Memo{end, token});
+}
+
 void Token::State::deleteMatchState()
 {
     delete matchState_;
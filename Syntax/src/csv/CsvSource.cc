@@ -7,30 +7,351 @@
  */
 
 #include <cc/CsvSource>
-#include <cc/CsvSyntax>
+#include <cc/CsvDispatch>
+#include <cc/Array>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#include <immintrin.h>
+#endif
 
 namespace cc {
 
+namespace csv {
+
+static inline bool isSpecial(char ch)
+{
+    return ch == ',' || ch == '"' || ch == '\n' || ch == '\f';
+}
+
+/** Find the first field separator, quote or record terminator in \a p[i, n)
+  * \return Position of the character found or \a n if none was found
+  */
+static long scanPortable(const char *p, long i, long n)
+{
+    while (i < n && !isSpecial(p[i])) ++i;
+    return i;
+}
+
+#if defined __x86_64__ || defined __i386__
+
+static bool detectAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool useAvx2 = detectAvx2();
+
+/** \copydoc scanPortable()
+  */
+__attribute__((target("sse2")))
+static long scanSse2(const char *p, long i, long n)
+{
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i formfeed = _mm_set1_epi8('\f');
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(x, comma), _mm_cmpeq_epi8(x, quote)),
+                    _mm_or_si128(_mm_cmpeq_epi8(x, newline), _mm_cmpeq_epi8(x, formfeed))
+                )
+            )
+        );
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+
+    return scanPortable(p, i, n);
+}
+
+/** \copydoc scanPortable()
+  */
+__attribute__((target("avx2")))
+static long scanAvx2(const char *p, long i, long n)
+{
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i formfeed = _mm256_set1_epi8('\f');
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, comma), _mm256_cmpeq_epi8(x, quote)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, newline), _mm256_cmpeq_epi8(x, formfeed))
+                )
+            )
+        );
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+
+    return scanSse2(p, i, n);
+}
+
+#else
+
+bool useAvx2 = false;
+
+#endif
+
+/** \copydoc scanPortable()
+  */
+static long scan(const char *p, long i, long n)
+{
+    #if defined __x86_64__ || defined __i386__
+    if (useAvx2) return scanAvx2(p, i, n);
+    return scanSse2(p, i, n);
+    #else
+    return scanPortable(p, i, n);
+    #endif
+}
+
+} // namespace csv
+
 struct CsvSource::State final: public Object::State
 {
-    explicit State(const String &text):
-        text_{text}
+    /** Location of a field within the input buffer
+      */
+    struct Span {
+        long i0;
+        long i1;
+        bool escaped;
+    };
+
+    enum class Scan {
+        Complete,
+        Incomplete,
+        End
+    };
+
+    State(const Stream &source, const String &buffer):
+        source_{source},
+        buffer_{buffer},
+        eoi_{!source}
     {
-        text_.trimBom();
+        if (!source_) {
+            buffer_.trimBom();
+            n_ = buffer_.count();
+        }
     }
 
     bool read(Out<List<String>> record)
     {
-        record = CsvSyntax{}.parse(text_, &offset_);
-        return record->count() > 0;
+        List<String> fields;
+        if (nextRecord()) {
+            for (long k = 0; k < fieldCount_; ++k) {
+                fields.append(fields_[k].copy());
+            }
+        }
+        record = fields;
+        return fields.count() > 0;
+    }
+
+    bool nextRecord()
+    {
+        while (true) {
+            Scan result = scan();
+            if (result == Scan::Complete) break;
+            if (result == Scan::End) {
+                fieldCount_ = 0;
+                return false;
+            }
+            if (!fill()) eoi_ = true;
+        }
+        materialize();
+        return true;
+    }
+
+    /** Locate the fields of the next record
+      * \return Scan::Incomplete if more input is needed to decide on the extent of the record
+      */
+    Scan scan()
+    {
+        const char *p = buffer_.chars();
+        long i = i_;
+
+        if (skipTerminators_) {
+            while (i < n_ && (p[i] == '\n' || p[i] == '\f')) ++i;
+            i_ = i;
+            if (i == n_ && !eoi_) return Scan::Incomplete;
+            skipTerminators_ = false;
+        }
+
+        if (i == n_) return eoi_ ? Scan::End : Scan::Incomplete;
+
+        spanCount_ = 0;
+
+        while (true) {
+            if (i == n_) {
+                if (!eoi_) return Scan::Incomplete;
+                append(Span{i, i, false});
+                break;
+            }
+
+            if (p[i] == '"') {
+                long j = i + 1;
+                bool escaped = false;
+                while (true) {
+                    const char *q = static_cast<const char *>(std::memchr(p + j, '"', n_ - j));
+                    if (!q) {
+                        if (!eoi_) return Scan::Incomplete;
+                        fail("Missing closing '\"'", i);
+                    }
+                    long k = q - p;
+                    if (k + 1 == n_ && !eoi_) return Scan::Incomplete;
+                    if (k + 1 < n_ && p[k + 1] == '"') {
+                        escaped = true;
+                        j = k + 2;
+                        continue;
+                    }
+                    append(Span{i + 1, k, escaped});
+                    i = k + 1;
+                    break;
+                }
+            }
+            else {
+                long k = csv::scan(p, i, n_);
+                if (k == n_ && !eoi_) return Scan::Incomplete;
+                append(Span{i, k, false});
+                i = k;
+            }
+
+            if (i == n_) {
+                if (!eoi_) return Scan::Incomplete;
+                break;
+            }
+
+            char ch = p[i];
+            if (ch == ',') {
+                ++i;
+                continue;
+            }
+            if (ch == '\n' || ch == '\f') {
+                ++i;
+                skipTerminators_ = true;
+                break;
+            }
+            fail("Expected ',' or end of line", i);
+        }
+
+        i_ = i;
+        return Scan::Complete;
+    }
+
+    void append(const Span &span)
+    {
+        if (spanCount_ == spans_.count()) {
+            Array<Span> spans = Array<Span>::allocate(spans_.count() > 0 ? 2 * spans_.count() : 16);
+            for (long k = 0; k < spanCount_; ++k) spans[k] = spans_[k];
+            spans_ = spans;
+        }
+        spans_[spanCount_] = span;
+        ++spanCount_;
+    }
+
+    /** Turn the located fields into views of the input buffer
+      */
+    void materialize()
+    {
+        if (fields_.count() < spanCount_) {
+            fields_ = Array<String>::allocate(spans_.count());
+        }
+
+        for (long k = 0; k < spanCount_; ++k) {
+            const Span &span = spans_[k];
+            if (span.escaped) {
+                if (source_) {
+                    char *p = &buffer_[0];
+                    long j = span.i0;
+                    for (long i = span.i0; i < span.i1; ++i, ++j) {
+                        p[j] = p[i];
+                        if (p[i] == '"') ++i;
+                    }
+                    buffer_.selectAs(span.i0, j, &fields_[k]);
+                }
+                else {
+                    fields_[k] = buffer_.copy(span.i0, span.i1);
+                    fields_[k].replace("\"\"", "\"");
+                }
+            }
+            else {
+                buffer_.selectAs(span.i0, span.i1, &fields_[k]);
+            }
+        }
+
+        fieldCount_ = spanCount_;
+    }
+
+    /** Read more input, keeping the current record in front of the buffer
+      */
+    bool fill()
+    {
+        if (eoi_) return false;
+
+        long m = n_ - i_;
+        if (i_ > 0) {
+            char *p = &buffer_[0];
+            std::memmove(p, p + i_, m);
+            bufferOffset_ += i_;
+            i_ = 0;
+        }
+        else if (m == buffer_.count()) {
+            String buffer = String::allocate(2 * m);
+            std::memcpy(&buffer[0], buffer_.chars(), m);
+            buffer_ = buffer;
+        }
+        n_ = m;
+
+        String tail = buffer_.select(n_, buffer_.count());
+        long r = source_.read(&tail);
+        if (r <= 0) return false;
+        n_ += r;
+
+        if (!bomChecked_ && n_ >= 3) {
+            bomChecked_ = true;
+            if (bufferOffset_ == 0 && i_ == 0 && std::memcmp(buffer_.chars(), "\xEF\xBB\xBF", 3) == 0) i_ = 3;
+        }
+
+        return true;
+    }
+
+    long long offset() const
+    {
+        return bufferOffset_ + i_;
     }
 
-    String text_;
-    long offset_ { 0 };
+    [[noreturn]] void fail(const String &hint, long i) const
+    {
+        if (!source_) throw TextError{buffer_, i, hint};
+        throw TextError{buffer_.copy(i_, n_), i - i_, hint};
+    }
+
+    Stream source_;
+    String buffer_;
+    long long bufferOffset_ { 0 };
+    long i_ { 0 };
+    long n_ { 0 };
+    bool eoi_ { false };
+    bool bomChecked_ { false };
+    bool skipTerminators_ { false };
+    Array<Span> spans_;
+    long spanCount_ { 0 };
+    Array<String> fields_;
+    long fieldCount_ { 0 };
 };
 
 CsvSource::CsvSource(const String &text):
-    Object{new State{text}}
+    Object{new State{Stream{}, text}}
+{}
+
+CsvSource::CsvSource(const Stream &source, long chunkSize):
+    Object{new State{source, String::allocate(chunkSize > 0 ? chunkSize : 1)}}
 {}
 
 bool CsvSource::read(Out<List<String>> record)
@@ -38,9 +359,35 @@ bool CsvSource::read(Out<List<String>> record)
     return me().read(record);
 }
 
+bool CsvSource::nextRecord()
+{
+    return me().nextRecord();
+}
+
+long CsvSource::fieldCount() const
+{
+    return me().fieldCount_;
+}
+
+const String &CsvSource::field(long i) const
+{
+    assert(0 <= i && i < me().fieldCount_);
+    return me().fields_[i];
+}
+
+long long CsvSource::offset() const
+{
+    return me().offset();
+}
+
 CsvSource::State &CsvSource::me()
 {
     return Object::me.as<State>();
 }
 
+const CsvSource::State &CsvSource::me() const
+{
+    return Object::me.as<State>();
+}
+
 } // namespace cc
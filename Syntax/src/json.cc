@@ -8,6 +8,7 @@
 
 #include <cc/json>
 #include <cc/YasonSyntax>
+#include <cc/JsonReader>
 #include <cc/JsonWriter>
 #include <cc/CaptureSink>
 
@@ -18,6 +19,11 @@ Variant jsonParse(const String &message)
     return YasonSyntax{}.parse(message);
 }
 
+Variant jsonParse(const Stream &source)
+{
+    return JsonReader{source}.readDocument();
+}
+
 String jsonStringify(const Variant &value)
 {
     CaptureSink sink;
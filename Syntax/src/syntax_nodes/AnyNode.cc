@@ -22,6 +22,12 @@ struct AnyNode::State: public SyntaxNode::State
         return 1;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        set.chars.set();
+        return true;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Any{}";
@@ -22,6 +22,12 @@ struct BoiNode::State: public SyntaxNode::State
         return 0;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        set.nullable = true;
+        return true;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Boi{}";
@@ -35,6 +35,11 @@ struct CaptureNode::State: public SyntaxNode::State
         entry_ = SyntaxNode{};
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return entry_.first(set);
+    }
+
     List<String> explain() const override
     {
         return List<String>{}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/syntax_node/ChoiceDispatch>
+
+namespace cc::syntax {
+
+bool useChoiceDispatch = true;
+
+bool ChoiceDispatch::first(FirstSet &set, const Array<SyntaxNode> &choices) const
+{
+    const int stage = stage_.load(std::memory_order_acquire);
+    if (stage == Analyzing) return false;
+    if (stage == Pending) analyze(choices);
+    if (!known_) return false;
+
+    set.chars |= first_.chars;
+    set.nullable = set.nullable || first_.nullable;
+    return true;
+}
+
+void ChoiceDispatch::analyze(const Array<SyntaxNode> &choices) const
+{
+    stage_.store(Analyzing, std::memory_order_relaxed);
+
+    const long n = choices.count();
+    const std::uint64_t all = (n < 64) ? (std::uint64_t{1} << n) - 1 : ~std::uint64_t{0};
+
+    known_ = true;
+    endMask_ = 0;
+    for (int ch = 0; ch < 256; ++ch) masks_[ch] = 0;
+
+    for (long i = 0; i < n; ++i) {
+        FirstSet set;
+        const bool known = choices.at(i).first(set);
+        if (known) {
+            first_.chars |= set.chars;
+            first_.nullable = first_.nullable || set.nullable;
+        }
+        else {
+            known_ = false;
+        }
+
+        if (i >= MaxChoices) continue;
+
+        const std::uint64_t bit = std::uint64_t{1} << i;
+        const bool unconditional = !known || set.nullable;
+        if (unconditional) endMask_ |= bit;
+        for (int ch = 0; ch < 256; ++ch) {
+            if (unconditional || set.chars.test(ch)) masks_[ch] |= bit;
+        }
+    }
+
+    enabled_ = (n <= MaxChoices);
+    if (enabled_) {
+        enabled_ = (endMask_ != all);
+        for (int ch = 0; ch < 256 && !enabled_; ++ch) {
+            enabled_ = (masks_[ch] != all);
+        }
+    }
+
+    stage_.store(Ready, std::memory_order_release);
+}
+
+} // namespace cc::syntax
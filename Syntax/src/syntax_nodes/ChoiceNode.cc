@@ -7,8 +7,10 @@
  */
 
 #include <cc/syntax_node/ChoiceNode>
+#include <cc/syntax_node/ChoiceDispatch>
 #include <cc/Token>
 #include <limits>
+#include <bit>
 
 namespace cc::syntax {
 
@@ -24,9 +26,24 @@ struct ChoiceNode::State: public SyntaxNode::State
 
     long matchNext(const String &text, long offset, Token &production) const override
     {
+        if (!dispatch_.isReady()) {
+            FirstSet set;
+            analyzeFirst(set);
+        }
+
         auto transaction = production.children().transaction();
 
         long h = -1;
+
+        if (dispatch_.isEnabled()) {
+            for (std::uint64_t mask = dispatch_.viable(text, offset); mask; mask &= mask - 1) {
+                h = choices_.at(std::countr_zero(mask)).matchNext(text, offset, production);
+                if (h == -1) transaction.rollback();
+                else break;
+            }
+            return h;
+        }
+
         for (const SyntaxNode &entry: choices_) {
             h = entry.matchNext(text, offset, production);
             if (h == -1) transaction.rollback();
@@ -36,6 +53,11 @@ struct ChoiceNode::State: public SyntaxNode::State
         return h;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return dispatch_.first(set, choices_);
+    }
+
     long matchLength() const override
     {
         long min = std::numeric_limits<long>::max(), max = -1;
@@ -59,6 +81,7 @@ struct ChoiceNode::State: public SyntaxNode::State
     }
 
     Array<SyntaxNode> choices_;
+    ChoiceDispatch dispatch_;
 };
 
 ChoiceNode::ChoiceNode(std::initializer_list<SyntaxNode> choices):
@@ -33,6 +33,11 @@ struct ContextNode::State: public SyntaxNode::State
         return -1;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return inside_.first(set) && outside_.first(set);
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Context{" << str(static_cast<const void *>(rule_)) << "," << inside_.explain() << "," << outside_.explain() << "}";
@@ -23,6 +23,12 @@ struct EoiNode::State: public SyntaxNode::State
         return 0;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        set.nullable = true;
+        return true;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Eoi{}";
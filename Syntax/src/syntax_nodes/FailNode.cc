@@ -22,6 +22,11 @@ struct FailNode::State: public SyntaxNode::State
         return 0;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return true;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Fail{}";
@@ -30,6 +30,11 @@ struct InlineNode::State: public SyntaxNode::State
         return rule_->entry().matchLength();
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return rule_->first(set);
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Inline{" << str(static_cast<const void *>(rule_)) << "}";
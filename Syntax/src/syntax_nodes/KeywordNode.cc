@@ -37,6 +37,15 @@ struct KeywordNode::State: public SyntaxNode::State
         return -1;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        for (const String &keyword: keywords_) {
+            if (keyword.count() == 0) return false;
+            set.chars.set(static_cast<std::uint8_t>(keyword.at(0)));
+        }
+        return true;
+    }
+
     List<String> explain() const override
     {
         List<String> parts;
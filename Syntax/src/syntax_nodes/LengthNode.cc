@@ -46,6 +46,11 @@ struct LengthNode::State: public SyntaxNode::State
         entry_ = SyntaxNode{};
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return entry_.first(set);
+    }
+
     List<String> explain() const override
     {
         return List<String>{}
@@ -7,8 +7,10 @@
  */
 
 #include <cc/syntax_node/LongestChoiceNode>
+#include <cc/syntax_node/ChoiceDispatch>
 #include <cc/Token>
 #include <limits>
+#include <bit>
 
 namespace cc::syntax {
 
@@ -24,17 +26,32 @@ struct LongestChoiceNode::State: public SyntaxNode::State
 
     long matchNext(const String &text, long offset, Token &production) const override
     {
+        if (!dispatch_.isReady()) {
+            FirstSet set;
+            analyzeFirst(set);
+        }
+
         auto transaction = production.children().transaction();
 
         SyntaxNode bestEntry;
         long m = -1;
-        for (const SyntaxNode &entry: choices_) {
+
+        auto tryEntry = [&](const SyntaxNode &entry) {
             long h = entry.matchNext(text, offset, production);
             transaction.rollback();
             if (m < h) {
                 m = h;
                 bestEntry = entry;
             }
+        };
+
+        if (dispatch_.isEnabled()) {
+            for (std::uint64_t mask = dispatch_.viable(text, offset); mask; mask &= mask - 1) {
+                tryEntry(choices_.at(std::countr_zero(mask)));
+            }
+        }
+        else {
+            for (const SyntaxNode &entry: choices_) tryEntry(entry);
         }
 
         if (bestEntry && !transaction.isEmpty())
@@ -54,6 +71,11 @@ struct LongestChoiceNode::State: public SyntaxNode::State
         return (min != max) ? -1 : max;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return dispatch_.first(set, choices_);
+    }
+
     void decycle() override { choices_ = Array<SyntaxNode>{}; }
 
     List<String> explain() const override
@@ -66,6 +88,7 @@ struct LongestChoiceNode::State: public SyntaxNode::State
     }
 
     Array<SyntaxNode> choices_;
+    ChoiceDispatch dispatch_;
 };
 
 LongestChoiceNode::LongestChoiceNode(std::initializer_list<SyntaxNode> choices):
@@ -22,6 +22,12 @@ struct PassNode::State: public SyntaxNode::State
         return -1;
     }
 
+    bool first(FirstSet &set) const override
+    {
+        set.nullable = true;
+        return true;
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Pass{}";
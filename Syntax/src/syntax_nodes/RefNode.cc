@@ -30,6 +30,11 @@ struct RefNode::State: public SyntaxNode::State
         return rule_->matchLength();
     }
 
+    bool first(FirstSet &set) const override
+    {
+        return rule_->first(set);
+    }
+
     List<String> explain() const override
     {
         return List<String>{} << "Ref{" << str(static_cast<const void *>(rule_)) << "}";
@@ -53,6 +53,15 @@ struct RepeatNode::State: public SyntaxNode::State
         entry_ = SyntaxNode{};
     }
 
+    bool first(FirstSet &set) const override
+    {
+        FirstSet entrySet;
+        if (!entry_.first(entrySet)) return false;
+        set.chars |= entrySet.chars;
+        set.nullable = set.nullable || entrySet.nullable || minRepeat_ == 0;
+        return true;
+    }
+
     List<String> explain() const override
     {
         List<String> parts;
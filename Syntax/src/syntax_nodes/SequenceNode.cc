@@ -52,6 +52,18 @@ struct SequenceNode::State: public SyntaxNode::State
 
     void decycle() override { nodes_ = Array<SyntaxNode>{}; }
 
+    bool first(FirstSet &set) const override
+    {
+        for (const SyntaxNode &entry: nodes_) {
+            FirstSet entrySet;
+            if (!entry.first(entrySet)) return false;
+            set.chars |= entrySet.chars;
+            if (!entrySet.nullable) return true;
+        }
+        set.nullable = true;
+        return true;
+    }
+
     List<String> explain() const override
     {
         List<String> parts;
@@ -8,10 +8,31 @@
 
 #include <cc/syntax_node/SyntaxNode>
 #include <cc/Token>
+#include <cc/Mutex>
+#include <cc/Guard>
 
 namespace cc::syntax {
 
 void SyntaxNode::State::decycle()
 {}
 
+/** Analyze the first characters of this node
+  *
+  * Syntax definitions are shared between threads and some nodes cache their analysis,
+  * therefore the analysis is serialized by a global lock (which is reentrant for the analysing thread).
+  */
+bool SyntaxNode::State::analyzeFirst(FirstSet &set) const
+{
+    static Mutex mutex;
+    static thread_local bool locked = false;
+
+    if (locked) return first(set);
+
+    Guard<Mutex> guard{mutex};
+    locked = true;
+    bool ok = first(set);
+    locked = false;
+    return ok;
+}
+
 } // namespace cc::syntax
@@ -1,4 +1,7 @@
 #include <cc/CsvSource>
+#include <cc/CsvDispatch>
+#include <cc/CsvSyntax>
+#include <cc/ReplaySource>
 #include <cc/testing>
 
 int main(int argc, char *argv[])
@@ -37,5 +40,93 @@ int main(int argc, char *argv[])
         }
     };
 
+    const List<String> samples {
+        "a,b,c\nd,e,f\n",
+        "a,b,c\nd,e,f",
+        "\n\nx\n\n\ny,z\f\n",
+        "\"\",,\"\"\"\",\n,\n",
+        "\"a, \"\"quoted\"\"\nfield\",plain text with some more characters,42\r\n"
+        "0123456789abcdefghijklmnopqrstuvwxyz0123456789,\"\"\"\"\"\"\"\",end",
+        "\xEF\xBB\xBFname,value\n\u00FCber,\"\u00E4\"\n",
+        "one very long field without any separator in it, but then one after 40 characters"
+    };
+
+    TestCase {
+        "SameAsCsvSyntax",
+        [=]{
+            for (bool avx2: { true, false }) {
+                const bool savedAvx2 = csv::useAvx2;
+                if (!avx2) csv::useAvx2 = false;
+                for (const String &text: samples) {
+                    List<List<String>> ideal;
+                    {
+                        String input = text.copy();
+                        input.trimBom();
+                        long offset = 0;
+                        for (List<String> record; (record = CsvSyntax{}.parse(input, &offset)).count() > 0;) {
+                            ideal.append(record);
+                        }
+                    }
+                    {
+                        List<List<String>> table;
+                        for (const List<String> &record: CsvSource{text}) table.append(record);
+                        CC_INSPECT(text);
+                        CC_CHECK(table == ideal);
+                    }
+                    for (long chunkSize = 1; chunkSize <= 9; ++chunkSize) {
+                        List<List<String>> table;
+                        CsvSource source { ReplaySource{text}, chunkSize };
+                        while (source.nextRecord()) {
+                            List<String> record;
+                            for (long k = 0; k < source.fieldCount(); ++k) {
+                                record.append(source.field(k).copy());
+                            }
+                            table.append(record);
+                        }
+                        CC_CHECK(table == ideal);
+                    }
+                }
+                csv::useAvx2 = savedAvx2;
+            }
+        }
+    };
+
+    TestCase {
+        "FieldViews",
+        []{
+            const String text { "x,yy,zzz\n1,\"2\"\"\",3\n" };
+            CsvSource source { text };
+            CC_VERIFY(source.nextRecord());
+            CC_CHECK(source.fieldCount() == 3);
+            CC_CHECK(source.field(1) == "yy");
+            CC_CHECK(source.field(2).chars() == text.chars() + 5);
+            CC_VERIFY(source.nextRecord());
+            CC_CHECK(source.field(1) == "2\"");
+            CC_CHECK(source.offset() == text.count());
+            CC_CHECK(!source.nextRecord());
+            CC_CHECK(source.fieldCount() == 0);
+        }
+    };
+
+    TestCase {
+        "SyntaxErrors",
+        []{
+            for (const char *text: { "a,b\"c\n", "\"abc\"d,e\n", "x\n\"open" }) {
+                for (long chunkSize: { 0l, 1l, 3l }) {
+                    bool failed = false;
+                    try {
+                        CsvSource source = chunkSize > 0 ? CsvSource{ReplaySource{String{text}}, chunkSize} : CsvSource{String{text}};
+                        while (source.nextRecord());
+                    }
+                    catch (TextError &error) {
+                        CC_INSPECT(error.message());
+                        failed = true;
+                    }
+                    CC_CHECK(failed);
+                }
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,234 @@
+#include <cc/JsonReader>
+#include <cc/json>
+#include <cc/ReplaySource>
+#include <cc/testing>
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    class EventLog final: public JsonHandler
+    {
+    public:
+        void beginObject() override { parts_ << "{"; }
+        void key(const String &name) override { parts_ << name + ":"; }
+        void value(const Variant &value) override { parts_ << (value.is<void>() ? String{"null"} : str(value)) + ";"; }
+        void endObject() override { parts_ << "}"; }
+        void beginArray() override { parts_ << "["; }
+        void endArray() override { parts_ << "]"; }
+
+        String text() const { return parts_.join(); }
+
+    private:
+        List<String> parts_;
+    };
+
+    const String message =
+        "{\n"
+        "  \"age\": 17.5,\n"
+        "  \"hobbies\": [ \"sky diving\", \"mountain biking\", \"poetry\" ],\n"
+        "  \"name\": \"Hans \\\"Hansi\\\" Mustermann\",\n"
+        "  \"picture\": {\n"
+        "    \"height\": 300,\n"
+        "    \"uri\": \"http://www.hans-mustermann.de/photo.jpg\",\n"
+        "    \"width\": -400\n"
+        "  },\n"
+        "  \"scores\": [ 1, 2.5e3, [], {} ],\n"
+        "  \"married\": false\n"
+        "}";
+
+    TestCase {
+        "Events",
+        []{
+            EventLog log;
+            JsonReader reader { String{"[1, {\"a\": true, \"b\": null}, \"x\\ty\", [[]], -2.5]"} };
+            CC_VERIFY(reader.read(log));
+            CC_INSPECT(log.text());
+            CC_CHECK(log.text() == "[1;{a:true;b:null;}x\ty;[[]]-2.5;]");
+            CC_CHECK(!reader.read(log));
+        }
+    };
+
+    TestCase {
+        "SameAsYasonSyntax",
+        [=]{
+            String ideal = jsonStringify(jsonParse(message));
+            CC_INSPECT(ideal);
+
+            Variant value;
+            CC_VERIFY(JsonReader{message}.read(&value));
+            CC_CHECK(jsonStringify(value) == ideal);
+
+            for (long chunkSize = 1; chunkSize <= 16; ++chunkSize) {
+                JsonReader reader { ReplaySource{message}, chunkSize };
+                Variant value;
+                CC_VERIFY(reader.read(&value));
+                CC_CHECK(jsonStringify(value) == ideal);
+            }
+
+            CC_CHECK(jsonStringify(jsonParse(ReplaySource{message})) == ideal);
+        }
+    };
+
+    TestCase {
+        "ValueSequence",
+        []{
+            JsonReader reader { ReplaySource{String{"{\"n\": 1}\n{\"n\": 2}\n\n{\"n\": 3}\n"}}, 3 };
+            long sum = 0, count = 0;
+            for (Variant value; reader.read(&value);) {
+                sum += value("n").to<long>();
+                ++count;
+            }
+            CC_CHECK(count == 3);
+            CC_CHECK(sum == 6);
+        }
+    };
+
+    TestCase {
+        "Prototype",
+        [=]{
+            MetaPrototype picture { "Picture" };
+            picture.insert("uri", String{});
+            picture.insert("width", 0l);
+            picture.insert("height", 0l);
+
+            MetaPrototype person { "Person" };
+            person.insert("name", String{});
+            person.insert("age", 0.);
+            person.insert("hobbies", List<String>{});
+            person.insert("scores", List<Variant>{});
+            person.insert("picture", picture);
+            person.insert("married", false);
+            person.insert("email", String{"unknown"});
+
+            MetaObject object;
+            CC_VERIFY(JsonReader{message}.readObject(person, &object));
+            CC_CHECK(object.className() == "Person");
+            CC_CHECK(object("name").to<String>() == "Hans \"Hansi\" Mustermann");
+            CC_CHECK(object("age").to<double>() == 17.5);
+            CC_CHECK(object("hobbies").is<List<String>>());
+            CC_CHECK(object("hobbies").to<List<String>>().count() == 3);
+            CC_CHECK(object("picture").to<MetaObject>().className() == "Picture");
+            CC_CHECK(object("picture").to<MetaObject>()("width").to<long>() == -400);
+            CC_CHECK(object("email").to<String>() == "unknown");
+
+            MetaPrototype point { "Point" };
+            point.insert("x", 0.);
+            point.insert("y", 0.);
+            MetaObject origin;
+            CC_VERIFY(JsonReader{String{"{ \"x\": 1, \"y\": 2 }"}}.readObject(point, &origin));
+            CC_CHECK(origin("x").is<double>());
+            CC_CHECK(origin("y").to<double>() == 2.);
+
+            bool failed = false;
+            try {
+                MetaObject bogus;
+                JsonReader{String{"{ \"x\": 1, \"z\": 2 }"}}.readObject(point, &bogus);
+            }
+            catch (TextError &error) {
+                CC_INSPECT(error.message());
+                failed = true;
+            }
+            CC_CHECK(failed);
+        }
+    };
+
+    TestCase {
+        "SyntaxErrors",
+        []{
+            const List<String> errors {
+                "[1, 2",
+                "[1 2]",
+                "{\"a\" 1}",
+                "{\"a\": 1,}",
+                "\"abc",
+                "tru",
+                "1.2.3",
+                "{a: 1}"
+            };
+            for (const String &text: errors) {
+                bool failed = false;
+                try {
+                    Variant value;
+                    JsonReader{ReplaySource{text}, 2}.read(&value);
+                }
+                catch (TextError &error) {
+                    CC_INSPECT(error.message());
+                    failed = true;
+                }
+                CC_INSPECT(text);
+                CC_CHECK(failed);
+            }
+        }
+    };
+
+    TestCase {
+        "SingleDocument",
+        []{
+            CC_CHECK(jsonParse(ReplaySource{String{" [1, 2] \n"}}).to<List<Variant>>().count() == 2);
+
+            const List<String> errors {
+                "",
+                " \n ",
+                "[1, 2] x",
+                "{} {}",
+                "1 2",
+                "null,"
+            };
+            for (const String &text: errors) {
+                bool failed = false;
+                try {
+                    jsonParse(ReplaySource{text});
+                }
+                catch (TextError &error) {
+                    CC_INSPECT(error.message());
+                    failed = true;
+                }
+                CC_INSPECT(text);
+                CC_CHECK(failed);
+            }
+        }
+    };
+
+    TestCase {
+        "MaxDepth",
+        []{
+            auto nested = [](int depth) -> String {
+                return String{"["}.times(depth) + String{"]"}.times(depth);
+            };
+
+            JsonReader reader { nested(3) };
+            reader.setMaxDepth(3);
+            CC_CHECK(reader.maxDepth() == 3);
+            Variant value;
+            CC_CHECK(reader.read(&value));
+
+            for (const String &text: List<String>{ nested(4), "{\"a\": {\"b\": [{}]}}" }) {
+                bool failed = false;
+                try {
+                    JsonReader reader { ReplaySource{text}, 2 };
+                    reader.setMaxDepth(3);
+                    reader.read(&value);
+                }
+                catch (TextError &error) {
+                    CC_INSPECT(error.message());
+                    failed = true;
+                }
+                CC_CHECK(failed);
+            }
+
+            bool failed = false;
+            try {
+                jsonParse(ReplaySource{nested(JsonReader::DefaultMaxDepth + 1)});
+            }
+            catch (TextError &error) {
+                CC_INSPECT(error.message());
+                failed = true;
+            }
+            CC_CHECK(failed);
+            CC_CHECK(jsonParse(ReplaySource{nested(JsonReader::DefaultMaxDepth)}).is<List<Variant>>());
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
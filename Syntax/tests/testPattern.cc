@@ -1,4 +1,6 @@
 #include <cc/Pattern>
+#include <cc/PatternSyntax>
+#include <cc/PatternAutomaton>
 #include <cc/testing>
 #include <cc/DEBUG>
 
@@ -85,5 +87,121 @@ int main(int argc, char **argv)
         }
     };
 
+    TestCase {
+        "AutomatonSubset",
+        []{
+            const List<String> simple {
+                "*.cc",
+                "*/include/*",
+                "*.(c|h){..2:[^.]}^",
+                "^abc{1..3:[0..9]}",
+                "(ab){2..:[a..f]}*x",
+                "{..:#}z^"
+            };
+            for (const String &text: simple) {
+                PatternAutomaton automaton;
+                PatternSyntax{}.compile(text, &automaton);
+                CC_INSPECT(text);
+                CC_VERIFY(!automaton.isNull());
+            }
+
+            const List<String> complex {
+                "(*).h",
+                "(^>[.-])x",
+                "a|b",
+                "{2:ab}",
+                "(a*)b"
+            };
+            for (const String &text: complex) {
+                PatternAutomaton automaton;
+                PatternSyntax{}.compile(text, &automaton);
+                CC_INSPECT(text);
+                CC_VERIFY(automaton.isNull());
+            }
+        }
+    };
+
+    TestCase {
+        "AutomatonAgrees",
+        []{
+            const List<String> patterns {
+                "*",
+                "a",
+                "*.cc",
+                "*/include/*",
+                "*.(c|h){..2:[^.]}^",
+                "^ab",
+                "ab^",
+                "{2..3:a}a",
+                "{..2:a}b",
+                "{1..:[a..z]}.{1..:[a..z]}",
+                "#b*c",
+                "*b*c",
+                "*a{2..4:b}*c^",
+                "[..c]{..:[^a..b]}x",
+                "(a|b|[x..z]){3:c}",
+                "({1..:a}b)c",
+                "{5..2:a}"
+            };
+
+            const List<String> texts {
+                "",
+                "a",
+                "b",
+                "ab",
+                "abc",
+                "aab",
+                "aaab",
+                "aaaab",
+                "bbc",
+                "abbbc",
+                "abbbbbc",
+                "xyzcc",
+                "hello.cc",
+                "hello.cc.bak",
+                "/usr/include/c++/5/list",
+                "/usr/lib/libnegative.so",
+                "a.b.c",
+                "a.b.c.d.e.f",
+                "test.cpp",
+                "aabcabc",
+                "dx",
+                "\xFFx",
+                "aaabaabaaabcc"
+            };
+
+            for (const String &pattern: patterns) {
+                Pattern a{pattern};
+                for (const String &text: texts) {
+                    bool matchFast = a.match(text);
+                    List<Range> rangesFast;
+                    for (long i = 0; i < text.count(); ++i) {
+                        long offset = i;
+                        rangesFast.append(a.findIn(text, &offset));
+                    }
+                    List<String> partsFast = a.breakUp(text);
+
+                    usePatternAutomaton = false;
+                    bool matchSlow = a.match(text);
+                    List<Range> rangesSlow;
+                    for (long i = 0; i < text.count(); ++i) {
+                        long offset = i;
+                        rangesSlow.append(a.findIn(text, &offset));
+                    }
+                    List<String> partsSlow = a.breakUp(text);
+                    usePatternAutomaton = true;
+
+                    if (matchFast != matchSlow || rangesFast != rangesSlow || partsFast != partsSlow) {
+                        CC_INSPECT(pattern);
+                        CC_INSPECT(text);
+                    }
+                    CC_CHECK(matchFast == matchSlow);
+                    CC_CHECK(rangesFast == rangesSlow);
+                    CC_CHECK(partsFast == partsSlow);
+                }
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
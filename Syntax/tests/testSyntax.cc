@@ -2,8 +2,11 @@
 #include <cc/stdio>
 #include <cc/System>
 #include <cc/SyntaxDefinition>
+#include <cc/Random>
 #include <limits>
 
+namespace cc::syntax { extern bool useChoiceDispatch; }
+
 using namespace cc;
 
 class Expression final: public SyntaxDefinition
@@ -125,6 +128,74 @@ private:
     const State &me() const { return Object::me.as<State>(); }
 };
 
+class NestedPairs final: public SyntaxDefinition
+{
+public:
+    explicit NestedPairs(bool memoized):
+        SyntaxDefinition{new State{memoized}}
+    {}
+
+    long visits() const { return me().visits_; }
+
+    String dump(const String &text, const Token &token) const
+    {
+        String s = token.rule().name() + "(" + text.copy(token.i0(), token.i1());
+        for (const Token &child: token.children()) s += " " + dump(text, child);
+        return s + ")";
+    }
+
+private:
+    struct State final: public SyntaxDefinition::State
+    {
+        SyntaxRule atom {
+            "atom",
+            Repeat{1, Within{'a', 'z'}}
+        };
+
+        SyntaxRule list {
+            "list",
+            Sequence{
+                Match{[this](char ch){ ++visits_; return ch == '['; }},
+                Repeat{0, 1,
+                    Sequence{
+                        &entry,
+                        Repeat{
+                            Sequence{',', &entry}
+                        }
+                    }
+                },
+                ']'
+            }
+        };
+
+        SyntaxRule value {
+            "value",
+            Choice{
+                &list,
+                &atom
+            }
+        };
+
+        SyntaxRule entry {
+            "entry",
+            Choice{
+                Sequence{&value, ':', &value},
+                &value
+            }
+        };
+
+        explicit State(bool memoized):
+            SyntaxDefinition::State{&value}
+        {
+            value.setMemoized(memoized);
+        }
+
+        mutable long visits_ { 0 };
+    };
+
+    const State &me() const { return Object::me.as<State>(); }
+};
+
 int main(int argc, char *argv[])
 {
     TestCase {
@@ -148,5 +219,75 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "PackratMemoization",
+        []{
+            const int depth = 12;
+            String text = String::allocate(depth, '[') + "a:b" + String::allocate(depth, ']');
+
+            NestedPairs plain { false };
+            NestedPairs memoized { true };
+            Token a = plain.match(text);
+            Token b = memoized.match(text);
+            CC_VERIFY(a && b);
+            CC_CHECK(a.i1() == text.count() && b.i1() == text.count());
+            CC_CHECK_EQUALS(plain.dump(text, a), memoized.dump(text, b));
+            CC_INSPECT(plain.visits());
+            CC_INSPECT(memoized.visits());
+            CC_CHECK(plain.visits() >= (1 << depth));
+            CC_CHECK(memoized.visits() <= depth + 2);
+
+            CC_CHECK(!memoized.match("[[a:b]"));
+            CC_CHECK(memoized.match("[a,[b:c],d]").i1() == 11);
+        }
+    };
+
+    TestCase {
+        "FirstCharacters",
+        []{
+            using namespace cc::syntax;
+
+            SequenceNode version { RepeatNode{0, 1, CharNode{'v'}}, RangeNode{'0', '9'} };
+            FirstSet set;
+            CC_VERIFY(version.first(set));
+            CC_CHECK(set.chars.count() == 11 && set.chars.test('v') && set.chars.test('7'));
+            CC_CHECK(!set.nullable);
+
+            ChoiceNode literal { KeywordNode{"true", "false"}, CasefreeNode{"Null"}, PassNode{} };
+            set = FirstSet{};
+            CC_VERIFY(literal.first(set));
+            CC_CHECK(set.chars.count() == 4 && set.chars.test('N') && set.chars.test('n'));
+            CC_CHECK(set.nullable);
+
+            ChoiceNode expected { CharNode{'a'}, ExpectNode{'b'} };
+            SequenceNode search { NotNode{CharNode{'a'}}, FindNode{CharNode{'b'}} };
+            set = FirstSet{};
+            CC_CHECK(!expected.first(set));
+            CC_CHECK(!search.first(set));
+        }
+    };
+
+    TestCase {
+        "ChoiceDispatchAgrees",
+        []{
+            Expression expression;
+            Random random { 11 };
+            const char *atoms[] = { "1", "23", "-4", "(", ")", "+", "-", "*", "/", "x" };
+            for (int k = 0; k < 200; ++k) {
+                String text;
+                for (int j = random.get(1, 12); j > 0; --j) text += atoms[random.get(0, 9)];
+                syntax::useChoiceDispatch = false;
+                double a = expression.eval(text);
+                Token ta = expression.match(text);
+                syntax::useChoiceDispatch = true;
+                double b = expression.eval(text);
+                Token tb = expression.match(text);
+                CC_VERIFY((a == b) || (a != a && b != b));
+                CC_VERIFY(ta.isValid() == tb.isValid());
+                if (ta) CC_VERIFY(ta.i1() == tb.i1());
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,96 @@
+#include <cc/CsvSource>
+#include <cc/CsvDispatch>
+#include <cc/CsvSyntax>
+#include <cc/File>
+#include <cc/input>
+#include <cc/Random>
+#include <cc/System>
+#include <cc/stdio>
+
+using namespace cc;
+
+/** Generate about \a size bytes of CSV records
+  */
+String generate(long size)
+{
+    Random random { 0 };
+    List<String> lines;
+    long total = 0;
+    for (long i = 0; total < size; ++i) {
+        String line =
+            str(i) + ",sensor" + str(random.get(0, 999)) +
+            "," + str(random.get(0, 1000000) / 100.) +
+            "," + str(random.get(-1000, 1000)) +
+            ",\"" + (random.get(0, 9) == 0 ? "a \"\"quoted\"\" remark, with comma" : "plain remark") + "\"" +
+            ",some longer free text describing measurement " + str(i);
+        total += line.count() + 1;
+        lines << line;
+    }
+    return String{lines, '\n'};
+}
+
+/** Run \a method on \a text several times and report the best throughput
+  */
+template<class F>
+void measure(const String &name, const String &text, F &&method)
+{
+    double dt_min = 0;
+    long count = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        count = method(text);
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    fout() << name << "\t" << count << " fields\t" << static_cast<long>(text.count() / dt_min / 1e6) << " MB/s" << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    long size = (argc > 1 ? readNumber<long>(String{argv[1]}) : 50) * 1000000;
+
+    String text = generate(size);
+    String path = File::createTemp();
+    File{path, FileOpen::Overwrite}.write(text);
+
+    fout() << "input\t" << text.count() / 1000000 << " MB" << nl;
+
+    measure("CsvSyntax::parse()", text, [](const String &text){
+        long count = 0, offset = 0;
+        for (List<String> record; (record = CsvSyntax{}.parse(text, &offset)).count() > 0;) count += record.count();
+        return count;
+    });
+
+    measure("CsvSource::read()", text, [](const String &text){
+        long count = 0;
+        for (const List<String> &record: CsvSource{text}) count += record.count();
+        return count;
+    });
+
+    for (bool avx2: { true, false }) {
+        const bool savedAvx2 = csv::useAvx2;
+        if (!avx2) csv::useAvx2 = false;
+        measure(avx2 ? "CsvSource::nextRecord() (AVX2)" : "CsvSource::nextRecord() (SSE2)", text, [](const String &text){
+            long count = 0;
+            for (CsvSource source { text }; source.nextRecord();) count += source.fieldCount();
+            return count;
+        });
+        csv::useAvx2 = savedAvx2;
+    }
+
+    measure("CsvSource::nextRecord(), mapped file", text, [&path](const String &){
+        long count = 0;
+        for (CsvSource source { File{path}.map() }; source.nextRecord();) count += source.fieldCount();
+        return count;
+    });
+
+    measure("CsvSource::nextRecord(), stream", text, [&path](const String &){
+        long count = 0;
+        for (CsvSource source { File{path} }; source.nextRecord();) count += source.fieldCount();
+        return count;
+    });
+
+    File::unlink(path);
+
+    return 0;
+}
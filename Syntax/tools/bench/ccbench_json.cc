@@ -0,0 +1,144 @@
+#include <cc/JsonReader>
+#include <cc/json>
+#include <cc/File>
+#include <cc/FileInfo>
+#include <cc/input>
+#include <cc/Random>
+#include <cc/System>
+#include <cc/str>
+#include <cc/stdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace cc;
+
+String record(long i, Random &random)
+{
+    List<String> tags;
+    for (int k = random.get(0, 4); k > 0; --k) tags << "\"tag" + str(random.get(0, 99)) + "\"";
+    List<String> samples;
+    for (int k = random.get(1, 8); k > 0; --k) samples << str(random.get(0, 100000) / 100.);
+    return
+        "{\"id\": " + str(i) +
+        ", \"name\": \"item " + str(i) + "\"" +
+        ", \"active\": " + (random.get(0, 1) ? "true" : "false") +
+        ", \"price\": " + str(random.get(1, 100000) / 100.) +
+        ", \"tags\": [" + String{tags, ", "} + "]" +
+        ", \"samples\": [" + String{samples, ", "} + "]" +
+        ", \"position\": {\"x\": " + str(random.get(-1000, 1000)) + ", \"y\": " + str(random.get(-1000, 1000)) + "}}";
+}
+
+/** Write about \a size bytes of records, either as a single JSON array or as newline delimited JSON
+  */
+void generate(const String &path, long size, bool lines)
+{
+    File file { path, FileOpen::Overwrite };
+    Random random { 0 };
+    List<String> parts;
+    long total = 0, pending = 0;
+    if (!lines) parts << "[\n";
+    for (long i = 0; total < size; ++i) {
+        String s = record(i, random);
+        if (i > 0 && !lines) parts << ",\n";
+        parts << s;
+        if (lines) parts << "\n";
+        total += s.count() + 2;
+        pending += s.count() + 2;
+        if (pending > 0x100000) {
+            file.write(parts);
+            parts = List<String>{};
+            pending = 0;
+        }
+    }
+    if (!lines) parts << "\n]\n";
+    file.write(parts);
+}
+
+class Counter final: public JsonHandler
+{
+public:
+    void value(const Variant &) override { ++count_; }
+    long count() const { return count_; }
+
+private:
+    long count_ { 0 };
+};
+
+/** Run \a method in a child process and report the throughput and the peak memory usage of the child
+  */
+template<class F>
+void measure(const String &name, const String &path, F &&method)
+{
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        long long size = FileInfo{path}.size();
+        double dt = System::now();
+        long count = method(path);
+        dt = System::now() - dt;
+        struct rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        fout() << name << "\t" << count << " items"
+            << "\t" << static_cast<long>(size / dt / 1e6) << " MB/s"
+            << "\tpeak RSS " << usage.ru_maxrss / 1024 << " MiB" << nl;
+        ::_exit(0);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    long size = (argc > 1 ? readNumber<long>(String{argv[1]}) : 100) * 1000000;
+
+    String arrayPath = File::createTemp();
+    String linesPath = File::createTemp();
+    generate(arrayPath, size, false);
+    generate(linesPath, size, true);
+
+    fout() << "input\t" << FileInfo{arrayPath}.size() / 1000000 << " MB" << nl;
+
+    measure("jsonParse(String) (syntax tree)", arrayPath, [](const String &path){
+        return jsonParse(File::load(path)).to<List<Variant>>().count();
+    });
+
+    measure("jsonParse(Stream)", arrayPath, [](const String &path){
+        return jsonParse(File{path}).to<List<Variant>>().count();
+    });
+
+    measure("JsonReader events", arrayPath, [](const String &path){
+        Counter counter;
+        JsonReader{File{path}}.read(counter);
+        return counter.count();
+    });
+
+    measure("JsonReader values, NDJSON", linesPath, [](const String &path){
+        long count = 0;
+        JsonReader reader { File{path} };
+        for (Variant value; reader.read(&value);) ++count;
+        return count;
+    });
+
+    measure("JsonReader typed objects, NDJSON", linesPath, [](const String &path){
+        MetaPrototype position { "Position" };
+        position.insert("x", 0l);
+        position.insert("y", 0l);
+        MetaPrototype item { "Item" };
+        item.insert("id", 0l);
+        item.insert("name", String{});
+        item.insert("active", false);
+        item.insert("price", 0.);
+        item.insert("tags", List<String>{});
+        item.insert("samples", List<double>{});
+        item.insert("position", position);
+        long count = 0;
+        JsonReader reader { File{path} };
+        for (MetaObject object; reader.readObject(item, &object);) ++count;
+        return count;
+    });
+
+    File::unlink(arrayPath);
+    File::unlink(linesPath);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <cc/Pattern>
+#include <cc/PatternAutomaton>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <cmath>
+
+using namespace cc;
+
+List<String> paths(long count, Random &random)
+{
+    const List<String> dirs { "usr", "include", "lib", "src", "share", "local", "c++", "bits", "sys" };
+    const List<String> suffixes { ".cc", ".h", ".hh", ".cpp", ".so", ".o", ".txt", "" };
+    List<String> list;
+    for (long i = 0; i < count; ++i) {
+        List<String> parts;
+        parts << "";
+        for (int k = random.get(1, 6); k > 0; --k) parts << dirs.at(random.get(0, dirs.count() - 1));
+        parts << "file" + str(i) + suffixes.at(random.get(0, suffixes.count() - 1));
+        list << String{parts, '/'};
+    }
+    return list;
+}
+
+String logText(long count, Random &random)
+{
+    const List<String> levels { "debug", "info", "notice", "warning" };
+    List<String> lines;
+    for (long i = 0; i < count; ++i) {
+        String level = (i % 997 == 996) ? String{"error"} : levels.at(random.get(0, levels.count() - 1));
+        lines << "2021-06-" + str(random.get(10, 30)) + " " + level + ": request " + str(i) + " served in " + str(random.get(1, 999)) + " us";
+    }
+    return String{lines, '\n'};
+}
+
+double matchTime(const Pattern &pattern, const List<String> &list, long *hits)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        long n = 0;
+        double dt = System::now();
+        for (const String &path: list) n += pattern.match(path);
+        dt = System::now() - dt;
+        *hits = n;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+double findTime(const Pattern &pattern, const String &text, long *hits)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        long n = 0;
+        double dt = System::now();
+        for (long offset = 0; pattern.findIn(text, &offset); ++offset) ++n;
+        dt = System::now() - dt;
+        *hits = n;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+int main(int argc, char *argv[])
+{
+    Random random { 0 };
+    List<String> list = paths(100000, random);
+    String text = logText(20000, random);
+
+    for (const char *source: { "*.cc", "*/include/*", "*.(c|h){..2:[^.]}^", "/usr/{1..:[a..z]}/*" }) {
+        Pattern pattern { source };
+        long hitsFast = 0, hitsSlow = 0;
+        double dtFast = matchTime(pattern, list, &hitsFast);
+        usePatternAutomaton = false;
+        double dtSlow = matchTime(pattern, list, &hitsSlow);
+        usePatternAutomaton = true;
+        if (hitsFast != hitsSlow) ferr() << "Results differ for " << source << nl;
+        fout() << "match " << source << "\t" << list.count() << " paths, " << hitsFast << " hits"
+            << "\tinterpreter " << static_cast<long>(std::round(dtSlow * 1e3)) << " ms"
+            << "\tautomaton " << static_cast<long>(std::round(dtFast * 1e3)) << " ms"
+            << "\tspeedup " << fixed(dtSlow / dtFast, 1) << nl;
+    }
+
+    for (const char *source: { "error: request", "{4..4:[0..9]}-06", " {1..3:[0..9]} us" }) {
+        Pattern pattern { source };
+        long hitsFast = 0, hitsSlow = 0;
+        double dtFast = findTime(pattern, text, &hitsFast);
+        usePatternAutomaton = false;
+        double dtSlow = findTime(pattern, text, &hitsSlow);
+        usePatternAutomaton = true;
+        if (hitsFast != hitsSlow) ferr() << "Results differ for " << source << nl;
+        fout() << "findIn \"" << source << "\"\t" << text.count() / 1024 << " KiB, " << hitsFast << " hits"
+            << "\tinterpreter " << static_cast<long>(std::round(dtSlow * 1e3)) << " ms"
+            << "\tautomaton " << static_cast<long>(std::round(dtFast * 1e3)) << " ms"
+            << "\tspeedup " << fixed(dtSlow / dtFast, 1) << nl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <cc/SyntaxDefinition>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <cmath>
+
+using namespace cc;
+
+/** JSON-like grammar with a PEG-typical shared prefix: a list entry is either a
+  * "key: value" pair or a plain value, so each nesting level retries the inner value
+  */
+class Json final: public SyntaxDefinition
+{
+public:
+    explicit Json(bool memoized):
+        SyntaxDefinition{new State{memoized}}
+    {}
+
+private:
+    struct State final: public SyntaxDefinition::State
+    {
+        SyntaxRule noise {
+            Repeat{OneOf{" \t\n\r"}}
+        };
+
+        SyntaxRule integer {
+            Sequence{
+                Repeat{0, 1, '-'},
+                Repeat{1, 20, Within{'0', '9'}}
+            }
+        };
+
+        SyntaxRule real {
+            Sequence{
+                Inline{&integer},
+                '.',
+                Repeat{1, 20, Within{'0', '9'}}
+            }
+        };
+
+        SyntaxRule string {
+            Sequence{
+                '"',
+                Repeat{NoneOf{"\"\n"}},
+                '"'
+            }
+        };
+
+        SyntaxRule object {
+            Sequence{
+                '{',
+                Inline{&noise},
+                Repeat{0, 1,
+                    Sequence{
+                        Inline{&member},
+                        Repeat{
+                            Sequence{
+                                Inline{&noise}, ',', Inline{&noise},
+                                Inline{&member}
+                            }
+                        }
+                    }
+                },
+                Inline{&noise},
+                '}'
+            }
+        };
+
+        SyntaxRule member {
+            Sequence{
+                &string,
+                Inline{&noise}, ':', Inline{&noise},
+                &value
+            }
+        };
+
+        SyntaxRule entry {
+            Choice{
+                Sequence{
+                    &value,
+                    Inline{&noise}, ':', Inline{&noise},
+                    &value
+                },
+                &value
+            }
+        };
+
+        SyntaxRule list {
+            Sequence{
+                '[',
+                Inline{&noise},
+                Repeat{0, 1,
+                    Sequence{
+                        Inline{&entry},
+                        Repeat{
+                            Sequence{
+                                Inline{&noise}, ',', Inline{&noise},
+                                Inline{&entry}
+                            }
+                        }
+                    }
+                },
+                Inline{&noise},
+                ']'
+            }
+        };
+
+        SyntaxRule value {
+            Choice{
+                &real,
+                &integer,
+                &string,
+                &object,
+                &list,
+                Keyword{"true", "false", "null"}
+            }
+        };
+
+        explicit State(bool memoized):
+            SyntaxDefinition::State{&value}
+        {
+            value.setMemoized(memoized);
+        }
+    };
+};
+
+String nested(int depth)
+{
+    return String::allocate(depth, '[') + "1" + String::allocate(depth, ']');
+}
+
+String document(long count, Random &random, int depth = 0)
+{
+    List<String> items;
+    for (long i = 0; i < count; ++i) {
+        int k = random.get(0, 3);
+        if (depth < 6 && k == 0) items << document(random.get(1, 6), random, depth + 1);
+        else if (k == 1) items << "{ \"id\": " + str(random.get(0, 1000)) + ", \"tags\": [\"a\", \"b\"] }";
+        else if (k == 2) items << "\"key" + str(i) + "\": " + str(random.get(0, 1000)) + ".5";
+        else items << "[1, 2, [3, 4]]";
+    }
+    return "[" + String{items, ", "} + "]";
+}
+
+double benchmark(const Json &json, const String &text)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        Token token = json.match(text);
+        dt = System::now() - dt;
+        if (!token || token.i1() != text.count()) ferr() << "Failed to parse the input" << nl;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+int main(int argc, char *argv[])
+{
+    Json plain { false };
+    Json memoized { true };
+
+    for (int depth: { 8, 12, 16, 20 }) {
+        String text = nested(depth);
+        fout() << "nested lists\tdepth " << depth
+            << "\tplain " << static_cast<long>(std::round(benchmark(plain, text) * 1e6)) << " us"
+            << "\tmemoized " << static_cast<long>(std::round(benchmark(memoized, text) * 1e6)) << " us" << nl;
+    }
+
+    Random random { 0 };
+    String text = document(5000, random);
+    fout() << "document\t" << text.count() / 1024 << " KiB"
+        << "\tplain " << static_cast<long>(std::round(benchmark(plain, text) * 1e3)) << " ms"
+        << "\tmemoized " << static_cast<long>(std::round(benchmark(memoized, text) * 1e3)) << " ms" << nl;
+
+    return 0;
+}
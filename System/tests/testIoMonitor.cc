@@ -1,4 +1,5 @@
 #include <cc/IoMonitor>
+#include <cc/List>
 #include <cc/testing>
 
 int main(int argc, char *argv[])
@@ -33,5 +34,40 @@ int main(int argc, char *argv[])
         }
     };
 
+    TestCase {
+        "PollAndEpollBackends",
+        []{
+            for (IoMonitorBackend backend: { IoMonitorBackend::Poll, IoMonitorBackend::Epoll }) {
+                const int n = 8;
+                auto watched = Array<IoStream>::allocate(n);
+                auto peers = Array<IoStream>::allocate(n);
+                IoMonitor monitor{backend};
+                for (int i = 0; i < n; ++i) {
+                    IoStream::pair(&watched[i], &peers[i]);
+                    monitor.watch(watched[i], IoEvent::ReadyRead);
+                }
+                CC_CHECK_EQUALS(monitor.count(), n);
+
+                peers[3].write("x");
+                peers[5].write("y");
+
+                List<IoStream> ready;
+                CC_CHECK(monitor.wait([&](const IoActivity &activity){
+                    CC_CHECK(activity.event() & IoEvent::ReadyRead);
+                    ready.append(activity.target());
+                }));
+                CC_CHECK_EQUALS(ready.count(), 2);
+
+                for (IoStream &stream: ready) {
+                    String message = stream.readSpan(1);
+                    CC_CHECK(message == "x" || message == "y");
+                    monitor.unwatch(stream);
+                }
+                CC_CHECK_EQUALS(monitor.count(), n - 2);
+                CC_CHECK(!monitor.wait([](const IoActivity &){}, 0));
+            }
+        }
+    };
+
     return TestSuite{argc, argv}.run();
 }
@@ -0,0 +1,96 @@
+#include <cc/TokiCxxSyntax>
+#include <cc/TokiShSyntax>
+#include <cc/YasonSyntax>
+#include <cc/File>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <cmath>
+
+namespace cc::syntax { extern bool useChoiceDispatch; }
+
+using namespace cc;
+
+String dump(const Token &token)
+{
+    String s = str(token.i0()) + ":" + str(token.i1()) + "(";
+    for (const Token &child: token.children()) s += dump(child);
+    return s + ")";
+}
+
+double benchmark(const SyntaxDefinition &syntax, const String &text, Out<String> result = None{})
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        Token token = syntax.match(text);
+        dt = System::now() - dt;
+        if (i == 0) result << (token ? dump(token) : String{});
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+String repeated(const List<String> &paths, long size)
+{
+    String text;
+    while (text.count() < size) {
+        for (const String &path: paths) text += File::load(path);
+    }
+    return text;
+}
+
+String yasonDocument(long count, Random &random)
+{
+    List<String> members;
+    for (long i = 0; i < count; ++i) {
+        switch (random.get(0, 4)) {
+            case 0: members << "item" + str(i) + ": " + str(random.get(0, 100000)); break;
+            case 1: members << "item" + str(i) + ": " + str(random.get(0, 1000)) + ".25"; break;
+            case 2: members << "item" + str(i) + ": \"some text " + str(i) + "\""; break;
+            case 3: members << "item" + str(i) + ": [ 1, 2.5, true, #FF00FF, v1.2.3 ]"; break;
+            default: members << "item" + str(i) + ": Node { name: \"node\", active: false, children: [] }"; break;
+        }
+    }
+    return "Document {\n    " + String{members, "\n    "} + "\n}\n";
+}
+
+void report(const char *name, const SyntaxDefinition &syntax, const String &text)
+{
+    String result0, result1;
+    syntax::useChoiceDispatch = false;
+    double dt0 = benchmark(syntax, text, &result0);
+    syntax::useChoiceDispatch = true;
+    double dt1 = benchmark(syntax, text, &result1);
+    if (result0 != result1) ferr() << name << ": production trees differ" << nl;
+    if (result0 == "") ferr() << name << ": no match" << nl;
+
+    fout() << name << "\t" << text.count() / 1024 << " KiB"
+        << "\tsequential " << static_cast<long>(std::round(dt0 * 1e3)) << " ms"
+        << "\tdispatched " << static_cast<long>(std::round(dt1 * 1e3)) << " ms"
+        << "\tspeedup " << fixed(dt0 / dt1, 1) << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    const String root = String{__FILE__}.cdUp().cdUp().cdUp().cdUp();
+
+    report("C++", TokiCxxSyntax{},
+        repeated(List<String>{
+            root / "Core/src/String.cc",
+            root / "Syntax/src/YasonSyntax.cc",
+            root / "Toki/src/TokiCxxSyntax.cc"
+        }, 1 << 20)
+    );
+
+    report("sh", TokiShSyntax{},
+        repeated(List<String>{
+            root / "Build/tools/bootstrap"
+        }, 1 << 20)
+    );
+
+    Random random { 0 };
+    report("YASON", YasonSyntax{}, yasonDocument(20000, random));
+
+    return 0;
+}
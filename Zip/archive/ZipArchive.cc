@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2007-2024 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/ZipArchive>
+#include <cc/Thread>
+#include <cc/System>
+#include <cc/Format>
+#include <cc/File>
+#include <cc/Dir>
+#include <cc/SpinLock>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <zlib.h>
+
+namespace cc {
+
+namespace {
+
+uint16_t readUInt16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readUInt32(const uint8_t *p)
+{
+    return uint32_t{p[0]} | (uint32_t{p[1]} << 8) | (uint32_t{p[2]} << 16) | (uint32_t{p[3]} << 24);
+}
+
+uint64_t readUInt64(const uint8_t *p)
+{
+    return uint64_t{readUInt32(p)} | (uint64_t{readUInt32(p + 4)} << 32);
+}
+
+uint64_t hash(const char *s, long n)
+{
+    uint64_t h = 0xCBF29CE484222325u; // FNV-1a
+    for (long i = 0; i < n; ++i) {
+        h ^= static_cast<uint8_t>(s[i]);
+        h *= 0x100000001B3u;
+    }
+    return h;
+}
+
+} // namespace
+
+struct ZipArchive::State final: public Object::State
+{
+    static constexpr uint32_t EndOfCentralDirectorySignature = 0x06054B50;
+    static constexpr uint32_t Zip64EndOfCentralDirectorySignature = 0x06064B50;
+    static constexpr uint32_t Zip64LocatorSignature = 0x07064B50;
+    static constexpr uint32_t CentralDirectorySignature = 0x02014B50;
+    static constexpr uint32_t LocalHeaderSignature = 0x04034B50;
+    static constexpr long EndOfCentralDirectorySize = 22;
+    static constexpr long Zip64LocatorSize = 20;
+    static constexpr long CentralDirectoryHeaderSize = 46;
+    static constexpr long LocalHeaderSize = 30;
+    static constexpr uint64_t ChunkSize = uint64_t{1} << 30;
+
+    explicit State(const String &path):
+        path_{path},
+        map_{File{path}.map()}
+    {
+        readCentralDirectory();
+        buildIndex();
+    }
+
+    [[noreturn]] void fail(const String &reason) const
+    {
+        throw FormatError{path_, reason};
+    }
+
+    const uint8_t *at(uint64_t offset, uint64_t size) const
+    {
+        if (offset > static_cast<uint64_t>(map_.count()) || size > map_.count() - offset) {
+            fail("Unexpected end of file");
+        }
+        return map_.items() + offset;
+    }
+
+    void readCentralDirectory()
+    {
+        const long n = map_.count();
+        if (n < EndOfCentralDirectorySize) fail("Not a ZIP archive");
+
+        // the end of central directory record is followed by an archive comment of up to 64 KiB,
+        // prefer the record whose comment length matches in case the comment contains a signature itself
+        long eocd = -1;
+        for (long i = n - EndOfCentralDirectorySize, i0 = i > 0xFFFF ? i - 0xFFFF : 0; i >= i0; --i) {
+            if (readUInt32(map_.items() + i) == EndOfCentralDirectorySignature) {
+                if (eocd < 0) eocd = i;
+                if (i + EndOfCentralDirectorySize + readUInt16(map_.items() + i + 20) == n) {
+                    eocd = i;
+                    break;
+                }
+            }
+        }
+        if (eocd < 0) fail("Not a ZIP archive");
+
+        const uint8_t *p = map_.items() + eocd;
+        uint64_t entryCount = readUInt16(p + 10);
+        uint64_t directorySize = readUInt32(p + 12);
+        uint64_t directoryOffset = readUInt32(p + 16);
+
+        if (
+            eocd >= Zip64LocatorSize &&
+            readUInt32(map_.items() + eocd - Zip64LocatorSize) == Zip64LocatorSignature
+        ) {
+            const uint8_t *q = at(readUInt64(map_.items() + eocd - Zip64LocatorSize + 8), 56);
+            if (readUInt32(q) != Zip64EndOfCentralDirectorySignature) fail("Invalid ZIP64 end of central directory");
+            entryCount = readUInt64(q + 32);
+            directorySize = readUInt64(q + 40);
+            directoryOffset = readUInt64(q + 48);
+        }
+
+        const uint8_t *directory = at(directoryOffset, directorySize);
+        if (entryCount > directorySize / CentralDirectoryHeaderSize) fail("Invalid central directory");
+
+        entries_ = Array<ZipEntry>::allocate(static_cast<long>(entryCount));
+
+        uint64_t offset = 0;
+        for (ZipEntry &entry: entries_) {
+            if (directorySize - offset < CentralDirectoryHeaderSize) fail("Invalid central directory");
+            const uint8_t *h = directory + offset;
+            if (readUInt32(h) != CentralDirectorySignature) fail("Invalid central directory");
+
+            const uint16_t nameSize = readUInt16(h + 28);
+            const uint16_t extraSize = readUInt16(h + 30);
+            const uint16_t commentSize = readUInt16(h + 32);
+            const uint64_t headerSize = CentralDirectoryHeaderSize + nameSize + extraSize + commentSize;
+            if (directorySize - offset < headerSize) fail("Invalid central directory");
+
+            entry.flags_ = readUInt16(h + 8);
+            entry.method_ = readUInt16(h + 10);
+            entry.crc32_ = readUInt32(h + 16);
+            entry.compressedSize_ = readUInt32(h + 20);
+            entry.size_ = readUInt32(h + 24);
+            entry.headerOffset_ = readUInt32(h + 42);
+            entry.name_ = String{reinterpret_cast<const char *>(h + CentralDirectoryHeaderSize), nameSize};
+
+            readZip64Extra(h + CentralDirectoryHeaderSize + nameSize, extraSize, &entry);
+
+            offset += headerSize;
+        }
+    }
+
+    /** Read 64 bit sizes and offsets from the ZIP64 extended information extra field
+      */
+    void readZip64Extra(const uint8_t *extra, uint16_t extraSize, InOut<ZipEntry> entry)
+    {
+        for (uint32_t i = 0; i + 4 <= extraSize;) {
+            const uint16_t id = readUInt16(extra + i);
+            const uint16_t size = readUInt16(extra + i + 2);
+            i += 4;
+            if (i + size > extraSize) break;
+            if (id == 0x0001) {
+                const uint8_t *p = extra + i;
+                const uint8_t *e = p + size;
+                if (entry->size_ == 0xFFFFFFFFu && p + 8 <= e) { entry->size_ = readUInt64(p); p += 8; }
+                if (entry->compressedSize_ == 0xFFFFFFFFu && p + 8 <= e) { entry->compressedSize_ = readUInt64(p); p += 8; }
+                if (entry->headerOffset_ == 0xFFFFFFFFu && p + 8 <= e) { entry->headerOffset_ = readUInt64(p); p += 8; }
+                break;
+            }
+            i += size;
+        }
+    }
+
+    /** Build an open addressing hash table of all entry names
+      */
+    void buildIndex()
+    {
+        long capacity = 16;
+        while (capacity < 2 * entries_.count()) capacity <<= 1;
+
+        index_ = Array<long>::allocate(capacity);
+        index_.fill(-1);
+
+        for (long i = 0; i < entries_.count(); ++i) {
+            const String &name = entries_[i].name_;
+            for (uint64_t j = hash(name.chars(), name.count());; ++j) {
+                long &slot = index_[j & (capacity - 1)];
+                if (slot < 0) {
+                    slot = i;
+                    break;
+                }
+                if (entries_[slot].name_ == name) break; // keep the first of duplicate entries
+            }
+        }
+    }
+
+    bool lookup(const String &name, Out<ZipEntry> entry) const
+    {
+        const long mask = index_.count() - 1;
+        for (uint64_t j = hash(name.chars(), name.count());; ++j) {
+            long slot = index_[j & mask];
+            if (slot < 0) return false;
+            if (entries_[slot].name_ == name) {
+                entry = entries_[slot];
+                return true;
+            }
+        }
+    }
+
+    /** Get the compressed data of \a entry
+      */
+    Bytes data(const ZipEntry &entry) const
+    {
+        if (entry.isEncrypted()) fail(Format{"Encrypted entries are not supported: %%"} << entry.name());
+        if (entry.method() != ZipEntry::Method::Stored && entry.method() != ZipEntry::Method::Deflated) {
+            fail(Format{"Unsupported compression method %%: %%"} << entry.method_ << entry.name());
+        }
+
+        const uint8_t *h = at(entry.headerOffset_, LocalHeaderSize);
+        if (readUInt32(h) != LocalHeaderSignature) fail(Format{"Invalid local file header: %%"} << entry.name());
+
+        const uint64_t offset = entry.headerOffset_ + LocalHeaderSize + readUInt16(h + 26) + readUInt16(h + 28);
+        at(offset, entry.compressedSize_);
+
+        Bytes map = map_;
+        return map.select(static_cast<long>(offset), static_cast<long>(offset + entry.compressedSize_));
+    }
+
+    Bytes load(const ZipEntry &entry) const
+    {
+        Bytes data = this->data(entry);
+        Bytes buffer;
+
+        if (entry.method() == ZipEntry::Method::Stored) {
+            buffer = data;
+        }
+        else if (entry.size_ > 0) {
+            buffer = Bytes::allocate(static_cast<long>(entry.size_));
+
+            z_stream stream {};
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) fail("Failed to initialize zlib");
+
+            // zlib counts in 32 bit, so feed entries larger than 4 GiB in chunks
+            uint64_t inFill = 0, outFill = 0;
+            int ret = Z_OK;
+            while (ret == Z_OK) {
+                if (stream.avail_in == 0) {
+                    uint64_t n = std::min<uint64_t>(data.count() - inFill, ChunkSize);
+                    stream.next_in = data.items() + inFill;
+                    stream.avail_in = static_cast<uInt>(n);
+                    inFill += n;
+                }
+                if (stream.avail_out == 0) {
+                    uint64_t n = std::min<uint64_t>(buffer.count() - outFill, ChunkSize);
+                    stream.next_out = buffer.items() + outFill;
+                    stream.avail_out = static_cast<uInt>(n);
+                    outFill += n;
+                }
+                ret = inflate(&stream, Z_NO_FLUSH);
+            }
+            inflateEnd(&stream);
+
+            if (ret != Z_STREAM_END || stream.total_out != entry.size_) {
+                fail(Format{"Corrupt deflate stream: %%"} << entry.name());
+            }
+        }
+
+        if (::crc32_z(::crc32(0, nullptr, 0), buffer.items(), buffer.count()) != entry.crc32_) {
+            fail(Format{"CRC mismatch: %%"} << entry.name());
+        }
+
+        return buffer;
+    }
+
+    String targetPath(const String &dirPath, const ZipEntry &entry) const
+    {
+        const String &name = entry.name_;
+        if (name.startsWith('/') || name.split('/').contains("..")) {
+            fail(Format{"Refusing to extract unsafe path: %%"} << name);
+        }
+        return dirPath / name;
+    }
+
+    void extract(const String &dirPath, const List<ZipEntry> &selection, int concurrency) const
+    {
+        List<ZipEntry> entries;
+        if (selection.count() > 0) entries = selection;
+        else for (const ZipEntry &entry: entries_) entries.append(entry);
+
+        // create the directory structure upfront so that the workers only need to write files
+        List<ZipEntry> files;
+        for (const ZipEntry &entry: entries) {
+            String path = targetPath(dirPath, entry);
+            if (entry.isDirectory()) {
+                Dir::establish(path);
+            }
+            else {
+                Dir::establish(path.cdUp());
+                files.append(entry);
+            }
+        }
+
+        if (concurrency <= 0) concurrency = System::concurrency();
+        if (concurrency > files.count()) concurrency = files.count();
+
+        std::atomic<long> next { 0 };
+        std::atomic<bool> failed { false };
+        std::exception_ptr error;
+        SpinLock errorLock;
+
+        auto work = [&]{
+            while (!failed.load(std::memory_order_relaxed)) {
+                long i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= files.count()) break;
+                try {
+                    const ZipEntry &entry = files.at(i);
+                    File{targetPath(dirPath, entry), FileOpen::Overwrite}.write(load(entry));
+                }
+                catch (...) {
+                    Guard<SpinLock> guard{errorLock};
+                    if (!error) error = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+
+        if (concurrency <= 1) {
+            work();
+        }
+        else {
+            List<Thread> workers;
+            for (int i = 0; i < concurrency; ++i) {
+                workers.append(Thread{work});
+            }
+            for (Thread &worker: workers) worker.start();
+            for (Thread &worker: workers) worker.wait();
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    String path_;
+    Bytes map_;
+    Array<ZipEntry> entries_;
+    Array<long> index_; ///< Hash table of entry indices (-1 for empty slots)
+};
+
+ZipArchive::ZipArchive(const String &path):
+    Object{new State{path}}
+{}
+
+String ZipArchive::path() const
+{
+    return me().path_;
+}
+
+long ZipArchive::count() const
+{
+    return me().entries_.count();
+}
+
+const ZipEntry &ZipArchive::at(long index) const
+{
+    return me().entries_.at(index);
+}
+
+bool ZipArchive::lookup(const String &name, Out<ZipEntry> entry) const
+{
+    return me().lookup(name, entry);
+}
+
+ZipEntryStream ZipArchive::open(const ZipEntry &entry) const
+{
+    return ZipEntryStream{entry, me().data(entry), me().path_};
+}
+
+ZipEntryStream ZipArchive::open(const String &name) const
+{
+    ZipEntry entry;
+    if (!lookup(name, &entry)) throw FormatError{me().path_, Format{"No such entry: %%"} << name};
+    return open(entry);
+}
+
+Bytes ZipArchive::load(const ZipEntry &entry) const
+{
+    return me().load(entry);
+}
+
+void ZipArchive::extract(const String &dirPath, const List<ZipEntry> &entries, int concurrency) const
+{
+    me().extract(dirPath, entries, concurrency);
+}
+
+const ZipEntry *ZipArchive::begin() const
+{
+    return me().entries_.items();
+}
+
+const ZipEntry *ZipArchive::end() const
+{
+    return me().entries_.items() + me().entries_.count();
+}
+
+const ZipArchive::State &ZipArchive::me() const
+{
+    return Object::me.as<State>();
+}
+
+String ZipArchive::FormatError::message() const
+{
+    return Format{"%%: %%"} << zipPath_ << reason_;
+}
+
+} // namespace cc
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2007-2024 Frank Mertens.
+ *
+ * Distribution and use is allowed under the terms of the Apache License version 2.0
+ * (see CoreComponents/LICENSE-Apache-2.0).
+ *
+ */
+
+#include <cc/ZipEntryStream>
+#include <cc/ZipArchive>
+#include <cc/Format>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+namespace cc {
+
+struct ZipEntryStream::State final: public Stream::State
+{
+    State(const ZipEntry &entry, const Bytes &data, const String &zipPath):
+        entry_{entry},
+        data_{data},
+        zipPath_{zipPath}
+    {
+        if (isDeflated()) reset();
+    }
+
+    ~State()
+    {
+        if (initialized_) inflateEnd(&stream_);
+    }
+
+    bool isDeflated() const
+    {
+        return entry_.method() == ZipEntry::Method::Deflated;
+    }
+
+    void reset()
+    {
+        if (initialized_) inflateEnd(&stream_);
+        stream_ = z_stream{};
+        if (inflateInit2(&stream_, -MAX_WBITS) != Z_OK) {
+            throw ZipArchive::FormatError{zipPath_, "Failed to initialize zlib"};
+        }
+        initialized_ = true;
+        inFill_ = 0;
+        pos_ = 0;
+        crc_ = ::crc32(0, nullptr, 0);
+    }
+
+    long read(Out<Bytes> buffer, long maxFill = -1) override
+    {
+        if (maxFill < 0 || maxFill > buffer->count()) maxFill = buffer->count();
+        long n = std::min<long long>(maxFill, static_cast<long long>(entry_.size()) - pos_);
+        if (n <= 0) return 0;
+
+        if (!isDeflated()) {
+            n = std::min<long long>(n, data_.count() - pos_);
+            if (n <= 0) return 0;
+            std::memcpy(buffer->items(), data_.items() + pos_, n);
+            return verify(buffer->items(), n);
+        }
+
+        stream_.next_out = buffer->items();
+        stream_.avail_out = static_cast<uInt>(n);
+
+        while (stream_.avail_out > 0) {
+            if (stream_.avail_in == 0) {
+                long long m = std::min<long long>(data_.count() - inFill_, 0x10000);
+                stream_.next_in = data_.items() + inFill_;
+                stream_.avail_in = static_cast<uInt>(m);
+                inFill_ += m;
+            }
+            int ret = inflate(&stream_, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) break;
+            if (ret != Z_OK) {
+                throw ZipArchive::FormatError{zipPath_, Format{"Corrupt deflate stream: %%"} << entry_.name()};
+            }
+        }
+
+        return verify(buffer->items(), n - stream_.avail_out);
+    }
+
+    /** Advance the read position by \a n bytes and check the CRC-32 once the end of the entry has been reached
+      */
+    long verify(const uint8_t *data, long n)
+    {
+        if (crcValid_) crc_ = ::crc32_z(crc_, data, n);
+        pos_ += n;
+
+        if (crcValid_ && pos_ == static_cast<long long>(entry_.size()) && crc_ != entry_.crc32()) {
+            throw ZipArchive::FormatError{zipPath_, Format{"CRC mismatch: %%"} << entry_.name()};
+        }
+
+        return n;
+    }
+
+    long long seek(long long offset)
+    {
+        offset = std::clamp<long long>(offset, 0, entry_.size());
+
+        if (!isDeflated()) {
+            if (offset != pos_) {
+                // skipping parts of a stored entry makes it impossible to verify its CRC-32
+                crcValid_ = (offset == 0);
+                crc_ = ::crc32(0, nullptr, 0);
+                pos_ = offset;
+            }
+            return pos_;
+        }
+
+        if (offset < pos_) reset();
+        if (offset > pos_) {
+            Bytes buffer = Bytes::allocate(0x10000);
+            while (pos_ < offset) {
+                if (read(&buffer, std::min<long long>(offset - pos_, buffer.count())) == 0) break;
+            }
+        }
+        return pos_;
+    }
+
+    ZipEntry entry_;
+    Bytes data_;
+    String zipPath_;
+    z_stream stream_ {};
+    bool initialized_ { false };
+    long long inFill_ { 0 };
+    long long pos_ { 0 };
+    uLong crc_ { 0 };
+    bool crcValid_ { true };
+};
+
+ZipEntryStream::ZipEntryStream(const ZipEntry &entry, const Bytes &data, const String &zipPath):
+    Stream{new State{entry, data, zipPath}}
+{}
+
+long long ZipEntryStream::size() const
+{
+    return me().entry_.size();
+}
+
+long long ZipEntryStream::pos() const
+{
+    return me().pos_;
+}
+
+long long ZipEntryStream::seek(long long offset)
+{
+    return me().seek(offset);
+}
+
+ZipEntryStream::State &ZipEntryStream::me()
+{
+    return Object::me.as<State>();
+}
+
+const ZipEntryStream::State &ZipEntryStream::me() const
+{
+    return Object::me.as<State>();
+}
+
+} // namespace cc
@@ -0,0 +1,438 @@
+#include <cc/ZipArchive>
+#include <cc/ByteSink>
+#include <cc/File>
+#include <cc/Dir>
+#include <cc/DirWalk>
+#include <cc/testing>
+#include <zlib.h>
+
+namespace cc {
+
+/** Item to be written by ZipBuilder
+  */
+struct ZipItem
+{
+    String name;
+    String data;
+    bool deflate { false };
+    bool corruptCrc { false };
+};
+
+/** Minimal ZIP archive writer (stored and deflated entries, optionally ZIP64)
+  */
+class ZipBuilder
+{
+public:
+    explicit ZipBuilder(bool zip64 = false, const String &comment = ""):
+        zip64_{zip64},
+        comment_{comment}
+    {}
+
+    ZipBuilder &add(const ZipItem &item)
+    {
+        items_.append(item);
+        return *this;
+    }
+
+    String save() const
+    {
+        struct Record {
+            ZipItem item;
+            uint32_t crc;
+            uint64_t compressedSize;
+            uint64_t headerOffset;
+        };
+
+        const String path = File::createTemp();
+        File file{path, FileOpen::Overwrite};
+        ByteSink sink{file};
+        List<Record> records;
+
+        for (const ZipItem &item: items_) {
+            const String payload = item.deflate ? deflate(item.data) : item.data;
+            uint32_t crc = ::crc32(0, reinterpret_cast<const Bytef *>(item.data.chars()), item.data.count());
+            if (item.corruptCrc) crc ^= 1;
+            records.append(Record{item, crc, static_cast<uint64_t>(payload.count()), static_cast<uint64_t>(sink.currentOffset())});
+
+            sink.writeUInt32(0x04034B50);
+            sink.writeUInt16(20); // version needed to extract
+            sink.writeUInt16(0); // general purpose flags
+            sink.writeUInt16(item.deflate ? 8 : 0);
+            sink.writeUInt16(0); // modification time
+            sink.writeUInt16(0x21); // modification date
+            sink.writeUInt32(crc);
+            sink.writeUInt32(payload.count());
+            sink.writeUInt32(item.data.count());
+            sink.writeUInt16(item.name.count());
+            sink.writeUInt16(0);
+            sink.write(item.name);
+            sink.write(payload);
+        }
+
+        const uint64_t directoryOffset = sink.currentOffset();
+
+        for (const Record &record: records) {
+            sink.writeUInt32(0x02014B50);
+            sink.writeUInt16(zip64_ ? 45 : 20); // version made by
+            sink.writeUInt16(zip64_ ? 45 : 20); // version needed to extract
+            sink.writeUInt16(0);
+            sink.writeUInt16(record.item.deflate ? 8 : 0);
+            sink.writeUInt16(0);
+            sink.writeUInt16(0x21);
+            sink.writeUInt32(record.crc);
+            sink.writeUInt32(zip64_ ? 0xFFFFFFFFu : record.compressedSize);
+            sink.writeUInt32(zip64_ ? 0xFFFFFFFFu : record.item.data.count());
+            sink.writeUInt16(record.item.name.count());
+            sink.writeUInt16(zip64_ ? 28 : 0); // extra field length
+            sink.writeUInt16(0); // comment length
+            sink.writeUInt16(0); // disk number
+            sink.writeUInt16(0); // internal attributes
+            sink.writeUInt32(0); // external attributes
+            sink.writeUInt32(zip64_ ? 0xFFFFFFFFu : record.headerOffset);
+            sink.write(record.item.name);
+            if (zip64_) {
+                sink.writeUInt16(0x0001);
+                sink.writeUInt16(24);
+                sink.writeUInt64(record.item.data.count());
+                sink.writeUInt64(record.compressedSize);
+                sink.writeUInt64(record.headerOffset);
+            }
+        }
+
+        const uint64_t directorySize = sink.currentOffset() - directoryOffset;
+
+        if (zip64_) {
+            const uint64_t recordOffset = sink.currentOffset();
+            sink.writeUInt32(0x06064B50);
+            sink.writeUInt64(44); // size of the remaining record
+            sink.writeUInt16(45);
+            sink.writeUInt16(45);
+            sink.writeUInt32(0);
+            sink.writeUInt32(0);
+            sink.writeUInt64(records.count());
+            sink.writeUInt64(records.count());
+            sink.writeUInt64(directorySize);
+            sink.writeUInt64(directoryOffset);
+
+            sink.writeUInt32(0x07064B50);
+            sink.writeUInt32(0);
+            sink.writeUInt64(recordOffset);
+            sink.writeUInt32(1);
+        }
+
+        sink.writeUInt32(0x06054B50);
+        sink.writeUInt16(0);
+        sink.writeUInt16(0);
+        sink.writeUInt16(zip64_ ? 0xFFFF : records.count());
+        sink.writeUInt16(zip64_ ? 0xFFFF : records.count());
+        sink.writeUInt32(zip64_ ? 0xFFFFFFFFu : directorySize);
+        sink.writeUInt32(zip64_ ? 0xFFFFFFFFu : directoryOffset);
+        sink.writeUInt16(comment_.count());
+        sink.write(comment_);
+        sink.flush();
+
+        return path;
+    }
+
+    static String deflate(const String &data)
+    {
+        z_stream stream {};
+        deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        String buffer = String::allocate(deflateBound(&stream, data.count()));
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.chars()));
+        stream.avail_in = data.count();
+        stream.next_out = reinterpret_cast<Bytef *>(buffer.chars());
+        stream.avail_out = buffer.count();
+        ::deflate(&stream, Z_FINISH);
+        deflateEnd(&stream);
+        buffer.truncate(stream.total_out);
+        return buffer;
+    }
+
+private:
+    bool zip64_;
+    String comment_;
+    List<ZipItem> items_;
+};
+
+String asText(const Bytes &data)
+{
+    return String{data, 0, data.count()};
+}
+
+String sampleText(long size)
+{
+    String text = String::allocate(size);
+    for (long i = 0; i < size; ++i) text[i] = "The quick brown fox jumps over the lazy dog.\n"[i % 45];
+    return text;
+}
+
+} // namespace cc
+
+int main(int argc, char *argv[])
+{
+    using namespace cc;
+
+    TestCase {
+        "StoredAndDeflated",
+        []{
+            const String text = sampleText(100000);
+            const String path =
+                ZipBuilder{}
+                .add(ZipItem{"stored.txt", text})
+                .add(ZipItem{"deflated.txt", text, true})
+                .save();
+
+            ZipArchive archive{path};
+            CC_CHECK(archive.count() == 2);
+            CC_CHECK(archive.at(0).name() == "stored.txt");
+            CC_CHECK(archive.at(1).name() == "deflated.txt");
+
+            ZipEntry entry;
+            CC_VERIFY(archive.lookup("deflated.txt", &entry));
+            CC_CHECK(entry.method() == ZipEntry::Method::Deflated);
+            CC_CHECK(entry.size() == 100000);
+            CC_CHECK(entry.compressedSize() < entry.size());
+            CC_CHECK(asText(archive.load(entry)) == text);
+            CC_CHECK(archive.open(entry).readAll() == text);
+
+            CC_VERIFY(archive.lookup("stored.txt", &entry));
+            CC_CHECK(entry.method() == ZipEntry::Method::Stored);
+            CC_CHECK(asText(archive.load(entry)) == text);
+            CC_CHECK(archive.open("stored.txt").readAll() == text);
+
+            CC_CHECK(!archive.lookup("missing.txt"));
+            bool failed = false;
+            try { archive.open("missing.txt"); }
+            catch (ZipArchive::FormatError &error) {
+                CC_INSPECT(error.message());
+                failed = true;
+            }
+            CC_CHECK(failed);
+
+            long n = 0;
+            for (const ZipEntry &entry: archive) {
+                CC_CHECK(archive.lookup(entry.name()));
+                ++n;
+            }
+            CC_CHECK(n == 2);
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "Empty",
+        []{
+            {
+                const String path = ZipBuilder{}.save();
+                ZipArchive archive{path};
+                CC_CHECK(archive.count() == 0);
+                CC_CHECK(!archive.lookup("any"));
+                File::unlink(path);
+            }
+            {
+                const String path =
+                    ZipBuilder{}
+                    .add(ZipItem{"empty-stored", ""})
+                    .add(ZipItem{"empty-deflated", "", true})
+                    .save();
+                ZipArchive archive{path};
+                CC_CHECK(archive.count() == 2);
+                for (const ZipEntry &entry: archive) {
+                    CC_CHECK(entry.size() == 0);
+                    CC_CHECK(archive.load(entry).count() == 0);
+                    CC_CHECK(archive.open(entry).readAll() == "");
+                }
+                File::unlink(path);
+            }
+        }
+    };
+
+    TestCase {
+        "Zip64",
+        []{
+            const String text = sampleText(5000);
+            const String path =
+                ZipBuilder{true}
+                .add(ZipItem{"a.txt", text})
+                .add(ZipItem{"b.txt", text, true})
+                .save();
+
+            ZipArchive archive{path};
+            CC_CHECK(archive.count() == 2);
+            ZipEntry entry;
+            CC_VERIFY(archive.lookup("b.txt", &entry));
+            CC_CHECK(entry.size() == 5000);
+            CC_CHECK(asText(archive.load(entry)) == text);
+            CC_VERIFY(archive.lookup("a.txt", &entry));
+            CC_CHECK(entry.compressedSize() == 5000);
+            CC_CHECK(archive.open(entry).readAll() == text);
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "Commented",
+        []{
+            const String comment = "Archive comment, which even mentions an end of central directory signature: PK\x05\x06";
+            const String path =
+                ZipBuilder{false, comment}
+                .add(ZipItem{"hello.txt", "Hello, world!\n"})
+                .save();
+
+            ZipArchive archive{path};
+            CC_CHECK(archive.count() == 1);
+            CC_CHECK(asText(archive.load(archive.at(0))) == "Hello, world!\n");
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "Seek",
+        []{
+            const String text = sampleText(200000);
+            const String path =
+                ZipBuilder{}
+                .add(ZipItem{"stored.txt", text})
+                .add(ZipItem{"deflated.txt", text, true})
+                .save();
+
+            ZipArchive archive{path};
+            for (const ZipEntry &entry: archive) {
+                ZipEntryStream stream = archive.open(entry);
+                CC_CHECK(stream.size() == text.count());
+
+                CC_CHECK(stream.seek(150000) == 150000);
+                CC_CHECK(stream.readSpan(100) == text.copy(150000, 150100));
+                CC_CHECK(stream.pos() == 150100);
+
+                CC_CHECK(stream.seek(1000) == 1000);
+                CC_CHECK(stream.readSpan(100) == text.copy(1000, 1100));
+
+                CC_CHECK(stream.seek(text.count() + 1000) == text.count());
+                CC_CHECK(stream.readAll() == "");
+
+                CC_CHECK(stream.seek(0) == 0);
+                CC_CHECK(stream.readAll() == text);
+            }
+
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "CrcCorruption",
+        []{
+            const String text = sampleText(10000);
+            const String path =
+                ZipBuilder{}
+                .add(ZipItem{"stored.txt", text, false, true})
+                .add(ZipItem{"deflated.txt", text, true, true})
+                .save();
+
+            ZipArchive archive{path};
+            for (const ZipEntry &entry: archive) {
+                int failCount = 0;
+                try { archive.load(entry); }
+                catch (ZipArchive::FormatError &error) {
+                    CC_INSPECT(error.message());
+                    ++failCount;
+                }
+                try { archive.open(entry).readAll(); }
+                catch (ZipArchive::FormatError &error) {
+                    CC_INSPECT(error.message());
+                    ++failCount;
+                }
+                CC_CHECK(failCount == 2);
+            }
+
+            const String dirPath = path + "_out";
+            Dir::establish(dirPath);
+            bool failed = false;
+            try { archive.extract(dirPath); }
+            catch (ZipArchive::FormatError &) { failed = true; }
+            CC_CHECK(failed);
+
+            Dir::deplete(dirPath);
+            Dir::remove(dirPath);
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "Extract",
+        []{
+            const String text = sampleText(30000);
+            ZipBuilder builder;
+            builder.add(ZipItem{"docs/", ""});
+            for (int i = 0; i < 20; ++i) {
+                builder.add(ZipItem{Format{"docs/part%%/file%%.txt"} << i % 3 << i, text.copy(0, 1000 * i), i % 2 == 0});
+            }
+            const String path = builder.save();
+            const String dirPath = path + "_out";
+            Dir::establish(dirPath);
+
+            ZipArchive archive{path};
+            archive.extract(dirPath, List<ZipEntry>{}, 4);
+
+            long fileCount = 0;
+            for (const String &filePath: DirWalk{dirPath, DirWalk::FilesOnly}) {
+                ZipEntry entry;
+                CC_VERIFY(archive.lookup(filePath.copy(dirPath.count() + 1, filePath.count()), &entry));
+                CC_CHECK(File{filePath}.readAll() == asText(archive.load(entry)));
+                ++fileCount;
+            }
+            CC_CHECK(fileCount == 20);
+
+            Dir::deplete(dirPath);
+            Dir::remove(dirPath);
+
+            const String subsetPath = path + "_subset";
+            Dir::establish(subsetPath);
+            ZipEntry entry;
+            CC_VERIFY(archive.lookup("docs/part1/file7.txt", &entry));
+            archive.extract(subsetPath, List<ZipEntry>{entry});
+            CC_CHECK(File{subsetPath / "docs/part1/file7.txt"}.readAll() == text.copy(0, 7000));
+            CC_CHECK(!File::exists(subsetPath / "docs/part0/file0.txt"));
+
+            Dir::deplete(subsetPath);
+            Dir::remove(subsetPath);
+            File::unlink(path);
+        }
+    };
+
+    TestCase {
+        "PathTraversal",
+        []{
+            for (const String &name: List<String>{"../evil.txt", "good/../../evil.txt", "/tmp/evil.txt"}) {
+                const String path =
+                    ZipBuilder{}
+                    .add(ZipItem{"harmless.txt", "harmless"})
+                    .add(ZipItem{name, "evil"})
+                    .save();
+
+                const String dirPath = path + "_out";
+            Dir::establish(dirPath);
+                ZipArchive archive{path};
+                bool failed = false;
+                try { archive.extract(dirPath); }
+                catch (ZipArchive::FormatError &error) {
+                    CC_INSPECT(error.message());
+                    failed = true;
+                }
+                CC_CHECK(failed);
+                CC_CHECK(!File::exists(dirPath / "harmless.txt"));
+                CC_CHECK(!File::exists(dirPath.cdUp() / "evil.txt"));
+
+                Dir::deplete(dirPath);
+                Dir::remove(dirPath);
+                File::unlink(path);
+            }
+        }
+    };
+
+    return TestSuite{argc, argv}.run();
+}
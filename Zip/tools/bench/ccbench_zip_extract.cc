@@ -0,0 +1,92 @@
+#include <cc/ZipArchive>
+#include <cc/ZipFile>
+#include <cc/ZipStream>
+#include <cc/Random>
+#include <cc/System>
+#include <cc/File>
+#include <cc/Dir>
+#include <cc/stdio>
+#include <zip.h>
+
+using namespace cc;
+
+/** Generate a ZIP archive of \a count compressible files of \a size bytes each
+  */
+String generateArchive(long count, long size)
+{
+    String path = File::createTemp();
+    int errorCode = 0;
+    zip_t *archive = zip_open(path, ZIP_CREATE|ZIP_TRUNCATE, &errorCode);
+    if (!archive) throw ZipError{errorCode, path};
+
+    Random random{0};
+    List<Bytes> contents;
+    for (long i = 0; i < count; ++i) {
+        Bytes data = Bytes::allocate(size);
+        for (long j = 0; j < size; ++j) data[j] = 'a' + random.get(0, 7);
+        contents.append(data);
+        zip_source_t *source = zip_source_buffer(archive, data.items(), data.count(), 0);
+        String name = Format{"assets/%%/file%%.dat"} << i % 16 << i;
+        if (zip_file_add(archive, name, source, ZIP_FL_ENC_UTF_8) < 0) {
+            zip_source_free(source);
+            throw ZipError{zip_get_error(archive)->zip_err, path};
+        }
+    }
+    if (zip_close(archive) < 0) throw ZipError{zip_get_error(archive)->zip_err, path};
+
+    return path;
+}
+
+double extractLibzip(const String &zipPath, const String &dirPath)
+{
+    double t = System::now();
+    ZipFile archive{zipPath};
+    for (const String &name: archive) {
+        if (name.endsWith('/')) continue;
+        String path = dirPath / name;
+        Dir::establish(path.cdUp());
+        archive.open(name).transferTo(File{path, FileOpen::Overwrite});
+    }
+    return System::now() - t;
+}
+
+double extractNative(const String &zipPath, const String &dirPath, int concurrency)
+{
+    double t = System::now();
+    ZipArchive{zipPath}.extract(dirPath, List<ZipEntry>{}, concurrency);
+    return System::now() - t;
+}
+
+int main(int argc, char *argv[])
+{
+    String zipPath = argc > 1 ? String{argv[1]} : String{};
+    bool generated = zipPath == "";
+    if (generated) zipPath = generateArchive(512, 256 * 1024);
+
+    fout("archive:\t%% (%% bytes)\n") << zipPath << File{zipPath}.map().count();
+
+    {
+        double t = System::now();
+        ZipArchive archive{zipPath};
+        long n = 0;
+        for (const ZipEntry &entry: archive) n += archive.lookup(entry.name());
+        t = System::now() - t;
+        fout("native index+lookup:\t%% ms (%% entries)\n") << t * 1000 << n;
+    }
+
+    String dirPath = Dir::createTemp();
+    fout("libzip:\t%% ms\n") << extractLibzip(zipPath, dirPath) * 1000;
+    Dir::deplete(dirPath);
+    Dir::remove(dirPath);
+
+    for (int concurrency: { 1, 2, 4, System::concurrency() }) {
+        dirPath = Dir::createTemp();
+        fout("native -j=%%:\t%% ms\n") << concurrency << extractNative(zipPath, dirPath, concurrency) * 1000;
+        Dir::deplete(dirPath);
+        Dir::remove(dirPath);
+    }
+
+    if (generated) File::unlink(zipPath);
+
+    return 0;
+}
@@ -1,16 +1,60 @@
-#include <cc/ZipFile>
+#include <cc/ZipArchive>
+#include <cc/Arguments>
+#include <cc/Format>
 #include <cc/stdio>
 
 int main(int argc, char *argv[])
 {
     using namespace cc;
 
-    if (argc != 3) {
-        fout() << "Usage: " << String{argv[0]}.baseName() << " <ZIP ARCHIVE> <file name>" << nl;
+    String toolName = String{argv[0]}.baseName();
+
+    try {
+        Map<String, Variant> options;
+        options.insert("j", 0);
+        options.insert("d", "");
+
+        List<String> items = Arguments{argc, argv}.read(&options);
+        if (items.count() == 0) throw HelpRequest{};
+
+        ZipArchive archive{items.at(0)};
+        items.removeAt(0);
+
+        String dirPath = options.value("d").to<String>();
+
+        if (items.count() == 1 && dirPath == "") {
+            archive.open(items.at(0)).transferTo(stdOutput());
+        }
+        else {
+            List<ZipEntry> entries;
+            for (const String &name: items) {
+                ZipEntry entry;
+                if (!archive.lookup(name, &entry)) {
+                    throw UsageError{Format{"No such file in %%: %%"} << archive.path() << name};
+                }
+                entries.append(entry);
+            }
+            if (dirPath == "") dirPath = ".";
+            archive.extract(dirPath, entries, static_cast<int>(options.value("j").to<long>()));
+        }
+    }
+    catch (HelpRequest &) {
+        fout(
+            "Usage: %% [OPTION]... <ZIP ARCHIVE> [FILE]...\n"
+            "Extract files from a ZIP archive.\n"
+            "\n"
+            "A single FILE is written to standard output, unless a target directory is given.\n"
+            "Otherwise the FILEs (or all files if none are given) are extracted into the target directory.\n"
+            "\n"
+            "Options:\n"
+            "  -j=<n>    inflate up to n files in parallel (default: number of CPU cores)\n"
+            "  -d=<dir>  target directory (default: current directory)\n"
+        ) << toolName;
+    }
+    catch (Exception &ex) {
+        ferr() << toolName << ": " << ex << nl;
         return 1;
     }
 
-    ZipFile{argv[1]}.open(argv[2]).transferTo(stdOutput());
-
     return 0;
 }
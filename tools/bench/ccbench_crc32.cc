@@ -0,0 +1,79 @@
+#include <cc/Crc32Sink>
+#include <cc/CrcDispatch>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <cc/str>
+#include <cmath>
+
+using namespace cc;
+
+double benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+std::uint32_t crc32Bytewise(const Bytes &data)
+{
+    std::uint32_t table[256];
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0xEDB88320U : c >> 1;
+        table[i] = c;
+    }
+    std::uint32_t crc = Crc32Sink::DefaultSeed;
+    for (long i = 0; i < data.count(); ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+void report(const char *name, long size, double dt, std::uint32_t sum)
+{
+    fout() << name << "\t" << std::round(size / dt / 1e6) << " MB/s\t(0x" << hex(sum, 8) << ")" << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    const long size = 64 << 20;
+    const long chunkSize = 1 << 20;
+
+    Bytes data = Bytes::allocate(size);
+    Random random { 0 };
+    for (long i = 0; i < size; ++i) data[i] = random.get(0, 255);
+
+    std::uint32_t sum = 0;
+    double dt = 0;
+
+    dt = benchmark([&]{ sum = crc32Bytewise(data); });
+    report("bytewise", size, dt, sum);
+
+    const bool pclmul = crc::usePclmul;
+
+    crc::usePclmul = false;
+    dt = benchmark([&]{ sum = crc32(data); });
+    report("slicing-by-8", size, dt, sum);
+
+    crc::usePclmul = pclmul;
+    if (pclmul) {
+        dt = benchmark([&]{ sum = crc32(data); });
+        report("pclmul", size, dt, sum);
+    }
+
+    dt = benchmark([&]{
+        sum = crc32(data.items(), chunkSize);
+        for (long i = chunkSize; i < size; i += chunkSize) {
+            sum = crc32Combine(sum, crc32(data.items() + i, chunkSize), chunkSize);
+        }
+    });
+    report("chunked+combine", size, dt, sum);
+
+    return 0;
+}
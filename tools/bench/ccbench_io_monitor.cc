@@ -0,0 +1,88 @@
+#include <cc/IoMonitor>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <array>
+#include <sys/resource.h>
+
+using namespace cc;
+
+int64_t benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return static_cast<int64_t>(std::round(dt_min * 1e6));
+}
+
+const char *backendName(IoMonitorBackend backend)
+{
+    return (backend == IoMonitorBackend::Poll) ? "poll" : "epoll";
+}
+
+int main(int argc, char *argv[])
+{
+    std::array<int, 3> counts { 10, 1000, 10000 };
+    const int wakeups = 10000;
+    const int churns = 1000;
+
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    for (IoMonitorBackend backend: { IoMonitorBackend::Poll, IoMonitorBackend::Epoll }) {
+        for (int n: counts) {
+            if (limit.rlim_cur < static_cast<rlim_t>(2 * n + 16)) {
+                n = (limit.rlim_cur - 16) / 2;
+                ferr() << "Reducing the number of watched sockets to " << n << " (file descriptor limit is " << limit.rlim_cur << ")" << nl;
+            }
+
+            auto watched = Array<IoStream>::allocate(n);
+            auto peers = Array<IoStream>::allocate(n);
+            for (int i = 0; i < n; ++i) {
+                IoStream::pair(&watched[i], &peers[i]);
+            }
+
+            IoMonitor monitor{backend};
+            for (const IoStream &stream: watched) {
+                monitor.watch(stream, IoEvent::ReadyRead);
+            }
+
+            Random random { 0 };
+            String ping { "x" };
+            Bytes buffer = Bytes::allocate(1);
+
+            int64_t dt = benchmark([&]{
+                for (int k = 0; k < wakeups; ++k) {
+                    peers[random.get(0, n - 1)].write(ping);
+                    monitor.wait([&](const IoActivity &activity){
+                        activity.target().read(&buffer);
+                    });
+                }
+            });
+
+            fout() << backendName(backend) << "\t" << n << "\twatched sockets\t" << wakeups << " wakeups cost\t" << dt << " us\n";
+
+            dt = benchmark([&]{
+                for (int k = 0; k < churns; ++k) {
+                    const IoStream &stream = watched[random.get(0, n - 1)];
+                    monitor.unwatch(stream);
+                    monitor.watch(stream, IoEvent::ReadyRead);
+                    peers[0].write(ping);
+                    monitor.wait([&](const IoActivity &activity){
+                        activity.target().read(&buffer);
+                    });
+                }
+            });
+
+            fout() << backendName(backend) << "\t" << n << "\twatched sockets\t" << churns << " unwatch/watch/wakeup cycles cost\t" << dt << " us\n";
+        }
+    }
+
+    return 0;
+}
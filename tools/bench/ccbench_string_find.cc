@@ -0,0 +1,89 @@
+#include <cc/String>
+#include <cc/SearchDispatch>
+#include <cc/System>
+#include <cc/Random>
+#include <cc/stdio>
+#include <cmath>
+#include <string>
+
+using namespace cc;
+
+double benchmark(std::function<void()> &&run)
+{
+    double dt_min = 0;
+    for (int i = 0; i < 3; ++i) {
+        double dt = System::now();
+        run();
+        dt = System::now() - dt;
+        if (dt < dt_min || dt_min <= 0) dt_min = dt;
+    }
+    return dt_min;
+}
+
+long countBytewise(const String &text, const String &needle)
+{
+    const char *a = text.chars();
+    const char *b = needle.chars();
+    const long n = text.count();
+    const long m = needle.count();
+    long o = 0;
+    for (long i = 0; i + m <= n;) {
+        long k = 0;
+        while (k < m && a[i + k] == b[k]) ++k;
+        if (k == m) { ++o; i += m; }
+        else ++i;
+    }
+    return o;
+}
+
+void report(const char *name, const String &needle, long size, double dt, long o)
+{
+    fout() << name << "\t" << needle.count() << " chars\t" << std::round(size / dt / 1e6) << " MB/s\t(" << o << " matches)" << nl;
+}
+
+int main(int argc, char *argv[])
+{
+    const long size = 16 << 20;
+
+    String text = String::allocate(size);
+    Random random { 0 };
+    for (long i = 0; i < size; ++i) {
+        text[i] = (random.get(0, 9) == 0) ? ' ' : 'a' + random.get(0, 25);
+    }
+
+    const bool avx2 = search::useAvx2;
+
+    for (String needle: { String{"ERR"}, String{"connection reset"}, String{"x-forwarded-for: 10.0.0.1, upstream timed out"} }) {
+        for (long i = 0; i + needle.count() <= size; i += size / 16) {
+            text = text.paste(i, i + needle.count(), needle);
+        }
+
+        long o = 0;
+        double dt = benchmark([&]{ o = countBytewise(text, needle); });
+        report("bytewise", needle, size, dt, o);
+
+        std::string stdText{text.chars(), static_cast<size_t>(size)};
+        std::string stdNeedle{needle.chars(), static_cast<size_t>(needle.count())};
+        dt = benchmark([&]{
+            o = 0;
+            for (size_t i = 0; (i = stdText.find(stdNeedle, i)) != std::string::npos; i += stdNeedle.size()) ++o;
+        });
+        report("std::string", needle, size, dt, o);
+
+        search::useAvx2 = false;
+        dt = benchmark([&]{ o = text.count(needle); });
+        report("sse2", needle, size, dt, o);
+
+        search::useAvx2 = avx2;
+        if (avx2) {
+            dt = benchmark([&]{ o = text.count(needle); });
+            report("avx2", needle, size, dt, o);
+        }
+
+        String replaced;
+        dt = benchmark([&]{ replaced = text.replaced(needle, "<match>"); });
+        report("replace", needle, size, dt, o);
+    }
+
+    return 0;
+}